@@ -35,54 +35,47 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ///////////////////////////////////////////////////////////////////////////////
 // GlyphCache Texture Mechanism
 //
-// A cache texture is divided into a number of predefined vertical bins (columns).
-// Also, there is an open area on the right side of the texture which handles
-// overflow from the columns on the left side. The left-most columns are 
-// narrow and handle thin glyphs such as the ones shown below. As we move
-// rightward, successive columns are wider. Glyphs are added to each column
-// until the column runs out of space, at which point the glyph is tried in 
-// the next column, and so on.
+// A cache texture is divided into horizontal shelves, which are created from
+// the top of the texture downward as they are needed. Each shelf has a fixed
+// height and glyphs are added to it from left to right. A glyph goes into the
+// existing shelf whose height fits it best, or into a new shelf if no existing
+// shelf is a close fit.
 //
-// Each column is on a four pixel x boundary. And each character vertically
-// within a column begins on a four pixel y boundary. There is at least one
+// Each glyph begins on a four pixel x and y boundary. There is at least one
 // blank pixel between each glyph. This is done because some texture sampling
 // will read outside of the glyph, and we don't want to read pixels from 
 // other glyphs.
-// 
+//
+// Each shelf remembers when any of its glyphs was last used. When all textures
+// are full, the least recently used shelf is evicted and its space is reused.
+//
 // ------------------------------------------------------------------
-// | i  |   b   |   W   |       | D3TPZ+?M                          |
-// | l  |   c   |   X   |       |                                   |
-// | .  |   e   |   Q   |       |                                   |
-// | :  |   d   |   H   |       |                                   |
-// | ;  |   r   |       |       |           (open area)             |
-// | ,  |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
+// | a c e m n o r s u v w x z                                      |
+// |----------------------------------------------------------------|
+// | b d f h k l t A B C D E F G H I J K L M N O P                  |
+// |----------------------------------------------------------------|
+// | g j p q y                                                      |
+// |----------------------------------------------------------------|
+// | . , : ; - ' "                                                  |
+// |----------------------------------------------------------------|
+// |                                                                |
+// |                                                                |
+// |                       (unshelved area)                         |
+// |                                                                |
+// |                                                                |
 // ------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////
 
 
+
 #ifndef EATEXT_EATEXTCACHE_H
 #define EATEXT_EATEXTCACHE_H
 
 
 #include <EAText/EAText.h>
+#include <EAText/EATextFont.h>
 #include <EASTL/hash_map.h>
+#include <EASTL/vector.h>
 #include <EASTL/fixed_vector.h>
 #include <EASTL/core_allocator_adapter.h>
 #include <coreallocator/icoreallocator_interface.h>
@@ -113,7 +106,8 @@ namespace EA
         // Defaults
         const int  kTextureSlotCount         = EA_TEXT_CACHE_TEXTURE_SLOT_COUNT;
         const int  kTextureSizeDefault       = EA_TEXT_CACHE_TEXTURE_SIZE;
-        const int  kTextureColumnCountMax    = EA_TEXT_CACHE_TEXTURE_COLUMN_COUNT_MAX;
+        const int  kTextureShelfCountMax     = EA_TEXT_CACHE_TEXTURE_SHELF_COUNT_MAX;
+        const int  kSubpixelPhaseCount       = EA_TEXT_CACHE_SUBPIXEL_PHASE_COUNT;
         const bool kTextureAutoCreateDefault = false;
 
 
@@ -133,6 +127,19 @@ namespace EA
         };
 
 
+        /// TextureShelf
+        /// A horizontal strip of a texture which glyphs are packed into from left to right.
+        /// Shelves are evicted as a whole, so their space can be reused once they become
+        /// the least recently used shelf.
+        struct TextureShelf
+        {
+            uint16_t mnY;               /// Top of the shelf, in pixels.
+            uint16_t mnHeight;          /// Height of the shelf, in pixels. Fixed when the shelf is created.
+            uint16_t mnX;               /// Left side of the shelf's remaining space, in pixels.
+            uint32_t mnLastUsed;        /// GlyphCache use stamp of the last time any glyph on this shelf was added or looked up.
+        };
+
+
         /// TextureInfo
         /// Stores information about a given texture's space for new glyphs.
         struct TextureInfo
@@ -148,12 +155,9 @@ namespace EA
             uint32_t            mFormat;                                    /// Texture format plus color depth. One of enum TextureFormat unless the user is using private extended values.
             uint32_t            mnSize;                                     /// Size of the texture, which is 2D and of even powers of two in both dimensions.
             uint32_t            mnGeneration;                               /// Used to tell if any references to data in this texture are stale. The texture may be purged if it runs out of room.
-            uint32_t            mnColumnHeights[kTextureColumnCountMax];    /// 
-            uint32_t            mnOpenAreaX;                                /// 
-            uint32_t            mnOpenAreaY;                                /// 
-            uint32_t            mnOpenAreaLineH;                            /// 
-            uint8_t             mnColumnCount;                              /// 
-            uint8_t             mnColumnWidths[kTextureColumnCountMax];     /// 
+            TextureShelf        mShelfArray[kTextureShelfCountMax];         /// Shelves in increasing order of mnY.
+            uint32_t            mnShelfCount;                               /// Number of valid entries in mShelfArray.
+            uint32_t            mnShelfAreaY;                               /// Top of the space below the last shelf, from which new shelves are made.
             bool                mbWritable;                                 /// If true, this texture can be written to. If false, it is read-only.
 
             #if EATEXT_THREAD_SAFETY_ENABLED
@@ -239,8 +243,8 @@ namespace EA
                 kOptionAutoTextureCreate    =   2,    /// If enabled, we auto-create new textures when we run out of space. Default is false.
                 kOptionDoubleBuffer         =   3,    /// If enabled, then textures are double-buffered, which means that textures are in pairs: one used by the hardware and one used to update glyphs. This uses more memory but reduces texture contention. Default is disabled.
                 kOptionGlyphPadding         =   4,    /// Value >= 0; default is 1. Specifies the amount of empty space around glyphs. A value of 1 means that there is 1 empty pixel on all four sides of glyphs. It is useful to have extra space around glyphs when implementing shadow multi-sampling.
-                kOptionColumnCount          =  99,    /// Must be set before using this class.
-                kOptionColumnValueBase      = 100     /// Must be set before using this class.
+                kOptionColumnCount          =  99,    /// Deprecated and ignored. Textures are now packed in shelves instead of columns.
+                kOptionColumnValueBase      = 100     /// Deprecated and ignored.
             };
 
             /// SetOption
@@ -250,10 +254,14 @@ namespace EA
 
             /// GetGlyphTextureInfo
             ///
+            /// nSubpixelPhase selects the variant of the glyph that was rendered at a
+            /// horizontal pen offset of (nSubpixelPhase / kSubpixelPhaseCount) pixels.
+            /// Phase 0 is the regular, pixel-aligned glyph.
+            ///
             /// This function generally doesn't need to be subclassed.
             ///
             EATEXT_VIRTUAL bool GetGlyphTextureInfo(Font* pFont, GlyphId glyphId, 
-                                        GlyphTextureInfo& glyphTextureInfo) const;
+                                        GlyphTextureInfo& glyphTextureInfo, uint32_t nSubpixelPhase = 0) const;
 
 
             /// SetGlyphTextureInfo
@@ -291,10 +299,13 @@ namespace EA
             ///
             /// This function is misnamed, it should be called AddGlyph instead of AddGlyphTexture.
             ///
+            /// nSubpixelPhase identifies a glyph variant rendered at a fractional pen offset;
+            /// see GetGlyphTextureInfo. Variants are evicted along with their shelf like any other glyph.
+            ///
             EATEXT_VIRTUAL bool AddGlyphTexture(Font* pFont, GlyphId glyphId, 
                                                 const void* pSourceData, uint32_t nSourceSizeX, uint32_t nSourceSizeY, 
                                                 uint32_t nSourceStride, uint32_t nSourceFormat,
-                                                EA::Text::GlyphTextureInfo& glyphTextureInfo);
+                                                EA::Text::GlyphTextureInfo& glyphTextureInfo, uint32_t nSubpixelPhase = 0);
 
             /// CreateTexture
             ///
@@ -371,11 +382,22 @@ namespace EA
             /// 
             EATEXT_VIRTUAL void ClearTextureImage(void* pDest, uint32_t nDestSize, uint32_t nDestStride, uint32_t nDestFormat);
 
+            /// ClearTextureImage
+            ///
+            /// Clears a nDestWidth by nDestHeight texel area of the given texture's image.
+            /// This is used to clear a single shelf when its glyphs are evicted.
+            ///
+            /// This function generally doesn't need to be subclassed.
+            /// 
+            EATEXT_VIRTUAL void ClearTextureImage(void* pDest, uint32_t nDestWidth, uint32_t nDestHeight, uint32_t nDestStride, uint32_t nDestFormat);
+
 
             /// AllocateTextureArea
             ///
             /// Finds space for a glyph of the given size. This may result in creating new 
-            /// textures or clearing an existing texture, depending on our settings and state.
+            /// textures or evicting the least recently used glyphs, depending on our settings 
+            /// and state. If glyphs are evicted, their texture is left locked as if by 
+            /// BeginUpdate and the caller is responsible for calling EndUpdate.
             ///
             /// This function generally doesn't need to be subclassed. It would only need to 
             /// be subclassed when the texture encoding is a format that is unique.
@@ -439,6 +461,12 @@ namespace EA
             /// The return value is the required size of the glyph data. If the input size is not large enough
             /// then no data is written.
             ///
+            /// The data holds the image of each writable texture along with the placement and metrics
+            /// of the glyphs on it. Fonts are identified by a hash of their file and a hash of their
+            /// FontDescription (which includes the size), so the data can be used by a later run which 
+            /// creates the same fonts. Values, including 32 bit texels, are always stored little-endian,
+            /// so the data is portable regardless of bPortable.
+            ///
             /// This function generally doesn't need to be subclassed.
             /// 
             EATEXT_VIRTUAL uint32_t GetGlyphTextureData(void* pGlyphData, uint32_t nGlyphDataSize, bool bPortable = true);
@@ -450,41 +478,94 @@ namespace EA
             /// on application startup. The format of the data is internal and the data itself is generated
             /// by calls to GetGlyphTextureData. Any existing data is replaced.
             ///
+            /// Textures are created as needed, up to the max texture count given to Init. The loaded 
+            /// glyphs are attached to Fonts by AdoptPendingGlyphs, so this should be called before 
+            /// the Fonts are created. Returns false if the data is malformed or was written by an 
+            /// incompatible version.
+            ///
             /// This function generally doesn't need to be subclassed.
             /// 
             EATEXT_VIRTUAL bool SetGlyphTextureData(const void* pGlyphData, uint32_t nGlyphDataSize);
 
+            /// AdoptPendingGlyphs
+            ///
+            /// Attaches the glyphs read by SetGlyphTextureData whose font file and description 
+            /// match the given Font, and seeds the Font's glyph metrics with the saved ones. After 
+            /// that, the Font neither renders those glyphs nor measures them again. The FontServer 
+            /// calls this for each Font it creates or is given, while its default GlyphCache is 
+            /// this one. Fonts made elsewhere should be passed here once their size and style are set.
+            /// Returns true if any glyphs were attached.
+            ///
+            bool AdoptPendingGlyphs(Font* pFont);
+
         protected:
             struct GlyphInfo
             {
-                Font*   mpFont;     // Usually 32 bits.
-                GlyphId mGlyphId;   // Usually 16 bits.
+                Font*    mpFont;            // Usually 32 bits.
+                GlyphId  mGlyphId;          // Usually 16 bits.
+                uint16_t mnSubpixelPhase;   // In the range of [0, kSubpixelPhaseCount).
 
-                GlyphInfo(Font* pFont = NULL, GlyphId glyphId = 0)
-                    : mpFont(pFont), mGlyphId(glyphId) { }
+                GlyphInfo(Font* pFont = NULL, GlyphId glyphId = 0, uint32_t nSubpixelPhase = 0)
+                    : mpFont(pFont), mGlyphId(glyphId), mnSubpixelPhase((uint16_t)nSubpixelPhase) { }
 
                 bool operator==(const GlyphInfo& gi) const
-                    { return (mpFont == gi.mpFont) && (mGlyphId == gi.mGlyphId); }
+                    { return (mpFont == gi.mpFont) && (mGlyphId == gi.mGlyphId) && (mnSubpixelPhase == gi.mnSubpixelPhase); }
             };
 
             struct GlyphInfoHash
             {
                 uint32_t operator()(const GlyphInfo& gi) const 
-                    { return (uint32_t)((uintptr_t(gi.mpFont) << 16) + gi.mGlyphId); }
+                    { return (uint32_t)((uintptr_t(gi.mpFont) << 16) + gi.mGlyphId + (gi.mnSubpixelPhase * 0x9e3779b1u)); }
+            };
+
+            /// GlyphEntry
+            /// The cached location of a glyph, along with the shelf it was packed into.
+            /// Glyphs set via SetGlyphTextureInfo don't belong to any shelf.
+            struct GlyphEntry
+            {
+                GlyphTextureInfo mGlyphTextureInfo;
+                uint32_t         mnShelfIndex;
+            };
+
+            static const uint32_t kShelfIndexNone = 0xffffffff;
+
+            /// FontKey
+            /// Identifies a font across application runs, for glyph data saved by GetGlyphTextureData.
+            struct FontKey
+            {
+                uint32_t mnFileHash;
+                uint32_t mnDescriptionHash;
+
+                bool operator==(const FontKey& fk) const
+                    { return (mnFileHash == fk.mnFileHash) && (mnDescriptionHash == fk.mnDescriptionHash); }
             };
 
+            /// PendingGlyph
+            /// A glyph read by SetGlyphTextureData which hasn't been attached to a Font yet.
+            struct PendingGlyph
+            {
+                uint32_t     mnFontIndex;       /// Index into mPendingFontKeyArray.
+                GlyphId      mGlyphId;
+                uint32_t     mnSubpixelPhase;
+                GlyphEntry   mGlyphEntry;
+                GlyphMetrics mGlyphMetrics;
+            };
+
+            typedef eastl::vector<FontKey, EA::Allocator::EASTLICoreAllocator>      FontKeyArray;
+            typedef eastl::vector<PendingGlyph, EA::Allocator::EASTLICoreAllocator> PendingGlyphArray;
+
             /// TextureInfoArray
             /// Entries are AddRefd.
             typedef eastl::fixed_vector<TextureInfo*, kTextureSlotCount, true> TextureInfoArray;
 
             /// GlyphTextureMap
-            /// Map of all Glyph/Font to GlyphTextureInfo.
-            typedef eastl::hash_map<GlyphInfo, GlyphTextureInfo, GlyphInfoHash, 
+            /// Map of all Glyph/Font to GlyphEntry.
+            typedef eastl::hash_map<GlyphInfo, GlyphEntry, GlyphInfoHash, 
                                     eastl::equal_to<GlyphInfo>, EA::Allocator::EASTLICoreAllocator> GlyphTextureMap;
 
         protected:
             #ifdef EA_DEBUG
-                bool ValidateGlyphTextureMap(Font* pFont = NULL, GlyphId glyphId = kGlyphIdInvalid) const;
+                bool ValidateGlyphTextureMap(Font* pFont = NULL, GlyphId glyphId = kGlyphIdInvalid, uint32_t nSubpixelPhase = 0) const;
                 void EnableAutoTextureWrite(const char* pDirectory, bool bEnabled);
                 bool WritePPMFile(const char* pPath, uint32_t pixelFormat, const void* pData, uint32_t width, 
                                     uint32_t height, uint32_t strideBytes, bool bAlphaOnly = true, uint32_t backgroundColorRGB = 0xffffffff);
@@ -499,6 +580,32 @@ namespace EA
             EATEXT_VIRTUAL bool TryAllocateTextureArea(uint32_t xSize, uint32_t ySize, 
                                         TextureInfo& textureInfo, uint32_t& xPosition, uint32_t& yPosition);
 
+            /// EvictTextureShelf
+            ///
+            /// Removes all glyphs on the given shelf from the cache and clears the shelf's 
+            /// image so that its space can be reused. The texture is locked if it isn't already.
+            ///
+            EATEXT_VIRTUAL void EvictTextureShelf(TextureInfo* pTextureInfo, uint32_t nShelfIndex);
+
+            /// TouchTextureShelf
+            ///
+            /// Marks the given shelf as just used.
+            ///
+            void TouchTextureShelf(TextureInfo* pTextureInfo, uint32_t nShelfIndex) const;
+
+            /// GetFontKey
+            ///
+            /// Calculates the FontKey of the given Font. This reads the start of the Font's stream.
+            ///
+            static void GetFontKey(Font* pFont, FontKey& fontKey);
+
+            /// RemovePendingGlyphs
+            ///
+            /// Removes the pending glyphs on the given shelf, or on the entire texture
+            /// if nShelfIndex is kShelfIndexNone.
+            ///
+            void RemovePendingGlyphs(const TextureInfo* pTextureInfo, uint32_t nShelfIndex);
+
             /// ClearTextureInternal
             ///
             /// Clears the texture associated with TextureInfo. The caller of this
@@ -523,8 +630,9 @@ namespace EA
             uint32_t                   mnTextureInfoCountMax;                          /// Max count of textures to maintain. Defaults to 1.
             uint32_t                   mnTextureSizeDefault;                           /// Default size of textures.
             uint32_t                   mnTextureFormatDefault;                         /// One of enum TextureFormat. Defaults to kTextureFormatNone (back-end decides the best format).
-            uint32_t                   mnColumnCountDefault;                           ///
-            uint32_t                   mnColumnWidthsDefault[kTextureColumnCountMax];  /// 
+            mutable uint32_t           mnUseStamp;                                     /// Incremented on each glyph use and recorded in TextureShelf::mnLastUsed.
+            FontKeyArray               mPendingFontKeyArray;                           /// Fonts of the glyphs read by SetGlyphTextureData.
+            PendingGlyphArray          mPendingGlyphArray;                             /// Glyphs read by SetGlyphTextureData which haven't been attached to a Font yet.
             bool                       mbAutoTextureCreate;                            /// If true, we auto-create new textures when we run out of space. Defaults to false.
             bool                       mbDoubleBuffer;                                 /// If true, dynamically written textures are double-buffered.
             int32_t                    mnGlyphPadding;                                 /// Specifies extra space around glyphs in the glyph texture. A value of 1 means that there is 1 empty pixel on all four sides of glyphs.
@@ -355,6 +355,20 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 
+///////////////////////////////////////////////////////////////////////////////
+// EATEXT_FONT_LOOKUP_CACHE_SIZE
+//
+// Defined as an integer >= 0. Default is the value assigned below.
+// Specifies the number of FontServer::GetFont results that are remembered, 
+// so that repeated requests for the same style and character class don't 
+// need to re-score every face. A value of 0 disables the cache.
+//
+#ifndef EATEXT_FONT_LOOKUP_CACHE_SIZE
+    #define EATEXT_FONT_LOOKUP_CACHE_SIZE 32
+#endif
+
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // EA_TEXT_CACHE_TEXTURE_SIZE
 //
@@ -369,14 +383,30 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 ///////////////////////////////////////////////////////////////////////////////
-// EA_TEXT_CACHE_TEXTURE_COLUMN_COUNT_MAX
+// EA_TEXT_CACHE_TEXTURE_SHELF_COUNT_MAX
+//
+// Defined as a value >= 1.
+// Specifies how many shelves (horizontal rows of glyphs) a glyph cache texture
+// can be divided into. Shelves are at least four pixels high, so a value of
+// (texture size / 8) is usually more than enough.
+//
+#ifndef EA_TEXT_CACHE_TEXTURE_SHELF_COUNT_MAX
+    #define EA_TEXT_CACHE_TEXTURE_SHELF_COUNT_MAX 128
+#endif
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// EA_TEXT_CACHE_SUBPIXEL_PHASE_COUNT
 //
-// Defined as a value >= 8.
-// Specifies how many columns a glyph cache texture has. See the cache documentation
-// to better understand what this is about.
+// Defined as a value >= 1.
+// Specifies how many horizontal subpixel positions a glyph can be cached at.
+// Each glyph pen position is rounded to the nearest 1/N of a pixel, so a glyph
+// can occupy up to N entries in the cache. A value of 1 disables subpixel 
+// positioned glyphs.
 //
-#ifndef EA_TEXT_CACHE_TEXTURE_COLUMN_COUNT_MAX
-    #define EA_TEXT_CACHE_TEXTURE_COLUMN_COUNT_MAX 32
+#ifndef EA_TEXT_CACHE_SUBPIXEL_PHASE_COUNT
+    #define EA_TEXT_CACHE_SUBPIXEL_PHASE_COUNT 4
 #endif
 
 
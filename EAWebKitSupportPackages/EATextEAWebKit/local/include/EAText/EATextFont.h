@@ -413,6 +413,16 @@ namespace EA
             EATEXT_VIRTUAL bool GetGlyphMetrics(GlyphId glyphId, GlyphMetrics& glyphMetrics) = 0;
 
 
+            /// SetGlyphMetrics
+            ///
+            /// Supplies precalculated metrics for the given glyph, such as metrics saved along with
+            /// a GlyphCache, so that GetGlyphMetrics doesn't need to render the glyph to find them.
+            /// Metrics the font has already calculated are left as they are. Returns false if the 
+            /// font doesn't support this.
+            ///
+            EATEXT_VIRTUAL bool SetGlyphMetrics(GlyphId glyphId, const GlyphMetrics& glyphMetrics);
+
+
             /// GetGlyphIds
             ///
             /// Function to map code points to glyph indexes.
@@ -448,10 +448,29 @@ namespace EA
                 typedef eastl::fixed_hash_map<eastl::string16, eastl::string16, 4> FamilySubstitutionMap;
             #endif
 
+
+            #if EATEXT_FONT_LOOKUP_CACHE_SIZE
+                /// FontLookup
+                /// Remembers the result of a managed GetFont call. The key is the part of the
+                /// TextStyle that affects font selection plus a char/script class.
+                struct FontLookup
+                {
+                    uint32_t  mnHash;
+                    FontStyle mFontStyle;
+                    float     mfStretch;
+                    uint32_t  mnCharClass;
+                    Script    mScript;
+                    Font*     mpFont;       /// AddRef'd by the cache. NULL means the entry is unused.
+
+                    FontLookup() : mnHash(0), mFontStyle(), mfStretch(1.f), mnCharClass(0), mScript(kScriptUnknown), mpFont(NULL) { }
+                };
+            #endif
+
         protected: // Functions
             virtual Font* CreateNewFont(FaceSource* pFaceSource, const TextStyle& ssCSS, bool bManaged);
             virtual int   GetFontDescriptionScore(const FontDescription& fontDescription, const TextStyle& ssCSS);
             virtual bool  AddFaceSource(FaceSource& faceSource);
+            void          ClearFontLookupCache();
 
         protected: // Member data
             bool                       mbInitialized;
@@ -469,6 +488,10 @@ namespace EA
                 FamilySubstitutionMap mFamilySubstitutionMap;
             #endif
 
+            #if EATEXT_FONT_LOOKUP_CACHE_SIZE
+                FontLookup mFontLookupCache[EATEXT_FONT_LOOKUP_CACHE_SIZE];
+            #endif
+
             #if EATEXT_THREAD_SAFETY_ENABLED
                 EA::Thread::Futex mMutex;
             #endif
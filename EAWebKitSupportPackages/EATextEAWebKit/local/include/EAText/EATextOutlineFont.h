@@ -82,6 +82,14 @@ namespace EA
             int AddRef();
             int Release();
 
+            #if EATEXT_USE_FREETYPE
+                /// GetGlyphId
+                /// Maps a char to the face's glyph id, or 0 if the face has no glyph for it. 
+                /// Chars in the BMP are looked up in a cached table that is built from the face's 
+                /// charmap one 256 char page at a time, so all fonts of the face share it.
+                GlyphId GetGlyphId(uint32_t c);
+            #endif
+
         public:
             #if EATEXT_USE_FREETYPE
                 FT_Face       mFTFace;              // Represents the font Face (e.g. Arial bold), which can be drawn at multiple sizes.
@@ -98,6 +106,13 @@ namespace EA
 
             Allocator::ICoreAllocator* mpCoreAllocator;
 
+            #if EATEXT_USE_FREETYPE
+                static const uint32_t kGlyphIdPageSize  = 256;
+                static const uint32_t kGlyphIdPageCount = 0x10000 / kGlyphIdPageSize;
+
+                GlyphId* mpGlyphIdPageArray[kGlyphIdPageCount]; // Lazily built char -> glyph id tables for the BMP. NULL means not built yet.
+            #endif
+
             #if EATEXT_THREAD_SAFETY_ENABLED
                 EA::Thread::AtomicInt32 mRefCount;
             #else
@@ -165,6 +180,7 @@ namespace EA
             EATEXT_VIRTUAL bool         GetFontDescription(FontDescription& fontDescription);
             EATEXT_VIRTUAL bool         GetFontMetrics(FontMetrics& fontMetrics);
             EATEXT_VIRTUAL bool         GetGlyphMetrics(GlyphId glyphId, GlyphMetrics& glyphMetrics);
+            EATEXT_VIRTUAL bool         SetGlyphMetrics(GlyphId glyphId, const GlyphMetrics& glyphMetrics);
             EATEXT_VIRTUAL uint32_t     GetGlyphIds(const Char* pCharArray, uint32_t nCharArrayCount, GlyphId* pGlyphIdArray = NULL, 
                                                     bool bUseReplacementGlyph = true, const uint32_t nGlyphIdStride = sizeof(GlyphId), bool bWriteInvalidGlyphs = false);
             EATEXT_VIRTUAL uint32_t     GetGlyphIds(const char8_t* pCharArray, uint32_t nCharArrayCount, GlyphId* pGlyphIdArray = NULL, 
@@ -172,6 +188,14 @@ namespace EA
             EATEXT_VIRTUAL bool  IsCharSupported(Char c, Script script);
             EATEXT_VIRTUAL bool  GetKerning(GlyphId g1, GlyphId g2, Kerning& kerning, int direction, bool bHorizontalLayout = true);
             EATEXT_VIRTUAL float GetSize() const;
+
+            /// HasKerning
+            ///
+            /// Returns true if GetKerning can report kerning for this font. That is, the face has 
+            /// a kerning table and the font is not fixed pitch. The font must be opened.
+            ///
+            bool HasKerning() const;
+
             EATEXT_VIRTUAL bool  SetTransform(float f00, float f01, float f10, float f11);
             EATEXT_VIRTUAL bool  SetTransform(float fSize, float fAngle = 0.f, float fSkew = 0.f);
             EATEXT_VIRTUAL bool  RenderGlyphBitmap(const GlyphBitmap** pGlyphBitmap, GlyphId g, uint32_t renderFlags = kRFDefault, 
@@ -293,6 +317,8 @@ namespace EA
             bool                mbLCD;
             EffectsProcessor*   mpEffectsProcessor;
             FaceData*           mpFaceData;
+            uint8_t*            mpSubpixelBitmap;           // Holds glyphs rendered at a fractional x position; see RenderGlyphBitmap.
+            uint32_t            mnSubpixelBitmapCapacity;   // Size of mpSubpixelBitmap, in bytes.
 
             #if EATEXT_OPENTYPE_ENABLED
                 bool      mbOTFEnabled;     // If true then we read OTF information when opening the font.
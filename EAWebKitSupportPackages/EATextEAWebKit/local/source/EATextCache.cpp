@@ -37,6 +37,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <EAText/EATextCache.h>
 #include <EAText/EATextFont.h>
 #include <EAText/internal/EATextSquish.h>
+#include <EASTL/algorithm.h>
 #include <coreallocator/icoreallocatormacros.h>
 #include <stdio.h>
 #include EA_ASSERT_HEADER
@@ -64,19 +65,15 @@ TextureInfo::TextureInfo() :
     mFormat(0),
     mnSize(0),
     mnGeneration(0),
-  //mnColumnHeights[]
-    mnOpenAreaX(0),
-    mnOpenAreaY(0),
-    mnOpenAreaLineH(0),
-    mnColumnCount(0),
-  //mnColumnWidths[kTextureColumnCountMax];
+  //mShelfArray[]
+    mnShelfCount(0),
+    mnShelfAreaY(0),
     mbWritable(true),
     mRefCount(0),
     mpCoreAllocator(NULL)
 {
     memset(mLockInformation, 0, sizeof(mLockInformation));
-    memset(mnColumnHeights, 0, sizeof(mnColumnHeights));
-    memset(mnColumnWidths, 0, sizeof(mnColumnWidths));
+    memset(mShelfArray, 0, sizeof(mShelfArray));
 }
 
 TextureInfo::~TextureInfo()
@@ -109,6 +106,33 @@ int TextureInfo::Release()
 
 
 
+///////////////////////////////////////////////////////////////////////////////
+// FindTextureShelf
+//
+// Returns the index of the shelf which contains the given y position. 
+// Shelves are created top to bottom and so are sorted by mnY.
+//
+static uint32_t FindTextureShelf(const TextureInfo& ti, uint32_t y)
+{
+    uint32_t nLow  = 0;
+    uint32_t nHigh = ti.mnShelfCount;
+
+    while((nHigh - nLow) > 1)
+    {
+        const uint32_t nMid = (nLow + nHigh) / 2;
+
+        if(ti.mShelfArray[nMid].mnY <= y)
+            nLow = nMid;
+        else
+            nHigh = nMid;
+    }
+
+    EA_ASSERT((nLow < ti.mnShelfCount) && (y >= ti.mShelfArray[nLow].mnY) && (y < (uint32_t)(ti.mShelfArray[nLow].mnY + ti.mShelfArray[nLow].mnHeight)));
+    return nLow;
+}
+
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // GlyphCache
 ///////////////////////////////////////////////////////////////////////////////
@@ -122,25 +146,15 @@ GlyphCache::GlyphCache(Allocator::ICoreAllocator* pCoreAllocator)
     mnTextureInfoCountMax(kTextureSlotCount),
     mnTextureSizeDefault(kTextureSizeDefault),
     mnTextureFormatDefault(kTextureFormatDXT3),
-    mnColumnCountDefault(0), 
+    mnUseStamp(0),
+    mPendingFontKeyArray(EA::Allocator::EASTLICoreAllocator(EATEXT_ALLOC_PREFIX "PendingFontKeyArray", mpCoreAllocator)),
+    mPendingGlyphArray(EA::Allocator::EASTLICoreAllocator(EATEXT_ALLOC_PREFIX "PendingGlyphArray", mpCoreAllocator)),
     mbAutoTextureCreate(kTextureAutoCreateDefault),
     mbDoubleBuffer(false),
     mnGlyphPadding(1),
     mRecursionCounter(0),
     mnInitCount(0)
 {
-    // For some textures, such as DXT, we may want to make sure 
-    // the columns are on 4 pixel boundaries.
-    mnColumnWidthsDefault[0] =  4;
-    mnColumnWidthsDefault[1] =  8;
-    mnColumnWidthsDefault[2] = 12;
-    mnColumnWidthsDefault[3] = 12;
-    mnColumnWidthsDefault[4] = 16;
-    mnColumnWidthsDefault[5] = 16;
-    mnColumnWidthsDefault[6] = 20;
-    mnColumnWidthsDefault[7] = 20;
-    mnColumnCountDefault     =  8;
-
     #ifdef EA_DEBUG
         mbDebugBitmapEnable      = false;
         mDebugBitmapCounter      = 0;
@@ -172,6 +186,8 @@ void GlyphCache::SetAllocator(Allocator::ICoreAllocator* pCoreAllocator)
 {
     mpCoreAllocator = pCoreAllocator;
     mGlyphTextureMap.get_allocator().set_allocator(pCoreAllocator);
+    mPendingFontKeyArray.get_allocator().set_allocator(pCoreAllocator);
+    mPendingGlyphArray.get_allocator().set_allocator(pCoreAllocator);
 }
 
 
@@ -202,6 +218,8 @@ int GlyphCache::Shutdown()
     if(result == 0) // If this is the last Shutdown...
     {
         mGlyphTextureMap.clear();
+        mPendingFontKeyArray.clear();
+        mPendingGlyphArray.clear();
 
         for(eastl_size_t i = 0; i < mTextureInfoArray.size(); i++)
         {
@@ -249,32 +267,31 @@ void GlyphCache::SetOption(int32_t option, int32_t value)
         case kOptionGlyphPadding:
             mnGlyphPadding = eastl::max_alt<int32_t>(0, value);
             return;
-
-        case kOptionColumnCount:
-            mnColumnCountDefault = (uint32_t)value;
-            return;
     }
 
-    if((option >= kOptionColumnValueBase) && (option < (kOptionColumnValueBase + 100)))
-        mnColumnWidthsDefault[option - kOptionColumnValueBase] = (uint32_t)value;
+    // kOptionColumnCount and kOptionColumnValueBase are ignored; textures are packed in shelves.
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 // GetGlyphTextureInfo
 //
-bool GlyphCache::GetGlyphTextureInfo(Font* pFont, GlyphId glyphId, GlyphTextureInfo& glyphTextureInfo) const
+bool GlyphCache::GetGlyphTextureInfo(Font* pFont, GlyphId glyphId, GlyphTextureInfo& glyphTextureInfo, uint32_t nSubpixelPhase) const
 {
     #if EATEXT_THREAD_SAFETY_ENABLED
         EA::Thread::AutoFutex autoMutex(mMutex);
     #endif
 
-    const GlyphTextureMap::const_iterator it = mGlyphTextureMap.find(GlyphInfo(pFont, glyphId));
+    const GlyphTextureMap::const_iterator it = mGlyphTextureMap.find(GlyphInfo(pFont, glyphId, nSubpixelPhase));
 
     if(it != mGlyphTextureMap.end())
     {
-        const GlyphTextureInfo& gti = (*it).second;
-        glyphTextureInfo = gti;
+        const GlyphEntry& ge = (*it).second;
+
+        if(ge.mnShelfIndex != kShelfIndexNone)
+            TouchTextureShelf(ge.mGlyphTextureInfo.mpTextureInfo, ge.mnShelfIndex);
+
+        glyphTextureInfo = ge.mGlyphTextureInfo;
         return true;
     }
 
@@ -288,13 +305,40 @@ bool GlyphCache::GetGlyphTextureInfo(Font* pFont, GlyphId glyphId, GlyphTextureI
 bool GlyphCache::SetGlyphTextureInfo(Font* pFont, GlyphId glyphId, const GlyphTextureInfo& glyphTextureInfo)
 {
     const GlyphInfo glyphInfo(pFont, glyphId);
+    GlyphEntry&     ge = mGlyphTextureMap[glyphInfo]; // This will auto-create the entry if not present.
 
-    mGlyphTextureMap[glyphInfo] = glyphTextureInfo; // This will auto-create the entry if not present.
+    ge.mGlyphTextureInfo = glyphTextureInfo;
+    ge.mnShelfIndex      = kShelfIndexNone;
 
     return true;
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// TouchTextureShelf
+//
+void GlyphCache::TouchTextureShelf(TextureInfo* pTextureInfo, uint32_t nShelfIndex) const
+{
+    if(++mnUseStamp == 0)
+    {
+        // The stamp wrapped around. Restart all shelves from zero, which forgets 
+        // their relative age once but keeps the comparisons below correct.
+        for(eastl_size_t i = 0; i < mTextureInfoArray.size(); i++)
+        {
+            TextureInfo* const pTI = mTextureInfoArray[i];
+
+            for(uint32_t j = 0; j < pTI->mnShelfCount; j++)
+                pTI->mShelfArray[j].mnLastUsed = 0;
+        }
+
+        mnUseStamp = 1;
+    }
+
+    EA_ASSERT(nShelfIndex < pTextureInfo->mnShelfCount);
+    pTextureInfo->mShelfArray[nShelfIndex].mnLastUsed = mnUseStamp;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // RemoveTextureInfo
 //
@@ -321,7 +365,7 @@ void GlyphCache::RemoveTextureInfo(const Font* pFont)
         return (x & (x - 1)) == 0;
     }
 
-    bool GlyphCache::ValidateGlyphTextureMap(Font* pFont, GlyphId glyphId) const
+    bool GlyphCache::ValidateGlyphTextureMap(Font* pFont, GlyphId glyphId, uint32_t nSubpixelPhase) const
     {
         if(glyphId == kGlyphIdInvalid)
         {
@@ -335,14 +379,14 @@ void GlyphCache::RemoveTextureInfo(const Font* pFont)
                 if(value.first.mGlyphId == kGlyphIdInvalid)
                     return false;
 
-                if(!ValidateGlyphTextureMap(value.first.mpFont, value.first.mGlyphId))
+                if(!ValidateGlyphTextureMap(value.first.mpFont, value.first.mGlyphId, value.first.mnSubpixelPhase))
                     return false;
             }
         }
         else
         {
             // Verify that the glyph's associated GlyphInfo and GlyphTextureInfo are sane.
-            const GlyphInfo glyphInfo(pFont, glyphId);
+            const GlyphInfo glyphInfo(pFont, glyphId, nSubpixelPhase);
             bool            bResult(true);
 
             GlyphTextureMap::const_iterator itGlyph = mGlyphTextureMap.find(glyphInfo);
@@ -356,7 +400,7 @@ void GlyphCache::RemoveTextureInfo(const Font* pFont)
             if(!bResult)
                 return false;
 
-            const GlyphTextureInfo& gTI = itGlyph->second;
+            const GlyphTextureInfo& gTI = itGlyph->second.mGlyphTextureInfo;
             bResult = gTI.mpTextureInfo && EATextCache_IsPowerOf2(gTI.mpTextureInfo->mnSize);
             EA_ASSERT_MESSAGE(bResult, "ValidateGlyphTextureMap: Invalid TextureInfo");
             if(!bResult)
@@ -378,7 +422,7 @@ void GlyphCache::RemoveTextureInfo(const Font* pFont)
             {
                 const GlyphTextureMap::value_type& value  = *it;
                 const GlyphInfo&                   gI2    = value.first;
-                const GlyphTextureInfo&            gTI2   = value.second;
+                const GlyphTextureInfo&            gTI2   = value.second.mGlyphTextureInfo;
 
                 if(!(gI2 == glyphInfo)) // If the currently iterated glyph is different from the input glyphId...
                 {
@@ -408,13 +452,14 @@ void GlyphCache::RemoveTextureInfo(const Font* pFont)
 // AddGlyphTexture
 //
 bool GlyphCache::AddGlyphTexture(Font* pFont, GlyphId glyphId, const void* pSourceData, uint32_t nSourceSizeX, uint32_t nSourceSizeY, 
-                                  uint32_t nSourceStride, uint32_t nSourceFormat, EA::Text::GlyphTextureInfo& glyphTextureInfo)
+                                  uint32_t nSourceStride, uint32_t nSourceFormat, EA::Text::GlyphTextureInfo& glyphTextureInfo, uint32_t nSubpixelPhase)
 {
     #if EATEXT_THREAD_SAFETY_ENABLED
         EA::Thread::AutoFutex autoMutex(mMutex);
     #endif
 
-    EA_ASSERT_MESSAGE(mGlyphTextureMap.find(GlyphInfo(pFont, glyphId)) == mGlyphTextureMap.end(), "GlyphCache: Glyph already present.");
+    EA_ASSERT(nSubpixelPhase < (uint32_t)kSubpixelPhaseCount);
+    EA_ASSERT_MESSAGE(mGlyphTextureMap.find(GlyphInfo(pFont, glyphId, nSubpixelPhase)) == mGlyphTextureMap.end(), "GlyphCache: Glyph already present.");
 
     uint32_t xPosition, yPosition;
 
@@ -441,9 +486,13 @@ bool GlyphCache::AddGlyphTexture(Font* pFont, GlyphId glyphId, const void* pSour
         EA_ASSERT(bResult);
         if(bResult)
         {
-            // This operation will create the GlyphTextureInfo entry if not already present.
+            // This operation will create the GlyphEntry if not already present.
             // If it's already present, then this will overwrite the existing entry.
-            GlyphTextureInfo& gti = mGlyphTextureMap[GlyphInfo(pFont, glyphId)];
+            GlyphEntry&       ge  = mGlyphTextureMap[GlyphInfo(pFont, glyphId, nSubpixelPhase)];
+            GlyphTextureInfo& gti = ge.mGlyphTextureInfo;
+
+            ge.mnShelfIndex   = FindTextureShelf(*pTextureInfo, yPosition);
+            TouchTextureShelf(pTextureInfo, ge.mnShelfIndex);
 
             gti.mpTextureInfo = pTextureInfo;
             gti.mX1           = xPosition * pTextureInfo->mfSizeInverse;
@@ -454,7 +503,7 @@ bool GlyphCache::AddGlyphTexture(Font* pFont, GlyphId glyphId, const void* pSour
             glyphTextureInfo = gti;
 
             #if defined(EA_DEBUG) && defined(AUTHOR_PPEDRIANA)
-                ValidateGlyphTextureMap(pFont, glyphId);
+                ValidateGlyphTextureMap(pFont, glyphId, nSubpixelPhase);
             #endif
 
             return true;
@@ -532,19 +581,10 @@ TextureInfo* GlyphCache::AddTextureInfo(TextureInfo* pTextureInfo, bool bInitial
 
             if(!bInitialized)
             {
-                pTextureInfo->mnGeneration    = 1;
-                pTextureInfo->mnColumnCount   = (uint8_t)mnColumnCountDefault;
-                pTextureInfo->mbWritable      = true;
-                pTextureInfo->mnOpenAreaX     = 0;
-                pTextureInfo->mnOpenAreaY     = 0;
-                pTextureInfo->mnOpenAreaLineH = 0;
-
-                for(uint32_t j = 0; j < mnColumnCountDefault; j++)
-                {
-                    pTextureInfo->mnColumnWidths[j]  = (uint8_t)mnColumnWidthsDefault[j];
-                    pTextureInfo->mnColumnHeights[j] = 0;
-                    pTextureInfo->mnOpenAreaX        = pTextureInfo->mnOpenAreaX + pTextureInfo->mnColumnWidths[j];
-                }
+                pTextureInfo->mnGeneration = 1;
+                pTextureInfo->mbWritable   = true;
+                pTextureInfo->mnShelfCount = 0;
+                pTextureInfo->mnShelfAreaY = 0;
 
                 // To consider: Do this clear in debug builds only.
                 ClearTextureInternal(pTextureInfo);
@@ -574,11 +614,12 @@ bool GlyphCache::ClearTexture(TextureInfo* pTextureInfo)
 
     // To consider: Do this clear in debug builds only.
     ClearTextureInternal(pTextureInfo);
+    RemovePendingGlyphs(pTextureInfo, kShelfIndexNone);
 
     // Remove all glyph info that corresponds to the given texture.
     for(GlyphTextureMap::iterator it(mGlyphTextureMap.begin()); it != mGlyphTextureMap.end();)
     {
-        const GlyphTextureInfo& gti = (*it).second;
+        const GlyphTextureInfo& gti = (*it).second.mGlyphTextureInfo;
 
         if(gti.mpTextureInfo == pTextureInfo)
         {
@@ -590,15 +631,8 @@ bool GlyphCache::ClearTexture(TextureInfo* pTextureInfo)
     }
 
     // Clear the texture position allocation information.
-    pTextureInfo->mnOpenAreaX     = 0; // We will set adjust it below.
-    pTextureInfo->mnOpenAreaY     = 0; 
-    pTextureInfo->mnOpenAreaLineH = 0;
-
-    for(uint32_t i = 0; i < pTextureInfo->mnColumnCount; i++)
-    {
-        pTextureInfo->mnOpenAreaX        = (pTextureInfo->mnOpenAreaX + pTextureInfo->mnColumnWidths[i]);
-        pTextureInfo->mnColumnHeights[i] = 0;
-    }
+    pTextureInfo->mnShelfCount = 0;
+    pTextureInfo->mnShelfAreaY = 0;
 
     // Mark the texture as having been changed. Any future references that 
     // refer to a previous generation number will be known to be invalid.
@@ -612,46 +646,38 @@ bool GlyphCache::ClearTexture(TextureInfo* pTextureInfo)
 //
 // Tries to allocate space from a specific texture.
 //
-// The texture is divided into a number of predefined vertical bins (columns).
-// Also, there is an open area on the right side of the texture which handles
-// overflow from the columns on the left side. The left-most columns are 
-// narrow and handle thin glyphs such as the ones shown below. As we move
-// rightward, successive columns are wider. Glyphs are added to each column
-// until the column runs out of space, at which point the glyph is tried in 
-// the next column, and so on.
+// The texture is divided into horizontal shelves, which are created from the 
+// top of the texture downward as they are needed. Each shelf has a fixed height
+// and glyphs are added to it from left to right. A glyph goes into the shelf 
+// that wastes the least height, as long as the shelf isn't much taller than the 
+// glyph. Otherwise a new shelf of the glyph's height is made below the existing 
+// ones. Only when there is no room left for a new shelf do we put a glyph into 
+// any shelf that is tall enough for it.
 //
-// Each column is on a four pixel x boundary. And each character vertically
-// within a column begins on a four pixel y boundary. There is at least one
-// blank pixel between each glyph. This is done because some texture sampling
-// will read outside of the glyph, and we don't want to read pixels from 
-// other glyphs.
+// Each glyph begins on a four pixel x and y boundary and shelf heights are 
+// multiples of four. There is at least mnGlyphPadding blank pixels between 
+// glyphs. This is done because some texture sampling will read outside of 
+// the glyph, and we don't want to read pixels from other glyphs.
 // 
 // ------------------------------------------------------------------
-// | i  |   b   |   W   |       | D3TPZ+?M                          |
-// | l  |   c   |   X   |       |                                   |
-// | .  |   e   |   Q   |       |                                   |
-// | :  |   d   |   H   |       |                                   |
-// | ;  |   r   |       |       |           (open area)             |
-// | ,  |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
-// |    |       |       |       |                                   |
+// | a c e m n o r s u v w x z                                      | <- shelf 0
+// |----------------------------------------------------------------|
+// | b d f h k l t A B C D E F G H I J K L M N O P                  | <- shelf 1
+// |----------------------------------------------------------------|
+// | g j p q y                                                      | <- shelf 2
+// |----------------------------------------------------------------|
+// | . , : ; - ' "                                                  | <- shelf 3
+// |----------------------------------------------------------------|
+// |                                                                |
+// |                                                                |
+// |                       (unshelved area)                         |
+// |                                                                |
+// |                                                                |
 // ------------------------------------------------------------------
 //
+// When all textures are full, AllocateTextureArea evicts the least recently
+// used shelf and the space of that shelf is reused.
+//
 bool GlyphCache::TryAllocateTextureArea(uint32_t xSize, uint32_t ySize, TextureInfo& ti, uint32_t& xPosition, uint32_t& yPosition)
 {
     // Disabled until the Futex::HasLock function is published with EAThread.
@@ -664,91 +690,112 @@ bool GlyphCache::TryAllocateTextureArea(uint32_t xSize, uint32_t ySize, TextureI
     // textures or the user might want to use polygon glyphs instead.
     EA_ASSERT((xSize < ti.mnSize) && (ySize < ti.mnSize));
 
-    uint32_t x = 0;
+    const uint32_t nShelfHeight = (ySize + mnGlyphPadding + 3) & ~3;  // The +3 & ~3 is to bump to 4 pixel increment.
+    const uint32_t nGlyphWidth  = (xSize + mnGlyphPadding + 3) & ~3;
+    uint32_t       nBest        = kShelfIndexNone;
+    uint32_t       nBestWaste   = UINT32_MAX;
+    uint32_t       i;
 
-    // First try the columns on the left side of the texture.
-    for(uint32_t j = 0; j < ti.mnColumnCount; j++)
+    // First try the existing shelves that are a close fit for the glyph.
+    for(i = 0; i < ti.mnShelfCount; i++)
     {
-        EA_ASSERT((x % 4) == 0); // Assert that each column begins on a 4 pixel boundary.
+        const TextureShelf& shelf = ti.mShelfArray[i];
 
-        if((xSize < ti.mnColumnWidths[j]) && (ySize < (ti.mnSize - (uint32_t)ti.mnColumnHeights[j])))
+        if((shelf.mnHeight >= nShelfHeight) && ((shelf.mnX + xSize) <= ti.mnSize))
         {
-            xPosition = x;
-            yPosition = ti.mnColumnHeights[j];
-
-            ti.mnColumnHeights[j] = (ti.mnColumnHeights[j] + ySize + mnGlyphPadding);
-            if(ti.mnColumnHeights[j] % 4)
-                ti.mnColumnHeights[j] = (ti.mnColumnHeights[j] + 3) & ~3; // The +3 & ~3 is to bump to 4 pixel increment.
-
-            EA_ASSERT(ti.mnColumnHeights[j] <= ti.mnSize);
-            EA_ASSERT((ti.mnColumnHeights[j] % 4) == 0);
-            EA_ASSERT(((xPosition % 4) == 0) && ((yPosition % 4) == 0));
-            EA_ASSERT(((xPosition + xSize) <= ti.mnSize) && ((yPosition + ySize) <= ti.mnSize));
-            return true;
-        }  
+            const uint32_t nWaste = (shelf.mnHeight - nShelfHeight);
 
-        x += ti.mnColumnWidths[j];
+            if((nWaste <= (nShelfHeight / 2)) && (nWaste < nBestWaste))
+            {
+                nBest      = i;
+                nBestWaste = nWaste;
+            }
+        }
     }
 
-    // At this point none of the above columns had space. 
-    // So we try to use the open space on the right side of the texture.
-    EA_ASSERT((xSize <= ti.mnSize) && (ySize <= ti.mnSize)); // Assert that this glyph could ever fit into the space of the texture. 
-
-    if((x < ti.mnSize) && (xSize <= (ti.mnSize - x))) // If there is an open area to the right of these columns and if this glyph could possibly ever fit into it...
+    // Then try to make a new shelf below the existing ones.
+    if((nBest == kShelfIndexNone) && (ti.mnShelfCount < (uint32_t)kTextureShelfCountMax) && ((ti.mnShelfAreaY + nShelfHeight) <= ti.mnSize))
     {
-        EA_ASSERT(ti.mnOpenAreaX >= x); // The current free spot should always be to the right of any columns.
+        TextureShelf& shelf = ti.mShelfArray[ti.mnShelfCount];
+
+        shelf.mnY        = (uint16_t)ti.mnShelfAreaY;
+        shelf.mnHeight   = (uint16_t)nShelfHeight;
+        shelf.mnX        = 0;
+        shelf.mnLastUsed = mnUseStamp;
 
-        Retry:
-        bool bGlyphFitsY = ((ti.mnOpenAreaY + ySize) <= ti.mnSize);
+        nBest = ti.mnShelfCount++;
+        ti.mnShelfAreaY += nShelfHeight;
+    }
 
-        if(bGlyphFitsY)
+    // Finally settle for any shelf that has room for the glyph.
+    if(nBest == kShelfIndexNone)
+    {
+        for(i = 0; i < ti.mnShelfCount; i++)
         {
-            bool bGlyphFitsX = ((ti.mnOpenAreaX + xSize) <= ti.mnSize);
+            const TextureShelf& shelf = ti.mShelfArray[i];
 
-            if(bGlyphFitsX) // Much of the time this will be true.
+            if((shelf.mnHeight >= nShelfHeight) && ((shelf.mnX + xSize) <= ti.mnSize) && ((uint32_t)(shelf.mnHeight - nShelfHeight) < nBestWaste))
             {
-                xPosition = ti.mnOpenAreaX;
-                yPosition = ti.mnOpenAreaY;
+                nBest      = i;
+                nBestWaste = (shelf.mnHeight - nShelfHeight);
+            }
+        }
 
-                ti.mnOpenAreaX = (ti.mnOpenAreaX + xSize + mnGlyphPadding); // The +3 & ~3 is to bump to 4 pixel increment.
-                if(ti.mnOpenAreaX % 4)
-                    ti.mnOpenAreaX = (ti.mnOpenAreaX + 3) & ~3; // The +3 & ~3 is to bump to 4 pixel increment.
+        if(nBest == kShelfIndexNone) // No more space.
+            return false;
+    }
 
-                if(ti.mnOpenAreaLineH < ySize)
-                    ti.mnOpenAreaLineH = ySize;
+    TextureShelf& shelf = ti.mShelfArray[nBest];
 
-                EA_ASSERT(((ti.mnOpenAreaX % 4) == 0) && ((ti.mnOpenAreaY % 4) == 0));
-                EA_ASSERT(((xPosition % 4) == 0) && ((yPosition % 4) == 0));
-                EA_ASSERT(((xPosition + xSize) <= ti.mnSize) && ((yPosition + ySize) <= ti.mnSize));
+    xPosition = shelf.mnX;
+    yPosition = shelf.mnY;
 
-                return true;
-            }
-            else
-            {
-                // Reset mnOpenAreaX to the left side of the open area. We know from above that the glyph will fit in the x direction.
-                // Move mnOpenAreaY down by one line. The + mnGlyphPadding separates each line by at least mnGlyphPadding.
-                // Reset mnOpenAreaLineH to zero; we will grow it anew as we add glyphs to this line.
+    shelf.mnX = (uint16_t)(shelf.mnX + nGlyphWidth);
 
-                ti.mnOpenAreaX = x;  
-           
-                ti.mnOpenAreaY += ti.mnOpenAreaLineH + mnGlyphPadding;  
-                if(ti.mnOpenAreaY % 4)
-                    ti.mnOpenAreaY = (ti.mnOpenAreaY + 3) & ~3; // The +3 & ~3 is to bump to 4 pixel increment.
+    EA_ASSERT(((xPosition % 4) == 0) && ((yPosition % 4) == 0));
+    EA_ASSERT(((xPosition + xSize) <= ti.mnSize) && ((yPosition + ySize) <= ti.mnSize));
+    return true;
+}
 
-                ti.mnOpenAreaLineH = 0;
 
-                goto Retry;                     
-            }
-        }
+///////////////////////////////////////////////////////////////////////////////
+// EvictTextureShelf
+//
+void GlyphCache::EvictTextureShelf(TextureInfo* pTextureInfo, uint32_t nShelfIndex)
+{
+    EA_ASSERT(nShelfIndex < pTextureInfo->mnShelfCount);
+
+    TextureShelf& shelf = pTextureInfo->mShelfArray[nShelfIndex];
+
+    // Remove all glyph info that corresponds to the given shelf.
+    for(GlyphTextureMap::iterator it(mGlyphTextureMap.begin()); it != mGlyphTextureMap.end();)
+    {
+        const GlyphEntry& ge = (*it).second;
+
+        if((ge.mGlyphTextureInfo.mpTextureInfo == pTextureInfo) && (ge.mnShelfIndex == nShelfIndex))
+            it = mGlyphTextureMap.erase(it);
         else
-        {
-            // If the glyph doesn't fit in the y direction, then it has no chance of fitting
-            // in the open space unless we clear the entire texture or try a different texture.
-        }
+            ++it;
     }
 
-    // No more space.
-    return false;
+    RemovePendingGlyphs(pTextureInfo, nShelfIndex);
+
+    // Clear the shelf's image, as glyph padding relies on the space around glyphs 
+    // being blank. DXT3 textures are addressed in rows of 4x4 texel tiles.
+    if(pTextureInfo->mpData || BeginUpdate(pTextureInfo))
+    {
+        const uint32_t nRow = ((pTextureInfo->mFormat == kTextureFormatDXT3) ? (shelf.mnY / 4u) : shelf.mnY);
+
+        ClearTextureImage(pTextureInfo->mpData + (nRow * pTextureInfo->mnStride), pTextureInfo->mnSize, 
+                          shelf.mnHeight, (uint32_t)pTextureInfo->mnStride, pTextureInfo->mFormat);
+    }
+
+    shelf.mnX        = 0;
+    shelf.mnLastUsed = 0;
+
+    // Mark the texture as having been changed. Any future references that 
+    // refer to a previous generation number will be known to be invalid.
+    pTextureInfo->mnGeneration++;
 }
 
 
@@ -756,8 +803,8 @@ bool GlyphCache::TryAllocateTextureArea(uint32_t xSize, uint32_t ySize, TextureI
 // AllocateTextureArea
 //
 // Tries to allocate space from a texture. First try for free space on 
-// existing textures, then try to free space on existing textures, 
-// then try to create a new texture.
+// existing textures, then try to create a new texture, then evict the
+// least recently used glyphs to make space.
 //
 TextureInfo* GlyphCache::AllocateTextureArea(uint32_t xSize, uint32_t ySize, uint32_t& xPosition, uint32_t& yPosition)
 {
@@ -785,7 +832,7 @@ TextureInfo* GlyphCache::AllocateTextureArea(uint32_t xSize, uint32_t ySize, uin
 
     if(!pTextureInfo)
     {
-        // At this point, no texture could be cleared or could serve the request. We possibly try to create a new texture.
+        // At this point, no texture could serve the request. We possibly try to create a new texture.
         if(mbAutoTextureCreate && (mTextureInfoArray.size() < mnTextureInfoCountMax) && (mRecursionCounter == 0))
         {
             if(AddTextureInfo())
@@ -799,6 +846,70 @@ TextureInfo* GlyphCache::AllocateTextureArea(uint32_t xSize, uint32_t ySize, uin
         }
     }
 
+    if(!pTextureInfo && (mRecursionCounter == 0))
+    {
+        // At this point all textures are full. We evict the least recently used shelf 
+        // which is tall enough for the glyph and put the glyph there.
+        const uint32_t nShelfHeight = (ySize + mnGlyphPadding + 3) & ~3;
+        TextureInfo*   pTIEvict     = NULL;
+        uint32_t       nShelfEvict  = 0;
+        uint32_t       nLastUsed    = UINT32_MAX;
+
+        for(i = 0, iEnd = mTextureInfoArray.size(); i < iEnd; i++)
+        {
+            TextureInfo* const pTITemp = mTextureInfoArray[i];
+
+            if(pTITemp->mbWritable)
+            {
+                for(uint32_t j = 0; j < pTITemp->mnShelfCount; j++)
+                {
+                    const TextureShelf& shelf = pTITemp->mShelfArray[j];
+
+                    if((shelf.mnHeight >= nShelfHeight) && (shelf.mnLastUsed < nLastUsed))
+                    {
+                        pTIEvict    = pTITemp;
+                        nShelfEvict = j;
+                        nLastUsed   = shelf.mnLastUsed;
+                    }
+                }
+            }
+        }
+
+        if(pTIEvict)
+            EvictTextureShelf(pTIEvict, nShelfEvict);
+        else
+        {
+            // No shelf is tall enough for the glyph, so we start over with 
+            // the texture whose most recently used shelf is the oldest.
+            for(i = 0, iEnd = mTextureInfoArray.size(); i < iEnd; i++)
+            {
+                TextureInfo* const pTITemp  = mTextureInfoArray[i];
+                uint32_t           nTIUsed  = 0;
+
+                if(pTITemp->mbWritable)
+                {
+                    for(uint32_t j = 0; j < pTITemp->mnShelfCount; j++)
+                    {
+                        if(pTITemp->mShelfArray[j].mnLastUsed > nTIUsed)
+                            nTIUsed = pTITemp->mShelfArray[j].mnLastUsed;
+                    }
+
+                    if(!pTIEvict || (nTIUsed < nLastUsed))
+                    {
+                        pTIEvict  = pTITemp;
+                        nLastUsed = nTIUsed;
+                    }
+                }
+            }
+
+            if(pTIEvict)
+                ClearTexture(pTIEvict);
+        }
+
+        if(pTIEvict && TryAllocateTextureArea(xSize, ySize, *pTIEvict, xPosition, yPosition))
+            pTextureInfo = pTIEvict;
+    }
+
     #ifdef EA_DEBUG
         if(!pTextureInfo)
         {
@@ -809,7 +920,6 @@ TextureInfo* GlyphCache::AllocateTextureArea(uint32_t xSize, uint32_t ySize, uin
 
     return pTextureInfo;
 }
-
 ///////////////////////////////////////////////////////////////////////////////
 // WriteTextureArea
 //
@@ -1240,6 +1350,17 @@ void GlyphCache::WriteTextureArea(void* pDest, uint32_t nDestPositionX, uint32_t
 // Generic texture clear function.
 //
 void GlyphCache::ClearTextureImage(void* pDest, uint32_t nDestSize, uint32_t nDestStride, uint32_t nDestFormat)
+{
+    ClearTextureImage(pDest, nDestSize, nDestSize, nDestStride, nDestFormat);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ClearTextureImage
+//
+// Generic texture area clear function.
+//
+void GlyphCache::ClearTextureImage(void* pDest, uint32_t nDestWidth, uint32_t nDestHeight, uint32_t nDestStride, uint32_t nDestFormat)
 {
     #if EATEXT_THREAD_SAFETY_ENABLED
         EA::Thread::AutoFutex autoMutex(mMutex);
@@ -1249,8 +1370,8 @@ void GlyphCache::ClearTextureImage(void* pDest, uint32_t nDestSize, uint32_t nDe
 
     if(nDestFormat == kTextureFormatDXT3)
     {
-        const int tileW = ((nDestSize + 3) / 4);
-        const int tileH = ((nDestSize + 3) / 4);
+        const int tileW = ((nDestWidth  + 3) / 4);
+        const int tileH = ((nDestHeight + 3) / 4);
 
         for(int y = 0; y < tileH; ++y)
         {
@@ -1274,18 +1395,18 @@ void GlyphCache::ClearTextureImage(void* pDest, uint32_t nDestSize, uint32_t nDe
     }
     else if(nDestFormat == kTextureFormat8Bpp)
     {
-        for(uint32_t y = 0; y < nDestSize; ++y)
+        for(uint32_t y = 0; y < nDestHeight; ++y)
         {
             uint8_t* const pDestRow = (uint8_t*)dstRow++;
-            memset(pDestRow, 0, nDestSize * sizeof(uint8_t));
+            memset(pDestRow, 0, nDestWidth * sizeof(uint8_t));
         }
     }
     else if((nDestFormat == kTextureFormatARGB) || (nDestFormat == kTextureFormatRGBA))
     {
-        for(uint32_t y = 0; y < nDestSize; ++y)
+        for(uint32_t y = 0; y < nDestHeight; ++y)
         {
             uint32_t* const pDestRow = (uint32_t*)dstRow++;
-            memset(pDestRow, 0, nDestSize * sizeof(uint32_t));
+            memset(pDestRow, 0, nDestWidth * sizeof(uint32_t));
         }
     }
     else
@@ -1313,24 +1434,580 @@ void GlyphCache::ClearTextureInternal(TextureInfo* pTextureInfo)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Glyph texture data
+//
+// GetGlyphTextureData writes and SetGlyphTextureData reads the following,
+// where every value is a little-endian uint32_t (floats are stored by bits):
+//
+//     Header:   magic, version, texture format, texture count, font count, 
+//               glyph count, glyph metrics float count
+//     Textures: size, shelf count, shelf area y, (y, height, x) per shelf, 
+//               followed by the texture image, row by row (32 bit texels are
+//               stored as little-endian uint32_t too)
+//     Fonts:    file hash, description hash
+//     Glyphs:   font index, glyph id, subpixel phase, texture index, shelf index, 
+//               x1, y1, x2, y2 (in texels), followed by the GlyphMetrics floats
+//
+// The version must be incremented whenever this layout changes.
+//
+const uint32_t kGlyphTextureDataMagic   = 0x43544145; // 'EATC'
+const uint32_t kGlyphTextureDataVersion = 3;
+const uint32_t kFontKeyFileBytes        = 1024;       // Covers the table directory, with its per-table checksums, of TrueType and OpenType files.
+
+namespace
+{
+    // Writes little-endian values to a buffer, or only counts their size if the buffer is NULL.
+    struct GlyphDataWriter
+    {
+        uint8_t* mpData;
+        uint32_t mnSize;
+
+        GlyphDataWriter(uint8_t* pData) : mpData(pData), mnSize(0) { }
+
+        void WriteUint32(uint32_t n)
+        {
+            if(mpData)
+            {
+                uint8_t* const p = mpData + mnSize;
+                p[0] = (uint8_t)(n);
+                p[1] = (uint8_t)(n >>  8);
+                p[2] = (uint8_t)(n >> 16);
+                p[3] = (uint8_t)(n >> 24);
+            }
+            mnSize += 4;
+        }
+
+        void WriteFloat(float f)
+        {
+            union { float f; uint32_t n; } u;
+            u.f = f;
+            WriteUint32(u.n);
+        }
+
+        void WriteBytes(const void* pBytes, uint32_t nCount)
+        {
+            if(mpData)
+                memcpy(mpData + mnSize, pBytes, nCount);
+            mnSize += nCount;
+        }
+
+        // 32 bit texels are native-endian uint32_t values; other formats are byte streams.
+        void WriteTextureRow(const uint8_t* pRow, uint32_t nRowBytes, uint32_t nFormat)
+        {
+            if((nFormat == kTextureFormatARGB) || (nFormat == kTextureFormatRGBA))
+            {
+                for(uint32_t i = 0; i < nRowBytes; i += 4)
+                    WriteUint32(*(const uint32_t*)(pRow + i));
+            }
+            else
+                WriteBytes(pRow, nRowBytes);
+        }
+    };
+
+    // Reads little-endian values from a buffer. Reading past the end sets mbError and returns zeros.
+    struct GlyphDataReader
+    {
+        const uint8_t* mpData;
+        uint32_t       mnSize;
+        uint32_t       mnPosition;
+        bool           mbError;
+
+        GlyphDataReader(const void* pData, uint32_t nSize) : mpData((const uint8_t*)pData), mnSize(nSize), mnPosition(0), mbError(false) { }
+
+        uint32_t ReadUint32()
+        {
+            const uint8_t* const p = ReadBytes(4);
+
+            if(p)
+                return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+            return 0;
+        }
+
+        float ReadFloat()
+        {
+            union { float f; uint32_t n; } u;
+            u.n = ReadUint32();
+            return u.f;
+        }
+
+        const uint8_t* ReadBytes(uint32_t nCount)
+        {
+            if(mbError || (nCount > (mnSize - mnPosition)))
+            {
+                mbError = true;
+                return NULL;
+            }
+
+            const uint8_t* const p = mpData + mnPosition;
+            mnPosition += nCount;
+            return p;
+        }
+    };
+
+    // Copies a texture row written by GlyphDataWriter::WriteTextureRow back to native form.
+    void ReadTextureRow(uint8_t* pDest, const uint8_t* pSource, uint32_t nRowBytes, uint32_t nFormat)
+    {
+        if((nFormat == kTextureFormatARGB) || (nFormat == kTextureFormatRGBA))
+        {
+            for(uint32_t i = 0; i < nRowBytes; i += 4, pSource += 4)
+                *(uint32_t*)(pDest + i) = (uint32_t)pSource[0] | ((uint32_t)pSource[1] << 8) | ((uint32_t)pSource[2] << 16) | ((uint32_t)pSource[3] << 24);
+        }
+        else
+            memcpy(pDest, pSource, nRowBytes);
+    }
+
+    uint32_t FNV1Hash(const void* pData, size_t nSize, uint32_t nHash = 2166136261U)
+    {
+        const uint8_t* p = (const uint8_t*)pData;
+
+        for(size_t i = 0; i < nSize; i++)
+            nHash = (nHash * 16777619U) ^ p[i];
+
+        return nHash;
+    }
+
+    // Gets the row layout of a texture image. Returns false for formats we can't save.
+    bool GetTextureImageLayout(uint32_t nFormat, uint32_t nSize, uint32_t& nRowCount, uint32_t& nRowBytes)
+    {
+        switch (nFormat)
+        {
+            case kTextureFormat8Bpp:
+                nRowCount = nSize;
+                nRowBytes = nSize;
+                return true;
+
+            case kTextureFormatARGB:
+            case kTextureFormatRGBA:
+                nRowCount = nSize;
+                nRowBytes = nSize * 4;
+                return true;
+
+            case kTextureFormatDXT3:
+                nRowCount = (nSize + 3) / 4;      // DXT3 rows are rows of 4x4 texel tiles of 16 bytes each.
+                nRowBytes = ((nSize + 3) / 4) * 16;
+                return true;
+        }
+
+        return false;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// GetFontKey
+//
+void GlyphCache::GetFontKey(Font* pFont, FontKey& fontKey)
+{
+    IO::IStream* const pStream = pFont->GetStream();
+    uint32_t           nHash   = FNV1Hash(NULL, 0);
+
+    if(pStream)
+    {
+        const IO::size_type nStreamSize = pStream->GetSize();
+        const IO::off_type  nPosition   = pStream->GetPosition();
+        uint8_t             buffer[kFontKeyFileBytes];
+
+        nHash = FNV1Hash(&nStreamSize, sizeof(nStreamSize), nHash);
+
+        if(pStream->SetPosition(0))
+        {
+            const IO::size_type nReadSize = pStream->Read(buffer, (nStreamSize < kFontKeyFileBytes) ? nStreamSize : kFontKeyFileBytes);
+
+            if(nReadSize != IO::kSizeTypeError)
+                nHash = FNV1Hash(buffer, (size_t)nReadSize, nHash);
+        }
+
+        pStream->SetPosition(nPosition);
+    }
+
+    fontKey.mnFileHash = nHash;
+
+    FontDescription fd;
+    pFont->GetFontDescription(fd);
+
+    size_t nFamilyLength = 0;
+    while((nFamilyLength < kFamilyNameCapacity) && fd.mFamily[nFamilyLength])
+        ++nFamilyLength;
+
+    nHash = FNV1Hash(fd.mFamily, nFamilyLength * sizeof(Char));
+    nHash = FNV1Hash(&fd.mfSize,          sizeof(fd.mfSize),          nHash);
+    nHash = FNV1Hash(&fd.mStyle,          sizeof(fd.mStyle),          nHash);
+    nHash = FNV1Hash(&fd.mfWeight,        sizeof(fd.mfWeight),        nHash);
+    nHash = FNV1Hash(&fd.mfStretch,       sizeof(fd.mfStretch),       nHash);
+    nHash = FNV1Hash(&fd.mVariant,        sizeof(fd.mVariant),        nHash);
+    nHash = FNV1Hash(&fd.mSmooth,         sizeof(fd.mSmooth),         nHash);
+    nHash = FNV1Hash(&fd.mEffect,         sizeof(fd.mEffect),         nHash);
+    nHash = FNV1Hash(&fd.mfEffectX,       sizeof(fd.mfEffectX),       nHash);
+    nHash = FNV1Hash(&fd.mfEffectY,       sizeof(fd.mfEffectY),       nHash);
+    nHash = FNV1Hash(&fd.mEffectBaseColor, sizeof(fd.mEffectBaseColor), nHash);
+    nHash = FNV1Hash(&fd.mEffectColor,    sizeof(fd.mEffectColor),    nHash);
+    nHash = FNV1Hash(&fd.mHighLightColor, sizeof(fd.mHighLightColor), nHash);
+
+    fontKey.mnDescriptionHash = nHash;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// AdoptPendingGlyphs
+//
+bool GlyphCache::AdoptPendingGlyphs(Font* pFont)
+{
+    #if EATEXT_THREAD_SAFETY_ENABLED
+        EA::Thread::AutoFutex autoMutex(mMutex);
+    #endif
+
+    if(mPendingGlyphArray.empty()) // Skip reading the Font's stream in the usual case.
+        return false;
+
+    FontKey fontKey;
+    GetFontKey(pFont, fontKey);
+
+    bool bAdopted = false;
+
+    for(eastl_size_t i = 0; i < mPendingGlyphArray.size(); )
+    {
+        PendingGlyph& pg = mPendingGlyphArray[i];
+
+        if(mPendingFontKeyArray[pg.mnFontIndex] == fontKey)
+        {
+            // insert leaves alone any glyph that was rendered anew before we got here.
+            mGlyphTextureMap.insert(GlyphTextureMap::value_type(GlyphInfo(pFont, pg.mGlyphId, pg.mnSubpixelPhase), pg.mGlyphEntry));
+            pFont->SetGlyphMetrics(pg.mGlyphId, pg.mGlyphMetrics);
+
+            pg = mPendingGlyphArray.back();
+            mPendingGlyphArray.pop_back();
+            bAdopted = true;
+        }
+        else
+            ++i;
+    }
+
+    if(mPendingGlyphArray.empty())
+        mPendingFontKeyArray.clear();
+
+    return bAdopted;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RemovePendingGlyphs
+//
+void GlyphCache::RemovePendingGlyphs(const TextureInfo* pTextureInfo, uint32_t nShelfIndex)
+{
+    for(eastl_size_t i = 0; i < mPendingGlyphArray.size(); )
+    {
+        const GlyphEntry& ge = mPendingGlyphArray[i].mGlyphEntry;
+
+        if((ge.mGlyphTextureInfo.mpTextureInfo == pTextureInfo) && ((nShelfIndex == kShelfIndexNone) || (ge.mnShelfIndex == nShelfIndex)))
+        {
+            mPendingGlyphArray[i] = mPendingGlyphArray.back();
+            mPendingGlyphArray.pop_back();
+        }
+        else
+            ++i;
+    }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // GetGlyphTextureData
 //
-uint32_t GlyphCache::GetGlyphTextureData(void* /*pGlyphData*/, uint32_t /*nGlyphDataSize*/, bool /*bPortable*/)
+uint32_t GlyphCache::GetGlyphTextureData(void* pGlyphData, uint32_t nGlyphDataSize, bool /*bPortable*/)
 {
-    EA_FAIL_MESSAGE("GlyphCache::GetGlyphTextureData(): not implemented yet.");
+    #if EATEXT_THREAD_SAFETY_ENABLED
+        EA::Thread::AutoFutex autoMutex(mMutex);
+    #endif
+
+    // Gather the textures we own. Read-only textures (e.g. from a BmpFont) are not ours to save.
+    eastl::fixed_vector<TextureInfo*, kTextureSlotCount, true> textureArray;
+    uint32_t i, j, nRowCount, nRowBytes;
+
+    for(i = 0; i < (uint32_t)mTextureInfoArray.size(); i++)
+    {
+        TextureInfo* const pTI = mTextureInfoArray[i];
+
+        if(pTI->mbWritable && GetTextureImageLayout(pTI->mFormat, pTI->mnSize, nRowCount, nRowBytes))
+            textureArray.push_back(pTI);
+    }
+
+    // Gather the glyphs on those textures, both attached and still pending, and their fonts.
+    PendingGlyphArray glyphArray(EA::Allocator::EASTLICoreAllocator(EATEXT_ALLOC_PREFIX "GlyphCache/SavedGlyphArray", mpCoreAllocator));
+    FontKeyArray fontKeyArray(mPendingFontKeyArray); // Pending glyphs keep their font indexes.
+    eastl::hash_map<const Font*, uint32_t, eastl::hash<const Font*>, eastl::equal_to<const Font*>, EA::Allocator::EASTLICoreAllocator> 
+                 fontIndexMap(EA::Allocator::EASTLICoreAllocator(EATEXT_ALLOC_PREFIX "GlyphCache/FontIndexMap", mpCoreAllocator));
+
+    for(GlyphTextureMap::iterator it = mGlyphTextureMap.begin(); it != mGlyphTextureMap.end(); ++it)
+    {
+        const GlyphInfo&  gi = it->first;
+        const GlyphEntry& ge = it->second;
+        PendingGlyph      sg;
+
+        if((ge.mnShelfIndex == kShelfIndexNone) || 
+           (eastl::find(textureArray.begin(), textureArray.end(), ge.mGlyphTextureInfo.mpTextureInfo) == textureArray.end()) ||
+           !gi.mpFont->GetGlyphMetrics(gi.mGlyphId, sg.mGlyphMetrics))
+            continue;
+
+        if(fontIndexMap.find(gi.mpFont) == fontIndexMap.end())
+        {
+            FontKey fontKey;
+            GetFontKey(gi.mpFont, fontKey);
+            fontIndexMap[gi.mpFont] = (uint32_t)fontKeyArray.size();
+            fontKeyArray.push_back(fontKey);
+        }
+
+        sg.mnFontIndex = fontIndexMap[gi.mpFont];
+        sg.mGlyphId         = gi.mGlyphId;
+        sg.mnSubpixelPhase  = gi.mnSubpixelPhase;
+        sg.mGlyphEntry      = ge;
+        glyphArray.push_back(sg);
+    }
+
+    for(PendingGlyphArray::iterator it = mPendingGlyphArray.begin(); it != mPendingGlyphArray.end(); ++it)
+    {
+        if(eastl::find(textureArray.begin(), textureArray.end(), it->mGlyphEntry.mGlyphTextureInfo.mpTextureInfo) != textureArray.end())
+            glyphArray.push_back(*it);
+    }
+
+    // Write the data, first only to measure it and then for real if there is room.
+    for(int nPass = 0; nPass < 2; nPass++)
+    {
+        GlyphDataWriter writer(nPass ? (uint8_t*)pGlyphData : NULL);
+
+        writer.WriteUint32(kGlyphTextureDataMagic);
+        writer.WriteUint32(kGlyphTextureDataVersion);
+        writer.WriteUint32(textureArray.empty() ? (uint32_t)kTextureFormatNone : textureArray[0]->mFormat);
+        writer.WriteUint32((uint32_t)textureArray.size());
+        writer.WriteUint32((uint32_t)fontKeyArray.size());
+        writer.WriteUint32((uint32_t)glyphArray.size());
+        writer.WriteUint32((uint32_t)(sizeof(GlyphMetrics) / sizeof(float)));
+
+        for(i = 0; i < (uint32_t)textureArray.size(); i++)
+        {
+            TextureInfo* const pTI = textureArray[i];
+
+            writer.WriteUint32(pTI->mnSize);
+            writer.WriteUint32(pTI->mnShelfCount);
+            writer.WriteUint32(pTI->mnShelfAreaY);
+
+            for(j = 0; j < pTI->mnShelfCount; j++)
+            {
+                writer.WriteUint32(pTI->mShelfArray[j].mnY);
+                writer.WriteUint32(pTI->mShelfArray[j].mnHeight);
+                writer.WriteUint32(pTI->mShelfArray[j].mnX);
+            }
+
+            GetTextureImageLayout(pTI->mFormat, pTI->mnSize, nRowCount, nRowBytes);
+
+            if(writer.mpData)
+            {
+                const bool bLocked = (pTI->mpData == NULL);
+
+                if(bLocked && !BeginUpdate(pTI))
+                    return 0;
+
+                for(j = 0; j < nRowCount; j++)
+                    writer.WriteTextureRow(pTI->mpData + (j * pTI->mnStride), nRowBytes, pTI->mFormat);
+
+                if(bLocked)
+                    EndUpdate(pTI);
+            }
+            else
+                writer.mnSize += (nRowCount * nRowBytes);
+        }
+
+        for(i = 0; i < (uint32_t)fontKeyArray.size(); i++)
+        {
+            writer.WriteUint32(fontKeyArray[i].mnFileHash);
+            writer.WriteUint32(fontKeyArray[i].mnDescriptionHash);
+        }
+
+        for(i = 0; i < (uint32_t)glyphArray.size(); i++)
+        {
+            const PendingGlyph&     sg       = glyphArray[i];
+            const GlyphTextureInfo& gti      = sg.mGlyphEntry.mGlyphTextureInfo;
+            const float             fSize    = (float)gti.mpTextureInfo->mnSize;
+            const float*            pMetrics = &sg.mGlyphMetrics.mfSizeX;
+
+            writer.WriteUint32(sg.mnFontIndex);
+            writer.WriteUint32(sg.mGlyphId);
+            writer.WriteUint32(sg.mnSubpixelPhase);
+            writer.WriteUint32((uint32_t)(eastl::find(textureArray.begin(), textureArray.end(), gti.mpTextureInfo) - textureArray.begin()));
+            writer.WriteUint32(sg.mGlyphEntry.mnShelfIndex);
+            writer.WriteUint32((uint32_t)((gti.mX1 * fSize) + 0.5f));
+            writer.WriteUint32((uint32_t)((gti.mY1 * fSize) + 0.5f));
+            writer.WriteUint32((uint32_t)((gti.mX2 * fSize) + 0.5f));
+            writer.WriteUint32((uint32_t)((gti.mY2 * fSize) + 0.5f));
+
+            for(j = 0; j < (uint32_t)(sizeof(GlyphMetrics) / sizeof(float)); j++)
+                writer.WriteFloat(pMetrics[j]);
+        }
+
+        if(nPass || !pGlyphData || (writer.mnSize > nGlyphDataSize)) // If done or if the user only wants the size or didn't give us enough room...
+            return writer.mnSize;
+    }
 
     return 0;
 }
 
+
 ///////////////////////////////////////////////////////////////////////////////
 // SetGlyphTextureData
 //
-bool GlyphCache::SetGlyphTextureData(const void* /*pGlyphData*/, uint32_t /*nGlyphDataSize*/)
+bool GlyphCache::SetGlyphTextureData(const void* pGlyphData, uint32_t nGlyphDataSize)
 {
-    EA_FAIL_MESSAGE("GlyphCache::SetGlyphTextureData(): not implemented yet.");
+    #if EATEXT_THREAD_SAFETY_ENABLED
+        EA::Thread::AutoFutex autoMutex(mMutex);
+    #endif
 
-    return true;
+    GlyphDataReader reader(pGlyphData, nGlyphDataSize);
+    uint32_t        i, j, nRowCount, nRowBytes;
+
+    if((reader.ReadUint32() != kGlyphTextureDataMagic) || (reader.ReadUint32() != kGlyphTextureDataVersion))
+        return false;
+
+    const uint32_t nFormat       = reader.ReadUint32();
+    const uint32_t nTextureCount = reader.ReadUint32();
+    const uint32_t nFontCount    = reader.ReadUint32();
+    const uint32_t nGlyphCount   = reader.ReadUint32();
+
+    if(reader.mbError || (reader.ReadUint32() != (uint32_t)(sizeof(GlyphMetrics) / sizeof(float))) || (nTextureCount > (uint32_t)kTextureSlotCount))
+        return false;
+
+    mPendingFontKeyArray.clear();
+    mPendingGlyphArray.clear();
+
+    // Load each saved texture into the writable texture of the same index, creating it if needed. 
+    // A saved texture that doesn't match its destination's size and format is skipped.
+    TextureInfo* textureArray[kTextureSlotCount];
+    uint32_t     nWritableIndex = 0;
+
+    for(i = 0; i < nTextureCount; i++)
+    {
+        const uint32_t nSize       = reader.ReadUint32();
+        const uint32_t nShelfCount = reader.ReadUint32();
+        const uint32_t nShelfAreaY = reader.ReadUint32();
+        TextureShelf   shelfArray[kTextureShelfCountMax];
+
+        if(reader.mbError || (nShelfCount > (uint32_t)kTextureShelfCountMax) || (nShelfAreaY > nSize) || 
+           !GetTextureImageLayout(nFormat, nSize, nRowCount, nRowBytes))
+            return false;
+
+        // FindTextureShelf and TryAllocateTextureArea rely on the shelves being sorted by y without 
+        // overlapping, on 4 texel heights and on each shelf's x being within the texture.
+        uint32_t nShelfEndY = 0;
+
+        for(j = 0; j < nShelfCount; j++)
+        {
+            const uint32_t y      = reader.ReadUint32();
+            const uint32_t height = reader.ReadUint32();
+            const uint32_t x      = reader.ReadUint32();
+
+            if((y < nShelfEndY) || (y > nShelfAreaY) || (height == 0) || (height & 3) || (height > (nShelfAreaY - y)) || (x > nSize))
+                return false;
+            nShelfEndY = y + height;
+
+            shelfArray[j].mnY        = (uint16_t)y;
+            shelfArray[j].mnHeight   = (uint16_t)height;
+            shelfArray[j].mnX        = (uint16_t)x;
+            shelfArray[j].mnLastUsed = 0; // Loaded glyphs are the first to go if they aren't used.
+        }
+
+        const uint8_t* const pImage = reader.ReadBytes(nRowCount * nRowBytes);
+
+        if(!pImage)
+            return false;
+
+        TextureInfo* pTI = NULL;
+
+        while((nWritableIndex < (uint32_t)mTextureInfoArray.size()) && !mTextureInfoArray[nWritableIndex]->mbWritable)
+            nWritableIndex++;
+
+        if(nWritableIndex < (uint32_t)mTextureInfoArray.size())
+            pTI = mTextureInfoArray[nWritableIndex++];
+        else if((pTI = AddTextureInfo()) != NULL)
+            nWritableIndex = (uint32_t)mTextureInfoArray.size();
+
+        if(pTI && ((pTI->mnSize != nSize) || (pTI->mFormat != nFormat)))
+            pTI = NULL;
+
+        textureArray[i] = pTI;
+
+        if(pTI)
+        {
+            ClearTexture(pTI);
+
+            const bool bLocked = (pTI->mpData == NULL);
+
+            if(bLocked && !BeginUpdate(pTI))
+            {
+                textureArray[i] = NULL;
+                continue;
+            }
+
+            for(j = 0; j < nRowCount; j++)
+                ReadTextureRow(pTI->mpData + (j * pTI->mnStride), pImage + (j * nRowBytes), nRowBytes, nFormat);
+
+            if(bLocked)
+                EndUpdate(pTI);
+
+            memcpy(pTI->mShelfArray, shelfArray, nShelfCount * sizeof(TextureShelf));
+            pTI->mnShelfCount = nShelfCount;
+            pTI->mnShelfAreaY = nShelfAreaY;
+        }
+    }
+
+    for(i = 0; i < nFontCount; i++)
+    {
+        FontKey fontKey;
+
+        fontKey.mnFileHash        = reader.ReadUint32();
+        fontKey.mnDescriptionHash = reader.ReadUint32();
+        mPendingFontKeyArray.push_back(fontKey);
+    }
+
+    for(i = 0; i < nGlyphCount; i++)
+    {
+        PendingGlyph   pg;
+        float*         pMetrics      = &pg.mGlyphMetrics.mfSizeX;
+
+        pg.mnFontIndex              = reader.ReadUint32();
+        pg.mGlyphId                 = (GlyphId)reader.ReadUint32();
+        pg.mnSubpixelPhase          = reader.ReadUint32();
+        const uint32_t nTexture     = reader.ReadUint32();
+        pg.mGlyphEntry.mnShelfIndex = reader.ReadUint32();
+        const uint32_t x1           = reader.ReadUint32();
+        const uint32_t y1           = reader.ReadUint32();
+        const uint32_t x2           = reader.ReadUint32();
+        const uint32_t y2           = reader.ReadUint32();
+
+        for(j = 0; j < (uint32_t)(sizeof(GlyphMetrics) / sizeof(float)); j++)
+            pMetrics[j] = reader.ReadFloat();
+
+        if(reader.mbError || (pg.mnFontIndex >= nFontCount) || (pg.mnSubpixelPhase >= (uint32_t)kSubpixelPhaseCount) || (nTexture >= nTextureCount))
+        {
+            mPendingFontKeyArray.clear();
+            mPendingGlyphArray.clear();
+            return false;
+        }
+
+        TextureInfo* const pTI = textureArray[nTexture];
+
+        if(pTI && (pg.mGlyphEntry.mnShelfIndex < pTI->mnShelfCount) && (x1 <= x2) && (y1 <= y2) && (x2 <= pTI->mnSize) && (y2 <= pTI->mnSize))
+        {
+            GlyphTextureInfo& gti = pg.mGlyphEntry.mGlyphTextureInfo;
+
+            gti.mpTextureInfo = pTI;
+            gti.mX1           = x1 * pTI->mfSizeInverse;
+            gti.mY1           = y1 * pTI->mfSizeInverse;
+            gti.mX2           = x2 * pTI->mfSizeInverse;
+            gti.mY2           = y2 * pTI->mfSizeInverse;
+
+            mPendingGlyphArray.push_back(pg);
+        }
+    }
+
+    return !reader.mbError;
 }
 
 #ifdef EA_DEBUG
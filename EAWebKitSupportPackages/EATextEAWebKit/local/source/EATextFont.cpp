@@ -155,6 +155,11 @@ IO::IStream* Font::GetStream()
     return mpStream;
 }
 
+bool Font::SetGlyphMetrics(GlyphId /*glyphId*/, const GlyphMetrics& /*glyphMetrics*/)
+{
+    return false;
+}
+
 void Font::SetupSupportedScriptSet()
 {
     mSupportedScriptSet.reset();
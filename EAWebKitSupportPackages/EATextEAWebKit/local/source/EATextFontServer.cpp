@@ -311,6 +311,7 @@ bool FontServer::Shutdown()
         EA::Thread::AutoFutex autoMutex(mMutex);
     #endif
 
+    ClearFontLookupCache();
     mFaceMap.clear(); // This clear will take care of releasing any allocated font resources.
     mEffectDataList.clear(); 
 
@@ -325,6 +326,12 @@ bool FontServer::Shutdown()
 //
 void FontServer::SetOption(int32_t option, int32_t value)
 {
+    #if EATEXT_THREAD_SAFETY_ENABLED
+        EA::Thread::AutoFutex autoMutex(mMutex);
+    #endif
+
+    ClearFontLookupCache(); // Smart fallback and DPI both affect which Font GetFont would return.
+
     if(option == kOptionOpenTypeFeatures)
         mbOTFEnabled = (value != 0);
     else if(option == kOptionSmartFallback)
@@ -379,6 +386,79 @@ Font* FontServer::GetFont(const TextStyle* pTextStyle, FontSelection& fontSelect
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// GetFontLookupCharClass
+//
+// GetFont results depend on the requested char only through IsCharSupported.
+// We group chars into 128 char blocks, which is close enough to the Unicode 
+// block structure that a font supporting one char of a block almost always 
+// supports the others. ASCII gets its own class because GetFont assumes any 
+// face supports it.
+//
+static uint32_t GetFontLookupCharClass(Char c)
+{
+    if(c == kCharInvalid)
+        return 0;
+    if(c < 0x0080)
+        return 1;
+    return (uint32_t)(c >> 7) + 2;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// GetFontLookupHash
+//
+// Hashes the TextStyle fields that GetFont and GetFontDescriptionScore use,
+// along with the char class and script. This is an FNV1 hash.
+//
+static uint32_t GetFontLookupHash(const TextStyle& textStyle, uint32_t nCharClass, Script script)
+{
+    uint32_t nHash = 2166136261U;
+
+    for(uint32_t i = 0; (i < kFamilyNameArrayCapacity) && textStyle.mFamilyNameArray[i][0]; i++)
+    {
+        for(const Char* p = textStyle.mFamilyNameArray[i]; *p; ++p)
+            nHash = (nHash * 16777619) ^ (uint32_t)*p;
+        nHash = (nHash * 16777619);
+    }
+
+    const uint32_t pValueArray[] = 
+    {
+        (uint32_t)(textStyle.mfSize * 64.f), (uint32_t)textStyle.mStyle, (uint32_t)textStyle.mfWeight, 
+        (uint32_t)textStyle.mVariant, (uint32_t)textStyle.mPitch, (uint32_t)textStyle.mSmooth, textStyle.mEffect, 
+        (uint32_t)(textStyle.mfStretch * 64.f), nCharClass, (uint32_t)script
+    };
+
+    for(size_t i = 0; i < (sizeof(pValueArray) / sizeof(pValueArray[0])); i++)
+        nHash = (nHash * 16777619) ^ pValueArray[i];
+
+    return nHash;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ClearFontLookupCache
+//
+// Must be called with the mutex locked whenever the set of faces, the family 
+// substitutions or the options change.
+//
+void FontServer::ClearFontLookupCache()
+{
+    #if EATEXT_FONT_LOOKUP_CACHE_SIZE
+        for(uint32_t i = 0; i < EATEXT_FONT_LOOKUP_CACHE_SIZE; i++)
+        {
+            FontLookup& fontLookup = mFontLookupCache[i];
+
+            if(fontLookup.mpFont)
+            {
+                fontLookup.mpFont->Release(); // Matches the AddRef done when the entry was stored.
+                fontLookup.mpFont = NULL;
+            }
+        }
+    #endif
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // GetFont
 //
@@ -386,8 +466,8 @@ Font* FontServer::GetFont(const TextStyle* pTextStyle, FontSelection& fontSelect
 // As of this writing, this standard is documented at http://www.w3.org/TR/REC-CSS2/fonts.html#algorithm
 // for CSS2 and http://www.w3.org/TR/2002/WD-css3-fonts-20020802/ for CSS3.
 //
-// To do: Have the last N lookups be cached, allowing the lookup to be 
-//        immediate if the textStyle matches the cached one. 
+// Managed lookups which don't ask for the font array are remembered in 
+// mFontLookupCache, so repeated requests for a style skip the scoring below.
 //
 Font* FontServer::GetFont(const TextStyle* pTextStyle, Font* pFontArray[], uint32_t nFontArrayCapacity, 
                             Char c, Script script, bool bManaged)
@@ -416,6 +496,33 @@ Font* FontServer::GetFont(const TextStyle* pTextStyle, Font* pFontArray[], uint3
     if(nFontArrayCapacity)
         memset(pFontArray, 0, sizeof(Font*) * nFontArrayCapacity);
 
+    #if EATEXT_FONT_LOOKUP_CACHE_SIZE
+        // Unmanaged lookups create a new Font each time and array lookups want every 
+        // matching face, so only the common single managed font lookup is cached.
+        FontLookup* pFontLookup = NULL;
+        uint32_t    nCharClass  = 0;
+        uint32_t    nHash       = 0;
+
+        if(bManaged && !nFontArrayCapacity)
+        {
+            nCharClass  = GetFontLookupCharClass(c);
+            nHash       = GetFontLookupHash(*pTextStyle, nCharClass, script);
+            pFontLookup = &mFontLookupCache[nHash % EATEXT_FONT_LOOKUP_CACHE_SIZE];
+
+            if(pFontLookup->mpFont && 
+               (pFontLookup->mnHash      == nHash)      && 
+               (pFontLookup->mnCharClass == nCharClass) && 
+               (pFontLookup->mScript     == script)     && 
+               (pFontLookup->mfStretch   == pTextStyle->mfStretch) && 
+               (pFontLookup->mFontStyle  == *pTextStyle) && 
+               ((nCharClass < 2) || pFontLookup->mpFont->IsCharSupported(c, script))) // The char class is coarse, so check the char itself.
+            {
+                pFontLookup->mpFont->AddRef(); // AddRef it for the user, as the full lookup would.
+                return pFontLookup->mpFont;
+            }
+        }
+    #endif
+
     mFaceArray.clear();
 
     // Do checks for user errors.
@@ -667,6 +774,22 @@ Font* FontServer::GetFont(const TextStyle* pTextStyle, Font* pFontArray[], uint3
     // The only way we should not have at least some kind of font to offer is if we simply have no fonts.
     EA_ASSERT(pPrimaryFont || mFaceMap.empty());
 
+    #if EATEXT_FONT_LOOKUP_CACHE_SIZE
+        if(pFontLookup && pPrimaryFont)
+        {
+            pPrimaryFont->AddRef(); // AddRef it for the cache. We Release it in ClearFontLookupCache or when the entry is replaced.
+            if(pFontLookup->mpFont)
+                pFontLookup->mpFont->Release();
+
+            pFontLookup->mnHash      = nHash;
+            pFontLookup->mFontStyle  = *pTextStyle;
+            pFontLookup->mfStretch   = pTextStyle->mfStretch;
+            pFontLookup->mnCharClass = nCharClass;
+            pFontLookup->mScript     = script;
+            pFontLookup->mpFont      = pPrimaryFont;
+        }
+    #endif
+
     return pPrimaryFont; // This font will be AddRefd for the caller. Any *other* fonts in the pFontArray argument will also be AddRef'd. 
 }
 
@@ -775,6 +898,8 @@ bool FontServer::AddFaceSource(FaceSource& faceSource)
 
     bool bReturnValue = false;
 
+    ClearFontLookupCache(); // A new face may be a better match for styles we have already resolved.
+
     eastl::fixed_string<char16_t, 48> sFamily(faceSource.mFontDescription.mFamily);
 
     EA_ASSERT_FORMATTED(sFamily.length() < kFamilyNameCapacity, ("FontServer: Family name (%ls) is too long; max supported length is %d.", faceSource.mFontDescription.mFamily, (int)kFamilyNameCapacity - 1));
@@ -845,6 +970,9 @@ bool FontServer::AddFont(Font* pFont)
         pFont->AddRef(); // AddRef it for our usage of it. We will Release it when we are eventually done with it.
         faceSource.mFontList.push_back(pFont);
 
+        if(mpGlyphCacheDefault)
+            mpGlyphCacheDefault->AdoptPendingGlyphs(pFont);
+
         return AddFaceSource(faceSource);
     }
 
@@ -1203,6 +1331,10 @@ Font* FontServer::CreateNewFont(FaceSource* pFaceSource, const TextStyle& ssCSS,
 
     if(bResult)
     {
+        // Attach glyphs saved by an earlier run before the Font is first measured.
+        if(mpGlyphCacheDefault)
+            mpGlyphCacheDefault->AdoptPendingGlyphs(pFont);
+
         pFont->AddRef(); // AddRef it for the caller.
 
         if(bManaged)
@@ -1299,6 +1431,8 @@ uint32_t FontServer::RemoveFace(const char16_t* pFamilyName)
 
     uint32_t count = 0;
 
+    ClearFontLookupCache();
+
     for(FaceMap::iterator it = mFaceMap.begin(); it != mFaceMap.end(); ) // For each face family we manage (e.g. Arial)...
     {
         const Face& face = (*it).second;
@@ -1405,6 +1539,8 @@ bool FontServer::GetEffect(uint32_t effectId, const EIWord*& pInstructionList, u
             EA::Thread::AutoFutex autoMutex(mMutex);
         #endif
 
+        ClearFontLookupCache();
+
         // To do: Remove the string16 usage here and replace with eastl::fixed_string<char16_t, 32>
         eastl::string16 sFamilyLowerCase(pFamily);
         sFamilyLowerCase.make_lower();
@@ -58,6 +58,10 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     #include <EAText/EATextEffects.h>
 #endif
 
+#if EATEXT_USE_FREETYPE
+    #include FT_OUTLINE_H   // #include <freetype/ftoutln.h>
+#endif
+
 
 #define FTFontUnitsToFloat(x) (FFFixed26ToFloat(FT_MulFix((x), mpFaceData->mFTFace->size->metrics.x_scale)))
 
@@ -123,18 +127,69 @@ FaceData::FaceData(Allocator::ICoreAllocator* pCoreAllocator)
     mpCoreAllocator(pCoreAllocator),
     mRefCount(0)
 {
+    #if EATEXT_USE_FREETYPE
+        memset(mpGlyphIdPageArray, 0, sizeof(mpGlyphIdPageArray));
+    #endif
 }
 
 
 FaceData::~FaceData()
 {
     #if EATEXT_USE_FREETYPE
+        for(uint32_t i = 0; i < kGlyphIdPageCount; i++)
+        {
+            if(mpGlyphIdPageArray[i])
+                mpCoreAllocator->Free(mpGlyphIdPageArray[i]);
+        }
+
         if(mFTFace)
             FT_Done_Face(mFTFace);
      #endif
 }
 
 
+#if EATEXT_USE_FREETYPE
+
+GlyphId FaceData::GetGlyphId(uint32_t c)
+{
+    // FT_Get_Char_Index walks the charmap (a binary search for the common format 4 
+    // and 12 cmaps) on every call. Text tends to use few pages of the BMP, so we 
+    // resolve whole pages at once and answer later lookups from the table.
+    if(c < 0x10000)
+    {
+        // The font data is otherwise const at runtime, but building a page modifies the shared face.
+        #if EATEXT_THREAD_SAFETY_ENABLED
+            EA::Thread::AutoFutex autoMutex(mMutex);
+        #endif
+
+        const uint32_t nPage = (c / kGlyphIdPageSize);
+        GlyphId*       pPage = mpGlyphIdPageArray[nPage];
+
+        if(!pPage)
+        {
+            pPage = (GlyphId*)mpCoreAllocator->Alloc(kGlyphIdPageSize * sizeof(GlyphId), EATEXT_ALLOC_PREFIX "FaceData/GlyphIdPage", 0);
+
+            if(pPage)
+            {
+                const uint32_t cBase = (nPage * kGlyphIdPageSize);
+
+                for(uint32_t i = 0; i < kGlyphIdPageSize; i++)
+                    pPage[i] = (GlyphId)FT_Get_Char_Index(mFTFace, cBase + i);
+
+                mpGlyphIdPageArray[nPage] = pPage;
+            }
+        }
+
+        if(pPage)
+            return pPage[c % kGlyphIdPageSize];
+    }
+
+    return (GlyphId)FT_Get_Char_Index(mFTFace, c);
+}
+
+#endif
+
+
 int FaceData::AddRef()
 {
     EA_ASSERT(mRefCount < 5000); // Sanity check.
@@ -179,7 +234,9 @@ OutlineFont::OutlineFont(Allocator::ICoreAllocator* pCoreAllocator)
     mbUseAutoHinting(false),
     mbLCD(false),
     mpEffectsProcessor(NULL),
-    mpFaceData(NULL)
+    mpFaceData(NULL),
+    mpSubpixelBitmap(NULL),
+    mnSubpixelBitmapCapacity(0)
 {
     #if EATEXT_OPENTYPE_ENABLED
         mbOTFEnabled = false;
@@ -569,6 +626,13 @@ bool OutlineFont::Close()
         mpStream = NULL;
     }
 
+    if(mpSubpixelBitmap)
+    {
+        mpCoreAllocator->Free(mpSubpixelBitmap);
+        mpSubpixelBitmap         = NULL;
+        mnSubpixelBitmapCapacity = 0;
+    }
+
     mnRenderCount = 0;
 
     return true;
@@ -735,6 +799,19 @@ bool OutlineFont::GetGlyphMetrics(GlyphId glyphId, GlyphMetrics& glyphMetrics)
 }
 
 
+bool OutlineFont::SetGlyphMetrics(GlyphId glyphId, const GlyphMetrics& glyphMetrics)
+{
+    #if EATEXT_THREAD_SAFETY_ENABLED
+        EA_ASSERT(mpFaceData);
+        EA::Thread::AutoFutex autoMutex(mpFaceData->mMutex);
+    #endif
+
+    // insert doesn't replace metrics we have already calculated ourselves.
+    mGlyphMetricsMap.insert(GlyphMetricsMap::value_type(glyphId, glyphMetrics));
+    return true;
+}
+
+
 void OutlineFont::GetCurrentGlyphMetrics(GlyphMetrics& glyphMetrics)
 {
     // This is an internal function, so we assume the mutex is locked.
@@ -783,7 +860,7 @@ uint32_t OutlineFont::GetGlyphIds(const Char* pCharArray, uint32_t nCharArrayCou
     {
         #if EATEXT_USE_FREETYPE
              // FreeType returns 0 for a non-existing glyph. Which is a problem since it doesn't tell you if there was an error.
-            const GlyphId g = (GlyphId)FT_Get_Char_Index(mpFaceData->mFTFace, *pChar);
+            const GlyphId g = mpFaceData->GetGlyphId((uint32_t)*pChar);
 
             // Currently there is no known way to tell if FT_Get_Char_Index has failed and is returning the 0 glyph index due to an error or because it's the first glyph.
             bool bGlyphOK = (g != 0); // We can only hope that there isn't some real character at position zero.
@@ -844,7 +921,7 @@ uint32_t OutlineFont::GetGlyphIds(const char8_t* pCharArray, uint32_t nCharArray
     {
         #if EATEXT_USE_FREETYPE
              // FreeType returns 0 for a non-existing glyph. Which is a problem since it doesn't tell you if there was an error.
-            const GlyphId g = (GlyphId)FT_Get_Char_Index(mpFaceData->mFTFace, (uint8_t)*pChar);
+            const GlyphId g = mpFaceData->GetGlyphId((uint8_t)*pChar);
 
             // Currently there is no known way to tell if FT_Get_Char_Index has failed and is returning the 0 glyph index due to an error or because it's the first glyph.
             bool bGlyphOK = (g != 0); // We can only hope that there isn't some real character at position zero.
@@ -930,7 +1007,7 @@ bool OutlineFont::IsCharSupported(Char c, Script script)
 
     #if EATEXT_USE_FREETYPE
         // FreeType returns 0 for a non-existing glyph. Which is a problem since it doesn't tell you if there was an error.
-        return FT_Get_Char_Index(mpFaceData->mFTFace, c) != 0;
+        return mpFaceData->GetGlyphId((uint32_t)c) != 0;
     #endif
 }
 
@@ -950,7 +1027,7 @@ bool OutlineFont::GetKerning(GlyphId g1, GlyphId g2, Kerning& kerning, int direc
 
     #if (EATEXT_KERNING_SUPPORT > 0)
         #if EATEXT_USE_FREETYPE
-            if((mpFaceData->mFTFace->face_flags & FT_FACE_FLAG_KERNING) && (mFontMetrics.mPitch != kPitchFixed))
+            if(HasKerning())
             {
                 FT_Error nFTError = FT_Activate_Size(mFTSize);
                 EA_ASSERT(nFTError == 0); (void)nFTError;
@@ -984,6 +1061,16 @@ bool OutlineFont::GetKerning(GlyphId g1, GlyphId g2, Kerning& kerning, int direc
 }
 
 
+bool OutlineFont::HasKerning() const
+{
+    #if (EATEXT_KERNING_SUPPORT > 0) && EATEXT_USE_FREETYPE
+        return mpFaceData && mpFaceData->mFTFace && (mpFaceData->mFTFace->face_flags & FT_FACE_FLAG_KERNING) && (mFontMetrics.mPitch != kPitchFixed);
+    #else
+        return false;
+    #endif
+}
+
+
 float OutlineFont::GetSize() const
 {
     return mFontDescription.mfSize;
@@ -1304,6 +1391,8 @@ bool OutlineFont::RenderGlyphBitmap(const GlyphBitmap** pGlyphBitmap, GlyphId gl
             else
             {
                 int8_t xFraction, yFraction; // These are values from -64 to +63; +16 means a quarter pixel adjustment rightward or downward.
+                bool   bSubpixelShifted = false;
+                int    nSubpixelLeft    = 0; // Bitmap left edge of the glyph when not shifted, in pixels.
 
                 if(fXFraction)
                     xFraction = (int8_t)(fXFraction * 64.f);
@@ -1347,6 +1436,20 @@ bool OutlineFont::RenderGlyphBitmap(const GlyphBitmap** pGlyphBitmap, GlyphId gl
                         // const FT_Render_Mode renderMode = (mbLCD ? FT_RENDER_MODE_LCD : FT_RENDER_MODE_NORMAL); // FT_RENDER_MODE_NORMAL, FT_RENDER_MODE_LIGHT, FT_RENDER_MODE_MONO, FT_RENDER_MODE_LCD
                         const FT_Render_Mode renderMode = ((mFontDescription.mSmooth == kSmoothEnabled) || (mFontDescription.mEffect != kEffectNone)) ? FT_RENDER_MODE_NORMAL : FT_RENDER_MODE_MONO;
 
+                        // A fractional x position is rendered by moving the outline rightward before rasterizing it.
+                        // Only grayscale rendering can show the difference. We remember where the unmoved bitmap 
+                        // would start so that the moved bitmap can be given the same left edge below, which lets  
+                        // the caller position every variant of a glyph with the glyph's regular metrics.
+                        if((xFraction > 0) && (renderMode == FT_RENDER_MODE_NORMAL) && (mpFaceData->mFTFace->glyph->format == FT_GLYPH_FORMAT_OUTLINE))
+                        {
+                            FT_BBox cbox;
+
+                            FT_Outline_Get_CBox(&mpFaceData->mFTFace->glyph->outline, &cbox);
+                            FT_Outline_Translate(&mpFaceData->mFTFace->glyph->outline, xFraction, 0);
+                            nSubpixelLeft    = (int)(cbox.xMin >> 6); // Floor of the 26.6 value, as FreeType does for the bitmap.
+                            bSubpixelShifted = true;
+                        }
+
                         nFTError = FT_Render_Glyph(mpFaceData->mFTFace->glyph, renderMode);
                         EA_ASSERT(nFTError == 0); (void)nFTError;
                     }
@@ -1379,13 +1482,55 @@ bool OutlineFont::RenderGlyphBitmap(const GlyphBitmap** pGlyphBitmap, GlyphId gl
                             break;
                         }
                         mGlyphBitmap.mpData         = pGlyphSlot->bitmap.buffer;
+
+                        // The moved outline may start a pixel to the right of the unmoved one. If so then we copy 
+                        // it into our own buffer with blank columns on the left, back onto the unmoved left edge.
+                        const int nPadding = pGlyphSlot->bitmap_left - nSubpixelLeft;
+
+                        if(bSubpixelShifted && (nPadding > 0))
+                        {
+                            const uint32_t nWidth = mGlyphBitmap.mnWidth + (uint32_t)nPadding;
+                            const uint32_t nSize  = nWidth * mGlyphBitmap.mnHeight;
+
+                            if((nSize > mnSubpixelBitmapCapacity) && (pGlyphSlot->bitmap.pitch > 0) && (mGlyphBitmap.mBitmapFormat == kBFGrayscale))
+                            {
+                                if(mpSubpixelBitmap)
+                                    mpCoreAllocator->Free(mpSubpixelBitmap);
+                                mpSubpixelBitmap         = (uint8_t*)mpCoreAllocator->Alloc(nSize, EATEXT_ALLOC_PREFIX "OutlineFont/SubpixelBitmap", 0);
+                                mnSubpixelBitmapCapacity = mpSubpixelBitmap ? nSize : 0;
+                            }
+
+                            if(mpSubpixelBitmap && (nSize <= mnSubpixelBitmapCapacity) && (pGlyphSlot->bitmap.pitch > 0) && (mGlyphBitmap.mBitmapFormat == kBFGrayscale))
+                            {
+                                for(uint32_t y = 0; y < mGlyphBitmap.mnHeight; y++)
+                                {
+                                    uint8_t* const pRow = mpSubpixelBitmap + (y * nWidth);
+
+                                    memset(pRow, 0, (size_t)nPadding);
+                                    memcpy(pRow + nPadding, pGlyphSlot->bitmap.buffer + (y * pGlyphSlot->bitmap.pitch), mGlyphBitmap.mnWidth);
+                                }
+
+                                mGlyphBitmap.mnWidth  = nWidth;
+                                mGlyphBitmap.mnStride = nWidth;
+                                mGlyphBitmap.mpData   = mpSubpixelBitmap;
+                            }
+                            else
+                                nSubpixelLeft = pGlyphSlot->bitmap_left; // Leave the bitmap where it is and say so in its metrics.
+                        }
                     }
         
                 #endif
 
                 GetCurrentGlyphMetrics(mGlyphBitmap.mGlyphMetrics);
 
-                if(mGlyphMetricsMap.find(glyphId) == mGlyphMetricsMap.end()) // If the glyph metrics aren't already cached...
+                if(bSubpixelShifted)
+                {
+                    // Report the glyph as sitting at the unmoved position. These metrics describe this one
+                    // rendering only and so are not cached in mGlyphMetricsMap.
+                    mGlyphBitmap.mGlyphMetrics.mfSizeX     = (float)mGlyphBitmap.mnWidth;
+                    mGlyphBitmap.mGlyphMetrics.mfHBearingX = (float)nSubpixelLeft;
+                }
+                else if(mGlyphMetricsMap.find(glyphId) == mGlyphMetricsMap.end()) // If the glyph metrics aren't already cached...
                 {
                     const GlyphMetricsMap::value_type mapEntry(glyphId, mGlyphBitmap.mGlyphMetrics);
                     mGlyphMetricsMap.insert(mapEntry);
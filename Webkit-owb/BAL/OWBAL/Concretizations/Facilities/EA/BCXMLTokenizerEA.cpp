@@ -125,6 +125,9 @@ XMLTokenizer::XMLTokenizer(Document* _doc, FrameView* _view)
     : m_doc(_doc)
     , m_view(_view)
     , m_wroteText(false)
+    , m_undecodedInputState(kUndecodedInputUndecided)
+    , m_undecodedInputEncoding(EA::Internal::XML::kReadEncodingUnknown)
+    , m_inputBufferInUse(false)
     , m_currentNode(_doc)
     , m_currentNodeIsReferenced(false)
     , m_sawError(false)
@@ -156,6 +159,9 @@ XMLTokenizer::XMLTokenizer(DocumentFragment* fragment, Element* parentElement)
     : m_doc(fragment->document())
     , m_view(0)
     , m_wroteText(false)
+    , m_undecodedInputState(kUndecodedInputDisabled)
+    , m_undecodedInputEncoding(EA::Internal::XML::kReadEncodingUnknown)
+    , m_inputBufferInUse(false)
     , m_currentNode(fragment)
     , m_currentNodeIsReferenced(fragment)
     , m_sawError(false)
@@ -262,7 +268,7 @@ void XMLTokenizer::doWrite(const String& parseString)
     m_wroteText = true;
 
     if (parseString.length()) {
-        mpXmlReader->AppendInputBuffer(parseString.characters(), parseString.length() * sizeof(char16_t), EA::Internal::XML::kReadEncodingUTF16, NULL, true);
+        appendReaderInput(NULL, 0, reinterpret_cast<const char*>(parseString.characters()), parseString.length() * sizeof(char16_t), EA::Internal::XML::kReadEncodingUTF16);
         parse();
     }
 
@@ -273,6 +279,224 @@ void XMLTokenizer::doWrite(const String& parseString)
 }
 
 
+static EA::Internal::XML::ReadEncoding readEncodingForTextEncoding(const TextEncoding& encoding)
+{
+    if (encoding == UTF8Encoding())
+        return EA::Internal::XML::kReadEncodingUTF8;
+    if (encoding == UTF16LittleEndianEncoding())
+        return EA::Internal::XML::kReadEncodingUTF16LE;
+    if (encoding == UTF16BigEndianEncoding())
+        return EA::Internal::XML::kReadEncodingUTF16BE;
+    return EA::Internal::XML::kReadEncodingUnknown;
+}
+
+
+// Works out which encoding the undecoded document bytes are in, following the same precedence
+// as TextResourceDecoder: a byte order mark, then the HTTP header or user choice, then the XML
+// declaration, then the decoder's default (UTF-8 for XML). Returns kReadEncodingUnknown if that
+// is not an encoding XmlReader can read. 'bomLength' receives the size of a leading byte order mark.
+static EA::Internal::XML::ReadEncoding undecodedInputEncoding(const char* data, int len, TextResourceDecoder* decoder, int& bomLength)
+{
+    using namespace EA::Internal::XML;
+
+    bomLength = 0;
+
+    // We only get one look at the data, so don't guess from a fragment too short to hold a byte order mark.
+    if (len < 4)
+        return kReadEncodingUnknown;
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    const TextResourceDecoder::EncodingSource source = decoder->encodingSource();
+
+    if (source != TextResourceDecoder::UserChosenEncoding) {
+        if ((bytes[0] == 0xFF) && (bytes[1] == 0xFE)) {
+            if (!bytes[2] && !bytes[3])
+                return kReadEncodingUnknown; // UTF-32
+            bomLength = 2;
+            decoder->setEncoding(UTF16LittleEndianEncoding(), TextResourceDecoder::AutoDetectedEncoding);
+            return kReadEncodingUTF16LE;
+        }
+        if ((bytes[0] == 0xFE) && (bytes[1] == 0xFF)) {
+            bomLength = 2;
+            decoder->setEncoding(UTF16BigEndianEncoding(), TextResourceDecoder::AutoDetectedEncoding);
+            return kReadEncodingUTF16BE;
+        }
+        if ((bytes[0] == 0xEF) && (bytes[1] == 0xBB) && (bytes[2] == 0xBF)) {
+            bomLength = 3;
+            decoder->setEncoding(UTF8Encoding(), TextResourceDecoder::AutoDetectedEncoding);
+            return kReadEncodingUTF8;
+        }
+    }
+
+    if ((source == TextResourceDecoder::EncodingFromHTTPHeader) || (source == TextResourceDecoder::UserChosenEncoding))
+        return readEncodingForTextEncoding(decoder->encoding());
+
+    if ((len >= 5) && !strncmp(data, "<?xml", 5)) {
+        int declarationEnd = 5;
+        while ((declarationEnd + 1 < len) && ((data[declarationEnd] != '?') || (data[declarationEnd + 1] != '>')))
+            ++declarationEnd;
+        if (declarationEnd + 1 >= len)
+            return kReadEncodingUnknown; // The declaration is split across writes; leave it to the decoder.
+
+        for (int i = 5; i + 8 < declarationEnd; ++i) {
+            if (strncmp(data + i, "encoding", 8))
+                continue;
+
+            int valueStart = i + 8;
+            while ((valueStart < declarationEnd) && ((data[valueStart] == ' ') || (data[valueStart] == '=')))
+                ++valueStart;
+            if ((valueStart >= declarationEnd) || ((data[valueStart] != '"') && (data[valueStart] != '\'')))
+                return kReadEncodingUnknown;
+
+            const char quote = data[valueStart++];
+            int valueEnd = valueStart;
+            while ((valueEnd < declarationEnd) && (data[valueEnd] != quote))
+                ++valueEnd;
+            if (valueEnd >= declarationEnd)
+                return kReadEncodingUnknown;
+
+            // Like TextResourceDecoder, a UTF-16 label in an 8-bit declaration means UTF-8. The decoder
+            // is given UTF-8 too, so that the document's input encoding matches what XmlReader reads.
+            const TextEncoding declaredEncoding(String(data + valueStart, valueEnd - valueStart));
+            ReadEncoding encoding = readEncodingForTextEncoding(declaredEncoding);
+            if (encoding == kReadEncodingUnknown)
+                return kReadEncodingUnknown;
+            decoder->setEncoding(UTF8Encoding(), TextResourceDecoder::EncodingFromXMLHeader);
+            return kReadEncodingUTF8;
+        }
+    }
+
+    return readEncodingForTextEncoding(decoder->encoding());
+}
+
+
+static inline unsigned char inputByte(const char* prefix, size_t prefixLength, const char* data, size_t index)
+{
+    return static_cast<unsigned char>((index < prefixLength) ? prefix[index] : data[index - prefixLength]);
+}
+
+
+// Returns how many bytes of 'prefix' followed by 'data' make up whole characters. XmlReader treats
+// a character cut off at the end of an input buffer as an error, so the remaining bytes are held
+// back until the rest of the character arrives.
+static size_t completeCharactersLength(const char* prefix, size_t prefixLength, const char* data, size_t dataLength, EA::Internal::XML::ReadEncoding encoding)
+{
+    const size_t length = prefixLength + dataLength;
+
+    if (encoding == EA::Internal::XML::kReadEncodingUTF8) {
+        size_t leadIndex = length;
+        size_t continuationCount = 0;
+        while (leadIndex && (continuationCount < 3) && ((inputByte(prefix, prefixLength, data, leadIndex - 1) & 0xC0) == 0x80)) {
+            --leadIndex;
+            ++continuationCount;
+        }
+        if (!leadIndex)
+            return length;
+
+        const unsigned char lead = inputByte(prefix, prefixLength, data, leadIndex - 1);
+        const size_t sequenceLength = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : (lead >= 0xC0) ? 2 : 1;
+        return (continuationCount + 1 < sequenceLength) ? (leadIndex - 1) : length;
+    }
+
+    size_t complete = length & ~static_cast<size_t>(1);
+    if (complete >= 2) {
+        const unsigned first  = inputByte(prefix, prefixLength, data, complete - 2);
+        const unsigned second = inputByte(prefix, prefixLength, data, complete - 1);
+        const unsigned codeUnit = (encoding == EA::Internal::XML::kReadEncodingUTF16LE) ? (first | (second << 8)) : ((first << 8) | second);
+        if ((codeUnit >= 0xD800) && (codeUnit <= 0xDBFF)) // Lead surrogate without its trail.
+            complete -= 2;
+    }
+    return complete;
+}
+
+
+// XmlReader reads UTF-8 and UTF-16 itself, so for documents in those encodings we take the
+// response bytes as they come off the network. Going through the TextResourceDecoder would decode
+// them to UTF-16 only for the reader to decode them again.
+bool XMLTokenizer::writeUndecodedData(const char* data, int len, TextResourceDecoder* decoder)
+{
+    if (m_undecodedInputState == kUndecodedInputUndecided) {
+        #if ENABLE(XSLT)
+            // XSLT needs the decoded source text in m_originalSourceForTransform.
+            m_undecodedInputState = kUndecodedInputDisabled;
+        #else
+            int bomLength = 0;
+            m_undecodedInputEncoding = undecodedInputEncoding(data, len, decoder, bomLength);
+            m_undecodedInputState = (m_undecodedInputEncoding != EA::Internal::XML::kReadEncodingUnknown) ? kUndecodedInputEnabled : kUndecodedInputDisabled;
+
+            if (m_undecodedInputState == kUndecodedInputEnabled) {
+                data += bomLength;
+                len  -= bomLength;
+            }
+        #endif
+    }
+
+    if (m_undecodedInputState != kUndecodedInputEnabled)
+        return false;
+
+    if (m_parserStopped || (len <= 0))
+        return true;
+
+    if (m_parserPaused) {
+        m_pendingUndecodedSrc.append(data, len);
+        return true;
+    }
+
+    doWriteUndecoded(data, len);
+    return true;
+}
+
+
+void XMLTokenizer::doWriteUndecoded(const char* data, int len)
+{
+    m_wroteText = true;
+
+    // Finish any character left over from the previous write, and hold back a new partial one.
+    // A partial character is at most three bytes in either UTF-8 or UTF-16.
+    char         prefix[4];
+    const size_t prefixLength = m_partialCharacter.size();
+    ASSERT(prefixLength < sizeof(prefix));
+    memcpy(prefix, m_partialCharacter.data(), prefixLength);
+    m_partialCharacter.shrink(0);
+
+    const size_t totalLength    = prefixLength + (size_t)len;
+    const size_t completeLength = completeCharactersLength(prefix, prefixLength, data, (size_t)len, m_undecodedInputEncoding);
+
+    for (size_t i = completeLength; i < totalLength; ++i)
+        m_partialCharacter.append(static_cast<char>(inputByte(prefix, prefixLength, data, i)));
+
+    if (!completeLength)
+        return;
+
+    if (completeLength <= prefixLength)
+        appendReaderInput(prefix, completeLength, NULL, 0, m_undecodedInputEncoding);
+    else
+        appendReaderInput(prefix, prefixLength, data, completeLength - prefixLength, m_undecodedInputEncoding);
+    parse();
+}
+
+
+// Hands 'prefix' followed by 'data' to the XmlReader without it making a copy of its own.
+void XMLTokenizer::appendReaderInput(const char* prefix, size_t prefixLength, const char* data, size_t dataLength, EA::Internal::XML::ReadEncoding encoding)
+{
+    if (m_inputBufferInUse) {
+        // The reader may still be reading m_inputBuffer, so this (rare) input gets its own copy.
+        Vector<char> input;
+        input.reserveCapacity(prefixLength + dataLength);
+        input.append(prefix, prefixLength);
+        input.append(data, dataLength);
+        mpXmlReader->AppendInputBuffer(input.data(), input.size(), encoding, NULL, true);
+        return;
+    }
+
+    m_inputBuffer.shrink(0); // Keeps the capacity from earlier writes.
+    m_inputBuffer.append(prefix, prefixLength);
+    m_inputBuffer.append(data, dataLength);
+    m_inputBufferInUse = true;
+    mpXmlReader->AppendInputBuffer(m_inputBuffer.data(), m_inputBuffer.size(), encoding, NULL, false);
+}
+
+
 void XMLTokenizer::initializeParserContext(const char* /*chunk*/)
 {
     m_parserStopped   = false;
@@ -288,6 +512,13 @@ void XMLTokenizer::doEnd()
         #warning Look at XMLTokenizerLibxml2.cpp
     #endif
                                       // QT uses PrematureEndOfDocumentError here, which we need to better emulate.
+    if (!m_partialCharacter.isEmpty() && !m_parserStopped) {
+        // The document ended in the middle of a character; let the reader report it.
+        appendReaderInput(m_partialCharacter.data(), m_partialCharacter.size(), NULL, 0, m_undecodedInputEncoding);
+        m_partialCharacter.shrink(0);
+        parse();
+    }
+
     if (mpXmlReader->GetResultCode() == EA::Internal::XML::kErrorUnclosedToken || (m_wroteText && !m_sawFirstElement)) {
         handleError(fatal, "XML incomplete content error", lineNumber(), columnNumber());
     }
@@ -356,6 +587,12 @@ void XMLTokenizer::resumeParsing()
         return;
 
     // Then, write any pending data
+    if (!m_pendingUndecodedSrc.isEmpty()) {
+        Vector<char> undecodedRest;
+        undecodedRest.swap(m_pendingUndecodedSrc);
+        doWriteUndecoded(undecodedRest.data(), (int)undecodedRest.size());
+    }
+
     SegmentedString rest = m_pendingSrc;
     m_pendingSrc.clear();
     write(rest, false);
@@ -620,6 +857,11 @@ void XMLTokenizer::parse()
             }
         }
     }
+
+    // Unless we stopped early, the reader has consumed all of its input and
+    // m_inputBuffer can be refilled by the next write.
+    if (!m_parserStopped && !m_parserPaused)
+        m_inputBufferInUse = false;
 }
 
 
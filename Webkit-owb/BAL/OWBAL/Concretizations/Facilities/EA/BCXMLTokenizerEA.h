@@ -103,6 +103,9 @@ namespace WebCore {
         virtual void finish();
         virtual bool isWaitingForScripts() const;
         virtual void stopParsing();
+#if USE(UTFXML)
+        virtual bool writeUndecodedData(const char* data, int len, TextResourceDecoder*);
+#endif
 
         void end();
 
@@ -165,6 +168,10 @@ public:
 
         void doWrite(const String&);
         void doEnd();
+#if USE(UTFXML)
+        void doWriteUndecoded(const char* data, int len);
+        void appendReaderInput(const char* prefix, size_t prefixLength, const char* data, size_t dataLength, EA::Internal::XML::ReadEncoding);
+#endif
 
         Document* m_doc;
         FrameView* m_view;
@@ -177,6 +184,18 @@ public:
 #elif USE(UTFXML)
         EA::Internal::XML::IXmlReader* mpXmlReader;
         bool m_wroteText;
+
+        enum UndecodedInputState { kUndecodedInputUndecided, kUndecodedInputEnabled, kUndecodedInputDisabled };
+        UndecodedInputState m_undecodedInputState;
+        EA::Internal::XML::ReadEncoding m_undecodedInputEncoding;
+        Vector<char> m_pendingUndecodedSrc;     // Undecoded bytes received while the parser was paused.
+        Vector<char, 4> m_partialCharacter;     // Trailing bytes of a character split across two writes.
+
+        // Every buffer given to mpXmlReader is built in m_inputBuffer so its storage is reused
+        // from one write to the next. m_inputBufferInUse is set while the reader may still be
+        // reading from it (parsing paused, or a script writing to us from inside parse()).
+        Vector<char> m_inputBuffer;
+        bool m_inputBufferInUse;
 #else
         xmlParserCtxtPtr m_context;
         OwnPtr<PendingCallbacks> m_pendingCallbacks;
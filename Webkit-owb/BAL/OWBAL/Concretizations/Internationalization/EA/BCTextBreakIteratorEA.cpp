@@ -43,106 +43,141 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace OWBAL {
 
 // The sole purpose of this class is to wrap our own type of break iterator.
-// We can possibly avoid this wrapper class if we go to the header file and:
-//     typedef EA::Text::BreakIteratorBase TextBreakIterator;
-// But let's wait until we do the other modifications listed below first.
+// We keep one of these per kind of iterator, so that getting a line break iterator (e.g. during 
+// layout) doesn't reset a character break iterator which somebody is still using. Each one owns
+// a font server iterator which is pointed at the new text on every request instead of being rebuilt.
 #include <wtf/FastAllocBase.h>
 
 class TextBreakIterator/*: public WTF::FastAllocBase*/
 {
 public:
-    void* mpBreakIterator;
+    TextBreakIterator()
+        : mpBreakIterator(0), mpFontServer(0), mbOwned(false) { }
+
+    void*                    mpBreakIterator;
+    EA::WebKit::IFontServer* mpFontServer;     // The font server which mpBreakIterator belongs to.
+    bool                     mbOwned;          // If false, mpBreakIterator is one of the font server's shared iterators.
 };
 
 
-// To do: Make these no longer be static or global when we update the EATextBreak interface as discussed below. 
-static TextBreakIterator gTextBreakIterator;
+static TextBreakIterator* gpCharacterBreakIterator = 0;
+static TextBreakIterator* gpWordBreakIterator      = 0;
+static TextBreakIterator* gpLineBreakIterator      = 0;
+static TextBreakIterator* gpSentenceBreakIterator  = 0;
 
-TextBreakIterator* characterBreakIterator(const UChar* pText, int length)
+static TextBreakIterator* setUpIterator(TextBreakIterator*& pIterator, EA::WebKit::TextBreakIteratorType type, const UChar* pText, int length)
 {
     EA::WebKit::IFontServer* pServer = EA::WebKit::GetFontServer();
     if(!pServer)
         return 0;
-    gTextBreakIterator.mpBreakIterator = pServer->CharacterBreakIterator((EA::WebKit::Char *) pText, length);    
-    return &gTextBreakIterator;
+
+    if(!pIterator)
+        pIterator = new TextBreakIterator;
+
+    if(pIterator->mpFontServer != pServer) // If this is the first use or the font server was replaced...
+    {
+        pIterator->mpFontServer    = pServer;
+        pIterator->mpBreakIterator = pServer->CreateTextBreakIterator(type);
+        pIterator->mbOwned         = (pIterator->mpBreakIterator != 0);
+    }
+
+    if(pIterator->mbOwned)
+        pServer->ResetTextBreakIterator(pIterator->mpBreakIterator, (EA::WebKit::Char*) pText, length);
+    else
+    {
+        switch(type)
+        {
+            case EA::WebKit::kTextBreakIteratorCharacter:
+                pIterator->mpBreakIterator = pServer->CharacterBreakIterator((EA::WebKit::Char*) pText, length);
+                break;
+
+            case EA::WebKit::kTextBreakIteratorWord:
+                pIterator->mpBreakIterator = pServer->WordBreakIterator((EA::WebKit::Char*) pText, length);
+                break;
+
+            case EA::WebKit::kTextBreakIteratorLine:
+                pIterator->mpBreakIterator = pServer->LineBreakIterator((EA::WebKit::Char*) pText, length);
+                break;
+
+            case EA::WebKit::kTextBreakIteratorSentence:
+                pIterator->mpBreakIterator = pServer->SentenceBreakIterator((EA::WebKit::Char*) pText, length);
+                break;
+        }
+    }
+
+    return pIterator;
+}
+
+static void destroyIterator(TextBreakIterator*& pIterator)
+{
+    if(pIterator)
+    {
+        // If the font server was replaced then the iterator went away with the old one.
+        if(pIterator->mbOwned && (pIterator->mpFontServer == EA::WebKit::GetFontServer()))
+            pIterator->mpFontServer->DestroyTextBreakIterator(pIterator->mpBreakIterator);
+
+        delete pIterator;
+        pIterator = 0;
+    }
+}
+
+void staticFinalizeTextBreakIterators()
+{
+    destroyIterator(gpCharacterBreakIterator);
+    destroyIterator(gpWordBreakIterator);
+    destroyIterator(gpLineBreakIterator);
+    destroyIterator(gpSentenceBreakIterator);
+}
+
+
+TextBreakIterator* characterBreakIterator(const UChar* pText, int length)
+{
+    return setUpIterator(gpCharacterBreakIterator, EA::WebKit::kTextBreakIteratorCharacter, pText, length);
 }
 
 TextBreakIterator* wordBreakIterator(const UChar* pText, int length)
 {
-    EA::WebKit::IFontServer* pServer = EA::WebKit::GetFontServer();
-    if(!pServer)
-        return 0;
-    gTextBreakIterator.mpBreakIterator =pServer->WordBreakIterator((EA::WebKit::Char *) pText, length);
-    return &gTextBreakIterator;
+    return setUpIterator(gpWordBreakIterator, EA::WebKit::kTextBreakIteratorWord, pText, length);
 }
 
 TextBreakIterator* lineBreakIterator(const UChar* pText, int length)
 {
-    EA::WebKit::IFontServer* pServer = EA::WebKit::GetFontServer();
-    if(!pServer)
-        return 0;
-    gTextBreakIterator.mpBreakIterator =pServer->LineBreakIterator((EA::WebKit::Char *) pText, length);
-    return &gTextBreakIterator;
+    return setUpIterator(gpLineBreakIterator, EA::WebKit::kTextBreakIteratorLine, pText, length);
 }
 
 TextBreakIterator* sentenceBreakIterator(const UChar* pText, int length)
 {
-    EA::WebKit::IFontServer* pServer = EA::WebKit::GetFontServer();
-    if(!pServer)
-        return 0;
-    gTextBreakIterator.mpBreakIterator =pServer->SentenceBreakIterator((EA::WebKit::Char *) pText, length);
-    return &gTextBreakIterator;
+    return setUpIterator(gpSentenceBreakIterator, EA::WebKit::kTextBreakIteratorSentence, pText, length);
 }
 
 int textBreakFirst(TextBreakIterator* pIterator)
 {
-    // We have a problem: EATextBreak doesn't implement a pure-virtual NextBreak/PrevBreak function.
-    // It's easy to do this but it requires us to update EAText. We do something of a hack in the 
-    // short run to allow this to work now by checking each of the global variables manually.
-    EA::WebKit::IFontServer* pServer = EA::WebKit::GetFontServer();
-    if(!pServer)
-        return 0;    
-    return pServer->TextBreakFirst(gTextBreakIterator.mpBreakIterator);   
+    return pIterator->mpFontServer->TextBreakFirst(pIterator->mpBreakIterator);   
 }
 
 int textBreakNext(TextBreakIterator* pIterator)
 {
-    EA::WebKit::IFontServer* pServer = EA::WebKit::GetFontServer();
-    if(!pServer)
-        return 0;
-    return pServer->TextBreakNext(gTextBreakIterator.mpBreakIterator);
- }
+    return pIterator->mpFontServer->TextBreakNext(pIterator->mpBreakIterator);
+}
 
 int textBreakCurrent(TextBreakIterator* pIterator)
 {
-    EA::WebKit::IFontServer* pServer = EA::WebKit::GetFontServer();
-    if(!pServer)
-        return 0;
-    return pServer->TextBreakCurrent(gTextBreakIterator.mpBreakIterator);
+    return pIterator->mpFontServer->TextBreakCurrent(pIterator->mpBreakIterator);
 }
 
 int textBreakPreceding(TextBreakIterator* pIterator, int position)
 {
-    EA::WebKit::IFontServer* pServer = EA::WebKit::GetFontServer();
-    if(!pServer)
-        return 0;
-    return pServer->TextBreakPreceding(gTextBreakIterator.mpBreakIterator, position);
+    return pIterator->mpFontServer->TextBreakPreceding(pIterator->mpBreakIterator, position);
 }
 
 int textBreakFollowing(TextBreakIterator* pIterator, int position)
 {
-    EA::WebKit::IFontServer* pServer = EA::WebKit::GetFontServer();
-    if(!pServer)
-        return 0;
-    return pServer->TextBreakFollowing(gTextBreakIterator.mpBreakIterator, position);
+    return pIterator->mpFontServer->TextBreakFollowing(pIterator->mpBreakIterator, position);
 }
 
 bool isTextBreak(TextBreakIterator* pIterator, int position)
 {
-    EA::WebKit::IFontServer* pServer = EA::WebKit::GetFontServer();
-    if(!pServer)
-        return true;
-    return pServer->IsTextBreak(gTextBreakIterator.mpBreakIterator, position);  
+    return pIterator->mpFontServer->IsTextBreak(pIterator->mpBreakIterator, position);  
 }
 
 #if 0 
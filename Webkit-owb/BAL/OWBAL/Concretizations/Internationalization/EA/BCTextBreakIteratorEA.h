@@ -61,6 +61,9 @@ namespace OWBAL {
 
     const int TextBreakDone = -1;
 
+    // Frees the iterators returned above. Called on shutdown, while the font server still exists.
+    void staticFinalizeTextBreakIterators();
+
 }
 
 #endif
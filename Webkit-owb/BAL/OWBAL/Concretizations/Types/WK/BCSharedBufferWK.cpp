@@ -30,28 +30,70 @@
 #include "config.h"
 #include "SharedBuffer.h"
 
+#include <wtf/FastMalloc.h>
+
+using namespace std;
+
 namespace OWBAL {
 
+// Data that arrives incrementally is stored in fixed-size segments rather than in one
+// growing vector, so appending never has to copy what was already received. The first
+// segmentSize bytes (or whatever fits in the capacity reserved from the expected length)
+// live directly in m_buffer, which keeps small resources contiguous.
+static const unsigned segmentSize = 0x1000;
+static const unsigned segmentPositionMask = 0x0FFF;
+
+static inline unsigned segmentIndex(unsigned position)
+{
+    return position / segmentSize;
+}
+
+static inline unsigned offsetInSegment(unsigned position)
+{
+    return position & segmentPositionMask;
+}
+
+static inline char* allocateSegment()
+{
+    return static_cast<char*>(fastMalloc(segmentSize));
+}
+
+static inline void freeSegment(char* p)
+{
+    fastFree(p);
+}
+
 SharedBuffer::SharedBuffer()
+    : m_size(0)
 {
 }
 
 SharedBuffer::SharedBuffer(const char* data, int size, int expectedLength)
+    : m_size(0)
 {
-    m_buffer.reserveCapacity(expectedLength);
-	m_buffer.append(data, size);
+    if (expectedLength > size)
+        m_buffer.reserveCapacity(expectedLength);
+    append(data, size);
 }
 
 SharedBuffer::SharedBuffer(const unsigned char* data, int size, int expectedLength)
+    : m_size(0)
+{
+    if (expectedLength > size)
+        m_buffer.reserveCapacity(expectedLength);
+    append(reinterpret_cast<const char*>(data), size);
+}
+
+SharedBuffer::~SharedBuffer()
 {
-	m_buffer.reserveCapacity(expectedLength);
-	m_buffer.append(data, size);
+    freeSegments();
 }
 
 PassRefPtr<SharedBuffer> SharedBuffer::adoptVector(Vector<char>& vector)
 {
     RefPtr<SharedBuffer> buffer = create();
     buffer->m_buffer.swap(vector);
+    buffer->m_size = buffer->m_buffer.size();
     return buffer.release();
 }
 
@@ -60,7 +102,7 @@ unsigned SharedBuffer::size() const
     if (hasPlatformData())
         return platformDataSize();
     
-    return m_buffer.size();
+    return m_size;
 }
 
 const char* SharedBuffer::data() const
@@ -68,26 +110,139 @@ const char* SharedBuffer::data() const
     if (hasPlatformData())
         return platformData();
     
-    return m_buffer.data();
+    return buffer().data();
 }
 
 void SharedBuffer::append(const char* data, int len)
 {
     maybeTransferPlatformData();
-    
-    m_buffer.append(data, len);
+
+    if (len <= 0)
+        return;
+
+    unsigned length = static_cast<unsigned>(len);
+    unsigned bufferSize = m_buffer.size();
+
+    // Stay contiguous while the data fits in the first segment or in capacity that
+    // was reserved up front for a known content length.
+    if (m_segments.isEmpty() && ((m_size + length <= segmentSize) || (bufferSize + length <= m_buffer.capacity()))) {
+        m_buffer.append(data, length);
+        m_size += length;
+        return;
+    }
+
+    unsigned positionInSegment = offsetInSegment(m_size - bufferSize);
+    m_size += length;
+
+    char* segment;
+    if (!positionInSegment) {
+        segment = allocateSegment();
+        m_segments.append(segment);
+    } else
+        segment = m_segments.last() + positionInSegment;
+
+    unsigned bytesToCopy = min(length, segmentSize - positionInSegment);
+    for (;;) {
+        memcpy(segment, data, bytesToCopy);
+        if (length == bytesToCopy)
+            break;
+
+        length -= bytesToCopy;
+        data += bytesToCopy;
+        segment = allocateSegment();
+        m_segments.append(segment);
+        bytesToCopy = min(length, segmentSize);
+    }
 }
 
 void SharedBuffer::clear()
 {
     clearPlatformData();
     
+    freeSegments();
     m_buffer.clear();
+    m_size = 0;
 }
 
 PassRefPtr<SharedBuffer> SharedBuffer::copy() const
 {
-    return SharedBuffer::create(data(), size());
+    RefPtr<SharedBuffer> clone = adoptRef(new SharedBuffer);
+    if (hasPlatformData()) {
+        clone->append(data(), size());
+        return clone.release();
+    }
+
+    clone->m_size = m_size;
+    clone->m_buffer.reserveCapacity(m_size);
+    clone->m_buffer.append(m_buffer.data(), m_buffer.size());
+
+    const char* segment;
+    unsigned position = m_buffer.size();
+    while (unsigned length = getSomeData(segment, position)) {
+        clone->m_buffer.append(segment, length);
+        position += length;
+    }
+    return clone.release();
+}
+
+const Vector<char>& SharedBuffer::buffer() const
+{
+    unsigned bufferSize = m_buffer.size();
+    if (m_size > bufferSize) {
+        m_buffer.resize(m_size);
+        char* destination = m_buffer.data() + bufferSize;
+        unsigned bytesLeft = m_size - bufferSize;
+        for (unsigned i = 0; i < m_segments.size(); ++i) {
+            unsigned bytesToCopy = min(bytesLeft, segmentSize);
+            memcpy(destination, m_segments[i], bytesToCopy);
+            destination += bytesToCopy;
+            bytesLeft -= bytesToCopy;
+        }
+        ASSERT(!bytesLeft);
+        freeSegments();
+    }
+    return m_buffer;
+}
+
+unsigned SharedBuffer::getSomeData(const char*& someData, unsigned position) const
+{
+    if (hasPlatformData()) {
+        unsigned platformSize = platformDataSize();
+        if (position >= platformSize) {
+            someData = 0;
+            return 0;
+        }
+        someData = platformData() + position;
+        return platformSize - position;
+    }
+
+    if (position >= m_size) {
+        someData = 0;
+        return 0;
+    }
+
+    unsigned consecutiveSize = m_buffer.size();
+    if (position < consecutiveSize) {
+        someData = m_buffer.data() + position;
+        return consecutiveSize - position;
+    }
+
+    position -= consecutiveSize;
+    unsigned segmentedSize = m_size - consecutiveSize;
+    unsigned segments = m_segments.size();
+    unsigned segment = segmentIndex(position);
+    ASSERT(segment < segments);
+
+    unsigned positionInSegment = offsetInSegment(position);
+    someData = m_segments[segment] + positionInSegment;
+    return segment == segments - 1 ? segmentedSize - position : segmentSize - positionInSegment;
+}
+
+void SharedBuffer::freeSegments() const
+{
+    for (unsigned i = 0; i < m_segments.size(); ++i)
+        freeSegment(m_segments[i]);
+    m_segments.clear();
 }
 
 
@@ -68,9 +68,13 @@ public:
     CFDataRef createCFData();
 #endif
 
+    ~SharedBuffer();
+
+    // Calling data() or buffer() flattens the segmented storage into one contiguous
+    // buffer. Callers that can consume the bytes piecewise should use getSomeData() instead.
     const char* data() const;
     unsigned size() const;
-    const Vector<char> &buffer() { return m_buffer; }
+    const Vector<char>& buffer() const;
 
     bool isEmpty() const { return size() == 0; }
 
@@ -80,7 +84,17 @@ public:
     unsigned platformDataSize() const;
 
     PassRefPtr<SharedBuffer> copy() const;
-    
+
+    // Returns the number of consecutive bytes available at 'position' and points 'data' at them.
+    // Returns 0 once 'position' reaches size(). Typical use:
+    //     const char* segment;
+    //     unsigned position = 0;
+    //     while (unsigned length = buffer->getSomeData(segment, position)) {
+    //         consume(segment, length);
+    //         position += length;
+    //     }
+    unsigned getSomeData(const char*& data, unsigned position = 0) const;
+
 private:
     SharedBuffer();
     SharedBuffer(const char*, int, int);
@@ -89,8 +103,11 @@ private:
     void clearPlatformData();
     void maybeTransferPlatformData();
     bool hasPlatformData() const;
+    void freeSegments() const;
     
-    Vector<char> m_buffer;
+    unsigned m_size;
+    mutable Vector<char> m_buffer;      // Contiguous head of the data; grows only when flattening.
+    mutable Vector<char*> m_segments;   // Fixed-size pages holding everything past m_buffer.
 #if PLATFORM(CF)
     SharedBuffer(CFDataRef);
     RetainPtr<CFDataRef> m_cfData;
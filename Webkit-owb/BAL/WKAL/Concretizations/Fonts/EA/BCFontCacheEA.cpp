@@ -59,33 +59,27 @@ void FontCache::platformInit()
 
 const SimpleFontData* FontCache::getFontDataForCharacters(const Font& font, const UChar* characters, int length)
 {
-    // Note by Paul Pedriana (March 17, 2009): The webkit code that calls this function currently 
-    // puts the return pointer into an ever growing cache of pointers, which are deleted on shutdown.
+    // This function gets called a lot and the webkit code that calls it doesn't refcount
+    // the returned pointer. So we look the fallback font up in the per-Unicode-block
+    // fallback cache and share its SimpleFontData through getCachedFallbackFontData, which 
+    // keeps one reference per font for the lifetime of the FontCache.
     const FontDescription& fontDescription(font.fontDescription());
     const AtomicString&    fontFamily(font.family().family());
-    FontPlatformData       fontPlatformData(fontDescription, fontFamily, characters, length);
-
-    return new SimpleFontData(fontPlatformData);
-
-    // To consider: The Windows version has code somewhat like this, which we may want to use.
-    //              Are we wasting memory or something else non-optimal with the code above?
-    // Follow up:   This function gets called a lot, so indeed it is probably useful to set up
-    //              some kind of cache. The only problem is that webkit doesn't seem to refcount
-    //              the returned pointer and so returning a shared pointer makes it hard to managed
-    //              shared ownership lifetime, especially if webkit keeps multiple copies of the 
-    //              same pointer.
-    //
-    // SimpleFontData*   pSimpleFontData   = NULL;
-    // FontPlatformData* pFontPlatformData = getCachedFontPlatformData(font.fontDescription(), font.family().family());
-    // 
-    // if (pFontPlatformData)
-    // {
-    //     // getCachedFontData looks in a hashtable<FontPlatformData, SimpleFontData*> and 
-    //     // if not found then it creates new SimpleFontData(*pFontPlatformData). 
-    //     pSimpleFontData = getCachedFontData(pFontPlatformData);
-    // 
-    // }
-    // return pSimpleFontData;
+    FontPlatformData*      pFontPlatformData = getCachedFallbackFontPlatformData(fontDescription, fontFamily, characters, length);
+
+    if (!pFontPlatformData)
+        return NULL;
+
+    SimpleFontData* pSimpleFontData = getCachedFallbackFontData(pFontPlatformData);
+
+    // The block key is an approximation; if the font chosen for another character in this
+    // block can't draw these characters, match again keyed on the exact character.
+    if (pSimpleFontData && !pSimpleFontData->containsCharacters(characters, length)) {
+        pFontPlatformData = getCachedFallbackFontPlatformData(fontDescription, fontFamily, characters, length, true);
+        pSimpleFontData = pFontPlatformData ? getCachedFallbackFontData(pFontPlatformData) : NULL;
+    }
+
+    return pSimpleFontData;
 }
 
 
@@ -143,6 +137,12 @@ FontPlatformData* FontCache::createFontPlatformData(const FontDescription& fontD
 }
 
 
+FontPlatformData* FontCache::createFallbackFontPlatformData(const FontDescription& fontDescription, const AtomicString& family, const UChar* characters, int length)
+{
+    return new FontPlatformData(fontDescription, family, characters, length);
+}
+
+
 void FontCache::getTraitsInFamily(const AtomicString& familyName, Vector<unsigned>& traitsMaskArray)
 {
     // What we need to do is find all fonts that are of the given familyName and for each
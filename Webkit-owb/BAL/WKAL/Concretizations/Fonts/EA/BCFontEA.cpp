@@ -47,6 +47,12 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace WKAL {
 
 typedef Vector<EA::Raster::GlyphDrawInfo, 128> GlyphDrawInfoArray;
+typedef Vector<EA::WebKit::ITextureInfo*, 4>    GlyphTexturePageArray;
+typedef Vector<EA::WebKit::IGlyphTextureInfo, 128> GlyphTextureInfoArray;
+
+// Glyphs larger than this are always drawn pixel-aligned. The fraction of a pixel matters less 
+// the larger a glyph is, while each positioned variant costs more glyph cache space.
+const float kSubpixelGlyphSizeMax = 32.f;
 
 
 #if defined(EA_DEBUG) && defined(AUTHOR_PPEDRIANA_DISABLED)
@@ -106,20 +112,34 @@ void Font::drawGlyphs(GraphicsContext* pGraphicsContext, const SimpleFontData* p
 		NOTIFY_PROCESS_STATUS(EA::WebKit::kVProcessTypeDrawGlyph, EA::WebKit::kVProcessStatusEnded);
 		return;
 	}
-    
-    EA::WebKit::ITextureInfo*     pTI         = pGlyphCache->GetTextureInfo(0); // Right now we hard-code usage of what is the only texture.
-	EAW_ASSERT_MSG(pTI, "GlyphCache is not initialized with enough number of textures");
-	if(!pTI)
-	{
-		NOTIFY_PROCESS_STATUS(EA::WebKit::kVProcessTypeDrawGlyph, EA::WebKit::kVProcessStatusEnded);
-		return;
-	}
 
-    EA::WebKit::IGlyphTextureInfo gti;
+    // The glyphs of a run can be spread over several pages (textures) of the glyph cache. We keep
+    // one texture wrapper per page used and remember each glyph's page so pages can be drawn in turn.
     EA::WebKit::GlyphMetrics      glyphMetrics;
     GlyphDrawInfoArray              gdiArray((size_t)(unsigned)glyphCount);
+    GlyphTextureInfoArray           gtiArray((size_t)(unsigned)glyphCount);
+    GlyphTexturePageArray           pageArray;
+    Vector<int, 128>                glyphPageArray((size_t)(unsigned)glyphCount);
+    Vector<EA::WebKit::GlyphId, 128> glyphIdArray((size_t)(unsigned)glyphCount);
+    Vector<uint8_t, 128>            phaseArray((size_t)(unsigned)glyphCount);
+    Vector<EA::WebKit::GlyphId, 32> missArray;
+    Vector<uint8_t, 32>             missPhaseArray;
+    int                             pagedGlyphCount = 0;
+
+    // Smooth glyphs are drawn at the subpixel phase nearest to their pen position, if the glyph cache
+    // supports it, instead of being truncated to whole pixels. Effects are always drawn pixel-aligned.
+    const FontDescription& fd = fontDescription();
+    int   phaseCount = 1;
+    float penStart   = 0;
+
+    if((fd.getTextEffectType() == EA::WebKit::kEffectNone) && (pFont->GetSize() <= kSubpixelGlyphSizeMax) &&
+       (GetFontSmoothingStyle(fd.computedSize(), fd.weight() == FontWeightBold, fd.italic()) == EA::WebKit::kSmoothEnabled))
+    {
+        phaseCount = (int)pGlyphCache->GetSubpixelPhaseCount();
+        penStart   = point.x() - (int)point.x(); // The whole pixels are applied to rectDest below.
+    }
 
-    // Walk through the list of glyphs and build up render info for each one.
+    // Walk through the list of glyphs and position each one.
     for (int i = 0; i < glyphCount; i++)
     {
         EA::WebKit::GlyphId g = glyphs[i];
@@ -131,32 +151,37 @@ void Font::drawGlyphs(GraphicsContext* pGraphicsContext, const SimpleFontData* p
             pFont->GetGlyphMetrics(g, glyphMetrics);
         }
 
-        if(!pGlyphCache->GetGlyphTextureInfo(pFont, g, gti))
-        {
-            // 8/11/10 CSidhall - Moved this out of the draw because was directly using the **p from the passed EAText package.
-            // It has been moved to DrawGlyphBitmap() in the EAWebKitTextWrapper.h/cpp.
-            pFont->DrawGlyphBitmap(pGlyphCache, g, gti);    
-        }
+        glyphIdArray[i] = g;
+        phaseArray[i]   = 0;
 
         // Apply kerning.
         // Note by Paul Pedriana: Can we really apply kerning here at the render stage without it looking 
         // wrong? It seems to me this cannot work unless kerning is also taken into account at the 
         // layout stage. To do: See if in fact kerning is taken into account at the layout stage.
-        EA::WebKit::Kerning kerning;
-
-        if((i > 0) && pFont->GetKerning(glyphs[i - 1], g, kerning, 0))
-            offset += kerning.mfKernX;
+        // SimpleFontData caches kerning per glyph pair and skips fonts that have no kerning.
+        if(i > 0)
+            offset += pSimpleFontData->kerningForGlyphs(glyphs[i - 1], g);
 
         // The values we calculate here are relative to the current pen position at the 
         // baseline position of [xoffset, 0], where +X is rightward and +Y is upward.
-        gdiArray[i].x1 = (int)(offset + glyphMetrics.mfHBearingX);
-        gdiArray[i].x2 = (int)(offset + glyphMetrics.mfHBearingX + glyphMetrics.mfSizeX);
+        if(phaseCount > 1)
+        {
+            // Round the pen position to the nearest phase. The whole pixels go to x1 and the rest selects 
+            // the glyph variant. Variants share the regular glyph's bearing; see OutlineFont::RenderGlyphBitmap.
+            const int n     = (int)floorf(((penStart + offset) * phaseCount) + 0.5f);
+            const int pixel = (n >= 0) ? (n / phaseCount) : -((phaseCount - 1 - n) / phaseCount);
+
+            phaseArray[i]  = (uint8_t)(n - (pixel * phaseCount));
+            gdiArray[i].x1 = pixel + (int)glyphMetrics.mfHBearingX;
+            gdiArray[i].x2 = gdiArray[i].x1 + (int)glyphMetrics.mfSizeX; // Variants may be wider; see below.
+        }
+        else
+        {
+            gdiArray[i].x1 = (int)(offset + glyphMetrics.mfHBearingX);
+            gdiArray[i].x2 = (int)(offset + glyphMetrics.mfHBearingX + glyphMetrics.mfSizeX);
+        }
         gdiArray[i].y1 = (int)(glyphMetrics.mfHBearingY);
         gdiArray[i].y2 = (int)(glyphMetrics.mfHBearingY - glyphMetrics.mfSizeY);
-        gdiArray[i].u0 = gti.mX1;
-        gdiArray[i].v0 = gti.mY1;
-        gdiArray[i].u1 = gti.mX2;
-        gdiArray[i].v1 = gti.mY2;
 
         // advanceAt should return a value that is usually equivalent to glyphMetrics.mfHAdvanceX, at least 
         // for most simple Western text. A case where it would be different would be Arabic combining glyphs,
@@ -168,11 +193,90 @@ void Font::drawGlyphs(GraphicsContext* pGraphicsContext, const SimpleFontData* p
 		// to the offset in case we set this value to 0. 
 		if( (i==0) && (glyphMetrics.mfHBearingX < 0.0f))
             offset -=glyphMetrics.mfHBearingX;
+    }
+
+    // Look the whole run up in the glyph cache. The glyphs it doesn't have yet are then rendered 
+    // and added to it in one batch instead of one at a time as we come across them.
+    for (int i = 0; i < glyphCount; i++)
+    {
+        const EA::WebKit::GlyphId g     = glyphIdArray[i];
+        const uint8_t             phase = phaseArray[i];
+
+        if(!pGlyphCache->GetSubpixelGlyphTextureInfo(pFont, g, phase, gtiArray[i]))
+        {
+            size_t m = 0;
+
+            while((m < missArray.size()) && ((missArray[m] != g) || (missPhaseArray[m] != phase)))
+                ++m;
+
+            if(m == missArray.size())
+            {
+                missArray.append(g);
+                missPhaseArray.append(phase);
+            }
+        }
+    }
+
+    if(!missArray.isEmpty() && pFont->DrawGlyphBitmaps(pGlyphCache, missArray.data(), (uint32_t)missArray.size(), (phaseCount > 1) ? missPhaseArray.data() : NULL))
+    {
+        // When the cache is full, adding the misses can evict a shelf or clear a whole page, including ones 
+        // holding glyphs of this run that were found above. So the whole run is looked up again, and a glyph
+        // that is gone now is drawn one at a time below.
+        for (int i = 0; i < glyphCount; i++)
+        {
+            if(!pGlyphCache->GetSubpixelGlyphTextureInfo(pFont, glyphIdArray[i], phaseArray[i], gtiArray[i]) && gtiArray[i].mpTextureInfo)
+            {
+                gtiArray[i].mpTextureInfo->DestroyWrapper();
+                gtiArray[i].mpTextureInfo = 0;
+            }
+        }
+    }
+
+    // Walk through the list of glyphs and build up render info for each one.
+    for (int i = 0; i < glyphCount; i++)
+    {
+        const EA::WebKit::GlyphId      g   = glyphIdArray[i];
+        EA::WebKit::IGlyphTextureInfo& gti = gtiArray[i];
+
+        // Glyphs the batch above didn't add (e.g. because the font doesn't support batches) are drawn one at a time,
+        // and pixel-aligned, as DrawGlyphBitmap only renders regular glyphs.
+        if(!gti.mpTextureInfo)
+        {
+            phaseArray[i] = 0;
+
+            // 8/11/10 CSidhall - Moved this out of the draw because was directly using the **p from the passed EAText package.
+            // It has been moved to DrawGlyphBitmap() in the EAWebKitTextWrapper.h/cpp.
+            if(!pGlyphCache->GetGlyphTextureInfo(pFont, g, gti))
+                pFont->DrawGlyphBitmap(pGlyphCache, g, gti);    
+        }
+
+        // A variant's bitmap can be a pixel wider than the regular glyph's, so we take its width from the cache.
+        if(phaseArray[i] && gti.mpTextureInfo)
+            gdiArray[i].x2 = gdiArray[i].x1 + (int)(((gti.mX2 - gti.mX1) * gti.mpTextureInfo->GetSize()) + 0.5f);
+
+        gdiArray[i].u0 = gti.mX1;
+        gdiArray[i].v0 = gti.mY1;
+        gdiArray[i].u1 = gti.mX2;
+        gdiArray[i].v1 = gti.mY2;
+
+        // Find the page this glyph is on. A glyph that couldn't be cached has no page and isn't drawn.
+        glyphPageArray[i] = -1;
 
-        // Free wrapper
         if(gti.mpTextureInfo)
         {
-            gti.mpTextureInfo->DestroyWrapper();
+            void* const pPage = gti.mpTextureInfo->GetTextureInfoPointer();
+            size_t      p     = 0;
+
+            while((p < pageArray.size()) && (pageArray[p]->GetTextureInfoPointer() != pPage))
+                ++p;
+
+            if(p == pageArray.size())
+                pageArray.append(gti.mpTextureInfo); // Keep this wrapper until the page is drawn.
+            else
+                gti.mpTextureInfo->DestroyWrapper();
+
+            glyphPageArray[i] = (int)p;
+            ++pagedGlyphCount;
             gti.mpTextureInfo = 0;
         }
     }
@@ -217,7 +321,7 @@ void Font::drawGlyphs(GraphicsContext* pGraphicsContext, const SimpleFontData* p
         gdiArray[i].y2 = (destHeight + yMin) - gdiArray[i].y2;
     }
 
-    if(destWidth && destHeight)  // (If we are drawing just space chars (which often happens), then destWidth and/or destHeight will be zero)
+    if(destWidth && destHeight && !pageArray.isEmpty())  // (If we are drawing just space chars (which often happens), then destWidth and/or destHeight will be zero)
     {
         // Question by Paul Pedriana: What is the following code doing? I copied this from the 
         // WebKit Freetype equivalent of this function assuming it must be useful. It seems to 
@@ -251,10 +355,28 @@ void Font::drawGlyphs(GraphicsContext* pGraphicsContext, const SimpleFontData* p
         }
 
         EA::Raster::IEARaster* pRaster = EA::WebKit::GetEARasterInstance();
-        pRaster->DrawGlyphs(gdiArray.data(), gdiArray.size(), pTI, pSurface, rectSrc, rectDest, penColor, textTransform, pGraphicsContext->transparencyLayer(), fontDescription().getTextEffectType());
+
+        if((pageArray.size() == 1) && (pagedGlyphCount == glyphCount)) // This is by far the most common case.
+            pRaster->DrawGlyphs(gdiArray.data(), gdiArray.size(), pageArray[0], pSurface, rectSrc, rectDest, penColor, textTransform, pGraphicsContext->transparencyLayer(), fontDescription().getTextEffectType());
+        else
+        {
+            GlyphDrawInfoArray pageGdiArray;
+
+            for (size_t p = 0; p < pageArray.size(); ++p) {
+                pageGdiArray.clear();
+
+                for (int i = 0; i < glyphCount; ++i) {
+                    if (glyphPageArray[i] == (int)p)
+                        pageGdiArray.append(gdiArray[i]);
+                }
+
+                pRaster->DrawGlyphs(pageGdiArray.data(), pageGdiArray.size(), pageArray[p], pSurface, rectSrc, rectDest, penColor, textTransform, pGraphicsContext->transparencyLayer(), fontDescription().getTextEffectType());
+            }
+        }
     }
 
-    pTI->DestroyWrapper();
+    for (size_t p = 0; p < pageArray.size(); ++p)
+        pageArray[p]->DestroyWrapper();
 
 	NOTIFY_PROCESS_STATUS(EA::WebKit::kVProcessTypeDrawGlyph, EA::WebKit::kVProcessStatusEnded);
 }
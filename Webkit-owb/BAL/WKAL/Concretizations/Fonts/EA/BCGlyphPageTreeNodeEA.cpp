@@ -68,11 +68,16 @@ bool GlyphPage::fill(unsigned offset, unsigned length, UChar* buffer, unsigned b
 
         if (pFont)
         {
+            // Map the whole page in one call rather than crossing the font proxy per character.
+            // With bWriteInvalidGlyphs the output stays 1:1 with the input, writing 
+            // kGlyphIdInvalid for characters the font doesn't have.
+            EA::WebKit::GlyphId glyphIdArray[WKAL::GlyphPage::size];
+
+            pFont->GetGlyphIds(buffer, bufferLength, glyphIdArray, false, sizeof(EA::WebKit::GlyphId), true);
+
             for (unsigned i = 0; i < bufferLength; i++)
             {
-                EA::WebKit::GlyphId glyphId = EA::WebKit::kGlyphIdInvalid;
-
-                pFont->GetGlyphIds(&buffer[i], 1, &glyphId, false);
+                const EA::WebKit::GlyphId glyphId = glyphIdArray[i];
 
                 if (glyphId != EA::WebKit::kGlyphIdInvalid)
                 {
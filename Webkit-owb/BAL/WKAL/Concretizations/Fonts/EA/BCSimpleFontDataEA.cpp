@@ -52,8 +52,12 @@ void SimpleFontData::platformInit()
     EA::WebKit::IFont* const pFont = m_font.mpFont;
     EAW_ASSERT(pFont);
 
+    m_hasKerning = false;
+
 	if(pFont)
 	{
+		m_hasKerning = pFont->HasKerning();
+
 		EA::WebKit::FontMetrics fontMetrics;
 		pFont->GetFontMetrics(fontMetrics);
 
@@ -167,6 +171,29 @@ float SimpleFontData::platformWidthForGlyph(Glyph glyphId) const
 }
 
 
+float SimpleFontData::kerningForGlyphs(Glyph glyph1, Glyph glyph2) const
+{
+    if(!m_hasKerning)
+        return 0;
+
+    EA::WebKit::IFont* const pFont = m_font.mpFont;
+    EA::WebKit::Kerning kerning;
+
+    // 0 and 0xffffffff are the HashMap's empty and deleted keys, so those two pairs are simply not cached.
+    const unsigned key = ((unsigned)glyph1 << 16) | glyph2;
+    if(!key || (key == 0xffffffff))
+        return pFont->GetKerning(glyph1, glyph2, kerning, 0) ? kerning.mfKernX : 0;
+
+    KerningMap::iterator it = m_kerningMap.find(key);
+    if(it != m_kerningMap.end())
+        return it->second;
+
+    const float kernX = pFont->GetKerning(glyph1, glyph2, kerning, 0) ? kerning.mfKernX : 0;
+    m_kerningMap.set(key, kernX);
+    return kernX;
+}
+
+
 void SimpleFontData::setFont(BalFont* pFont) const
 {
     EAW_ASSERT(pFont);
@@ -38,6 +38,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FontPlatformData.h"
 #include "GlyphPageTreeNode.h"
 #include "GlyphWidthMap.h"
+#include <wtf/HashMap.h>
 #include <wtf/OwnPtr.h>
 #include <EAWebKit/EAWebKitTextInterface.h>
 
@@ -76,6 +77,9 @@ public:
     float widthForGlyph(Glyph) const;
     float platformWidthForGlyph(Glyph) const;
 
+    // Returns the horizontal kerning to apply between glyph1 and glyph2, or 0 if there is none.
+    float kerningForGlyphs(Glyph glyph1, Glyph glyph2) const;
+
     // Note by Paul Pedriana:
     // By default this function merely does 'return this'. I'm trying to understand how
     // it would go about doing anything else. Where would it go to find alternative
@@ -130,6 +134,12 @@ public:
 
     mutable GlyphWidthMap   m_glyphToWidthMap;
 
+    // Kerning is only ever needed for glyph pairs that actually occur next to each other,
+    // so we remember those by (glyph1 << 16 | glyph2) rather than building a full table.
+    typedef HashMap<unsigned, float> KerningMap;
+    mutable KerningMap      m_kerningMap;
+    bool                    m_hasKerning;       // False if the font has no kerning, in which case we never look it up.
+
     bool                    m_treatAsFixedPitch;
 
     #if ENABLE(SVG_FONTS)
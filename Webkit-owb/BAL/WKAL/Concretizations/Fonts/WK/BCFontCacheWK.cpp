@@ -40,7 +40,9 @@
 #include "FontSelector.h"
 #include "StringHash.h"
 #include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
 #include <wtf/ListHashSet.h>
+#include <wtf/unicode/Unicode.h>
 #include <EAWebKit/EAWebKitTextInterface.h>
 #include <EAWebKit/EAWebKitView.h>
 
@@ -51,7 +53,8 @@ namespace WKAL {
 
 struct FontPlatformDataCacheKey/*: public WTF::FastAllocBase*/ {
     FontPlatformDataCacheKey(const AtomicString& family = AtomicString(), unsigned size = 0, unsigned weight = 0, bool italic = false,
-        bool isPrinterFont = false, FontRenderingMode renderingMode = NormalRenderingMode, const EA::WebKit::TextEffectData* pEffectData = 0  )
+        bool isPrinterFont = false, FontRenderingMode renderingMode = NormalRenderingMode, const EA::WebKit::TextEffectData* pEffectData = 0,
+        unsigned fallbackBlock = 0)
         : m_family(family)
         , m_size(size)
         , m_weight(weight)
@@ -59,6 +62,7 @@ struct FontPlatformDataCacheKey/*: public WTF::FastAllocBase*/ {
         , m_printerFont(isPrinterFont)
         , m_renderingMode(renderingMode)
         , m_effectData()
+        , m_fallbackBlock(fallbackBlock)
     {
         if(pEffectData)
         {
@@ -78,7 +82,8 @@ struct FontPlatformDataCacheKey/*: public WTF::FastAllocBase*/ {
     {
         return equalIgnoringCase(m_family, other.m_family) && m_size == other.m_size && 
                m_weight == other.m_weight && m_italic == other.m_italic && m_printerFont == other.m_printerFont &&
-               m_renderingMode == other.m_renderingMode && m_effectData == other.m_effectData;
+               m_renderingMode == other.m_renderingMode && m_effectData == other.m_effectData &&
+               m_fallbackBlock == other.m_fallbackBlock;
     }
 
     AtomicString m_family;
@@ -88,6 +93,7 @@ struct FontPlatformDataCacheKey/*: public WTF::FastAllocBase*/ {
     bool m_printerFont;
     FontRenderingMode m_renderingMode;
     EA::WebKit::TextEffectData m_effectData;
+    unsigned m_fallbackBlock;   // 0 for regular family lookups, else the block or exact character key of a character fallback.
 private:
     static unsigned hashTableDeletedSize() { return 0xFFFFFFFFU; }
 };
@@ -103,7 +109,8 @@ inline unsigned computeHash(const FontPlatformDataCacheKey& fontKey)
         static_cast<unsigned> (fontKey.m_effectData.x),
         static_cast<unsigned> (fontKey.m_effectData.y), 
         fontKey.m_effectData.c,                         // (We can ignore tracking the blur since not used currently)
-        fontKey.m_effectData.cBase
+        fontKey.m_effectData.cBase,
+        fontKey.m_fallbackBlock
     };
     return StringImpl::computeHash(reinterpret_cast<UChar*>(hashCodes), sizeof(hashCodes) / sizeof(UChar));
 }
@@ -225,6 +232,48 @@ FontPlatformData* FontCache::getCachedFontPlatformData(const FontDescription& fo
     return result;
 }
 
+// Character fallback fonts are chosen by the font server from the characters being drawn, so
+// they are cached per Unicode block (approximated as 128 code point ranges) in addition to the
+// usual description key. The FontPlatformData lives in gFontPlatformDataCache like any other
+// and the SimpleFontData built from it is shared through getCachedFallbackFontData.
+// An exact character key is used when the block's font can't draw a character; those keys
+// start above the largest block key (0x2200) so the two never collide.
+static unsigned fallbackBlockForCharacters(const UChar* characters, int length, bool exactCharacter)
+{
+    UChar32 c = characters[0];
+    if (U16_IS_LEAD(c) && length > 1 && U16_IS_TRAIL(characters[1]))
+        c = U16_GET_SUPPLEMENTARY(c, characters[1]);
+    if (exactCharacter)
+        return static_cast<unsigned>(c) + 0x10000;
+    return (static_cast<unsigned>(c) >> 7) + 1;
+}
+
+FontPlatformData* FontCache::getCachedFallbackFontPlatformData(const FontDescription& fontDescription, 
+                                                               const AtomicString& familyName,
+                                                               const UChar* characters, int length,
+                                                               bool exactCharacter)
+{
+    if (!length)
+        return 0;
+
+    if (!gFontPlatformDataCache) {
+        gFontPlatformDataCache = new FontPlatformDataCache;
+        platformInit();
+    }
+
+    FontPlatformDataCacheKey key(familyName, fontDescription.computedPixelSize(), fontDescription.weight(), fontDescription.italic(),
+                                 fontDescription.usePrinterFont(), fontDescription.renderingMode(), &fontDescription.getTextEffectData(),
+                                 fallbackBlockForCharacters(characters, length, exactCharacter));
+    FontPlatformDataCache::iterator it = gFontPlatformDataCache->find(key);
+    if (it != gFontPlatformDataCache->end())
+        return it->second;
+
+    FontPlatformData* result = createFallbackFontPlatformData(fontDescription, familyName, characters, length);
+    if (result)
+        gFontPlatformDataCache->set(key, result);
+    return result;
+}
+
 struct FontDataCacheKeyHash/*: public WTF::FastAllocBase*/ {
     static unsigned hash(const FontPlatformData& platformData)
     {
@@ -292,6 +341,11 @@ void InactiveFontDataHashSet::clear()
 
 static InactiveFontDataHashSet* gInactiveFontData = 0;
 
+// Font data handed out by getFontDataForCharacters. System fallback glyph pages keep raw pointers
+// to it that pruneTreeFontData doesn't clear, so it must never go inactive; we hold exactly one 
+// reference per font here and gFontDataCache frees it in staticFinalize.
+static HashSet<const SimpleFontData*>* gFallbackFontData = 0;
+
 SimpleFontData* FontCache::getCachedFontData(const FontPlatformData* platformData)
 {
     if (!platformData)
@@ -322,6 +376,22 @@ SimpleFontData* FontCache::getCachedFontData(const FontPlatformData* platformDat
     return result.get()->second.first;
 }
 
+SimpleFontData* FontCache::getCachedFallbackFontData(const FontPlatformData* platformData)
+{
+    SimpleFontData* fontData = getCachedFontData(platformData);
+    if (!fontData)
+        return 0;
+
+    if (!gFallbackFontData)
+        gFallbackFontData = new HashSet<const SimpleFontData*>;
+
+    // The first lookup keeps its reference on behalf of the fallback cache; later ones give theirs back.
+    if (!gFallbackFontData->add(fontData).second)
+        releaseFontData(fontData);
+
+    return fontData;
+}
+
 void FontCache::releaseFontData(const SimpleFontData* fontData)
 {
     ASSERT(gFontDataCache);
@@ -452,6 +522,9 @@ const FontData* FontCache::getFontData(const Font& font, int& familyIndex, FontS
 //+daw ca 24/07 static and global management
 void FontCache::staticFinalize()
 {
+    delete gFallbackFontData;
+    gFallbackFontData = NULL;
+
     if(gFontDataCache) {
         // Disabled because gInactiveFontData is dependent on this leaking.
         // for(FontDataCache::iterator it(gFontDataCache->begin()), itEnd = gFontDataCache->end(); it != itEnd; ++it)
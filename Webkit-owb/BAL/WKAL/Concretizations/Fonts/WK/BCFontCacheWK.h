@@ -72,7 +72,8 @@ public:
     static void releaseFontData(const SimpleFontData*);
     
     // This method is implemented by the platform.
-    // FIXME: Font data returned by this method never go inactive because callers don't track and release them.
+    // Callers don't track and release the returned font data, so it is shared through
+    // getCachedFallbackFontData, which holds a single reference per font until staticFinalize.
     static const SimpleFontData* getFontDataForCharacters(const Font&, const UChar* characters, int length);
     
     // Also implemented by the platform.
@@ -85,7 +86,9 @@ public:
     static void getTraitsInFamily(const AtomicString&, Vector<unsigned>&);
 
     static FontPlatformData* getCachedFontPlatformData(const FontDescription&, const AtomicString& family, bool checkingAlternateName = false);
+    static FontPlatformData* getCachedFallbackFontPlatformData(const FontDescription&, const AtomicString& family, const UChar* characters, int length, bool exactCharacter = false);
     static SimpleFontData* getCachedFontData(const FontPlatformData*);
+    static SimpleFontData* getCachedFallbackFontData(const FontPlatformData*);
     static FontPlatformData* getLastResortFallbackFont(const FontDescription&);
 
     static size_t fontDataCount();
@@ -96,6 +99,7 @@ private:
     // These methods are implemented by each platform.
     static FontPlatformData* getSimilarFontPlatformData(const Font&);
     static FontPlatformData* createFontPlatformData(const FontDescription&, const AtomicString& family);
+    static FontPlatformData* createFallbackFontPlatformData(const FontDescription&, const AtomicString& family, const UChar* characters, int length);
 
     friend class SimpleFontData;
     friend class FontFallbackList;
@@ -36,6 +36,7 @@
 #include "Font.h"
 #include "FontCache.h"
 #include "SegmentedFontData.h"
+#include "StringImpl.h"
 #include <EAWebKit/EAWebkitTextInterface.h>  
 
 namespace WKAL {
@@ -56,6 +57,7 @@ void FontFallbackList::invalidate(PassRefPtr<FontSelector> fontSelector)
     m_pitch = EA::WebKit::kPitchDefault;
     m_loadingCustomFonts = false;
     m_fontSelector = fontSelector;
+    m_widthCache.clear();
 }
 
 void FontFallbackList::releaseFontData()
@@ -126,8 +128,132 @@ const FontData* FontFallbackList::fontDataForCharacters(const Font* font, const
 void FontFallbackList::setPlatformFont(const FontPlatformData& platformData)
 {
     m_familyIndex = cAllFamiliesScanned;
+    m_widthCache.clear();
     const FontData* fontData = FontCache::getCachedFontData(&platformData);
     m_fontList.append(pair<const FontData*, bool>(fontData, fontData->isCustomFont()));
 }
 
+unsigned WidthCache::s_totalEntryCount = 0;
+unsigned WidthCache::s_hitCount = 0;
+unsigned WidthCache::s_missCount = 0;
+
+WidthCache::WidthCache()
+    : m_head(0)
+    , m_tail(0)
+{
+}
+
+WidthCache::~WidthCache()
+{
+    clear();
+}
+
+unsigned WidthCache::computeHash(const UChar* characters, unsigned length, short letterSpacing, short wordSpacing, unsigned runFlags)
+{
+    unsigned hash = StringImpl::computeHash(characters, length);
+    hash ^= (static_cast<unsigned short>(letterSpacing) | (static_cast<unsigned>(static_cast<unsigned short>(wordSpacing)) << 16)) * 0x9E3779B1U;
+    hash ^= runFlags * 0x85EBCA6BU;
+
+    // 0 and -1 are the empty and deleted values of the hash map.
+    if (hash == 0 || hash == 0xFFFFFFFFU)
+        hash = 0x80000000U;
+    return hash;
+}
+
+void WidthCache::unlink(Entry* entry)
+{
+    if (entry->m_prev)
+        entry->m_prev->m_next = entry->m_next;
+    else
+        m_head = entry->m_next;
+    if (entry->m_next)
+        entry->m_next->m_prev = entry->m_prev;
+    else
+        m_tail = entry->m_prev;
+}
+
+void WidthCache::pushFront(Entry* entry)
+{
+    entry->m_prev = 0;
+    entry->m_next = m_head;
+    if (m_head)
+        m_head->m_prev = entry;
+    else
+        m_tail = entry;
+    m_head = entry;
+}
+
+bool WidthCache::lookup(const UChar* characters, unsigned length, short letterSpacing, short wordSpacing, unsigned runFlags, float& width)
+{
+    if (length > cMaxRunLength)
+        return false;
+
+    EntryMap::iterator it = m_entries.find(computeHash(characters, length, letterSpacing, wordSpacing, runFlags));
+    if (it != m_entries.end()) {
+        Entry* entry = it->second;
+        if (entry->m_length == length && entry->m_letterSpacing == letterSpacing && entry->m_wordSpacing == wordSpacing
+                && entry->m_runFlags == runFlags && !memcmp(entry->m_characters, characters, length * sizeof(UChar))) {
+            if (entry != m_head) {
+                unlink(entry);
+                pushFront(entry);
+            }
+            width = entry->m_width;
+            ++s_hitCount;
+            return true;
+        }
+    }
+
+    ++s_missCount;
+    return false;
+}
+
+void WidthCache::add(const UChar* characters, unsigned length, short letterSpacing, short wordSpacing, unsigned runFlags, float width)
+{
+    if (length > cMaxRunLength)
+        return;
+
+    unsigned hash = computeHash(characters, length, letterSpacing, wordSpacing, runFlags);
+    Entry* entry;
+
+    EntryMap::iterator it = m_entries.find(hash);
+    if (it != m_entries.end()) {
+        // Either a colliding run or the same run measured again; the newer one wins.
+        entry = it->second;
+        unlink(entry);
+    } else if (m_tail && (m_entries.size() >= cMaxEntries || s_totalEntryCount >= cMaxTotalEntries)) {
+        entry = m_tail;
+        unlink(entry);
+        m_entries.remove(entry->m_hash);
+        m_entries.set(hash, entry);
+    } else if (s_totalEntryCount < cMaxTotalEntries) {
+        entry = new Entry;
+        ++s_totalEntryCount;
+        m_entries.set(hash, entry);
+    } else
+        return;
+
+    entry->m_hash = hash;
+    entry->m_length = length;
+    entry->m_letterSpacing = letterSpacing;
+    entry->m_wordSpacing = wordSpacing;
+    entry->m_runFlags = runFlags;
+    entry->m_width = width;
+    memcpy(entry->m_characters, characters, length * sizeof(UChar));
+    pushFront(entry);
+}
+
+void WidthCache::clear()
+{
+    Entry* entry = m_head;
+    while (entry) {
+        Entry* next = entry->m_next;
+        delete entry;
+        --s_totalEntryCount;
+        entry = next;
+    }
+    m_entries.clear();
+    m_head = 0;
+    m_tail = 0;
+}
+
 }
@@ -31,6 +31,8 @@
 #include "FontSelector.h"
 #include "SimpleFontData.h"
 #include <wtf/Forward.h>
+#include <wtf/HashMap.h>
+#include <wtf/OwnPtr.h>
 #include <EAWebKit/EAWebkitTextInterface.h>
 
 namespace WKAL {
@@ -44,6 +46,55 @@ class FontSelector;
 
 const int cAllFamiliesScanned = -1;
 
+// Remembers the widths of short runs measured through the simple text path. Layout measures the
+// same words repeatedly (line breaking, min/max widths, relayout), so this avoids walking the glyph
+// pages and advances again for them. Entries are kept in least recently used order; a cache holds
+// at most cMaxEntries and all caches together at most cMaxTotalEntries, past which a cache recycles
+// its oldest entry.
+class WidthCache : Noncopyable {
+public:
+    static const unsigned cMaxRunLength = 32;
+    static const unsigned cMaxEntries = 128;
+    static const unsigned cMaxTotalEntries = 4096;
+
+    WidthCache();
+    ~WidthCache();
+
+    bool lookup(const UChar*, unsigned length, short letterSpacing, short wordSpacing, unsigned runFlags, float& width);
+    void add(const UChar*, unsigned length, short letterSpacing, short wordSpacing, unsigned runFlags, float width);
+    void clear();
+
+    static unsigned hitCount() { return s_hitCount; }
+    static unsigned missCount() { return s_missCount; }
+    static unsigned totalEntryCount() { return s_totalEntryCount; }
+
+private:
+    struct Entry {
+        unsigned m_hash;
+        unsigned m_length;
+        short m_letterSpacing;
+        short m_wordSpacing;
+        unsigned m_runFlags;
+        float m_width;
+        Entry* m_prev;
+        Entry* m_next;
+        UChar m_characters[cMaxRunLength];
+    };
+
+    static unsigned computeHash(const UChar*, unsigned length, short letterSpacing, short wordSpacing, unsigned runFlags);
+    void unlink(Entry*);
+    void pushFront(Entry*);
+
+    typedef HashMap<unsigned, Entry*> EntryMap;
+    EntryMap m_entries;
+    Entry* m_head; // Most recently used.
+    Entry* m_tail; // Least recently used.
+
+    static unsigned s_totalEntryCount;
+    static unsigned s_hitCount;
+    static unsigned s_missCount;
+};
+
 class FontFallbackList : public RefCounted<FontFallbackList> {
 public:
     static PassRefPtr<FontFallbackList> create() { return adoptRef(new FontFallbackList()); }
@@ -58,6 +109,8 @@ public:
 
     FontSelector* fontSelector() const { return m_fontSelector.get(); }
 
+    WidthCache* widthCache() const { if (!m_widthCache) m_widthCache.set(new WidthCache); return m_widthCache.get(); }
+
 private:
     FontFallbackList();
 
@@ -74,6 +127,7 @@ private:
     mutable EA::WebKit::Pitch m_pitch;
     mutable bool m_loadingCustomFonts;
     RefPtr<FontSelector> m_fontSelector;
+    mutable OwnPtr<WidthCache> m_widthCache;
 
     friend class Font;
 };
@@ -340,30 +340,6 @@ Font::~Font()
 {
 }
 
-//+ 4/22/09 CSidhall - Added lost pointer collector to fix leaks.
-// This just keeps the lost pointers till exit or flushed.  
-// So this is a somewhat temporary solution as it is really just a collector. 
-WTF::Vector<SimpleFontData*>* Font::s_pCharFontDataArray = NULL;
-
-WTF::Vector<SimpleFontData*>* Font::getSimpleFontArray()
-{
-    if(!s_pCharFontDataArray) {        
-        s_pCharFontDataArray = new WTF::Vector<SimpleFontData*>;
-        ASSERT(s_pCharFontDataArray);    
-    }
-    return s_pCharFontDataArray; 
-}
-
-void Font::staticFinalize()
-{
-    if(s_pCharFontDataArray) {
-        deleteAllValues(*s_pCharFontDataArray);
-        delete s_pCharFontDataArray;
-        s_pCharFontDataArray = NULL;
-    }
-}
-//- CS
-
 bool Font::operator==(const Font& other) const
 {
     // Our FontData don't have to be checked, since checking the font description will be fine.
@@ -504,11 +480,7 @@ const GlyphData& Font::glyphDataForCharacter(UChar32 c, bool mirror, bool forceS
 //-New code (move useMallCaps inide the pointer check and added lost pointer collection):
     if (characterFontData) {
 
-        // 4/22/09 CSidhall - We collect the lost pointers here in a list but need to addref the font pointer
-        WTF::Vector<SimpleFontData*>* pArray = getSimpleFontArray();
-        if(pArray) {
-            pArray->append( (SimpleFontData*) characterFontData);
-        }
+        // The fallback font data is owned by the FontCache now, so it no longer goes in the lost pointer collector.
         if (useSmallCapsFont) {  // CS - Moved inside pointer check: if (characterFontData)     
             characterFontData = characterFontData->smallCapsFontData(m_fontDescription);
             // CS - We don't need to addref the font here for it was already done in smallCapsFontData FontPlatformData new
@@ -783,8 +755,27 @@ float Font::floatWidth(const TextRun& run, int extraCharsAvailable, int& charsCo
 
 float Font::floatWidthForSimpleText(const TextRun& run, GlyphBuffer* glyphBuffer) const
 {
+    // Plain measurement of short runs goes through the fallback list's width cache. Runs with
+    // padding or tabs depend on more than their characters and are always measured.
+    WidthCache* widthCache = 0;
+    unsigned runFlags = 0;
+    if (!glyphBuffer && run.length() <= (int)WidthCache::cMaxRunLength && !run.padding() && !run.allowTabs()
+            && m_fontList && !m_fontList->loadingCustomFonts()) {
+        widthCache = m_fontList->widthCache();
+        runFlags = (run.rtl() ? 0x01 : 0) | (run.directionalOverride() ? 0x02 : 0) | (run.applyRunRounding() ? 0x04 : 0)
+                 | (run.applyWordRounding() ? 0x08 : 0) | (run.spacingDisabled() ? 0x10 : 0);
+
+        float width;
+        if (widthCache->lookup(run.characters(), run.length(), m_letterSpacing, m_wordSpacing, runFlags, width))
+            return width;
+    }
+
     WidthIterator it(this, run);
     it.advance(run.length(), glyphBuffer);
+
+    // Measuring may have started a web font load, in which case the width is only provisional.
+    if (widthCache && !m_fontList->loadingCustomFonts())
+        widthCache->add(run.characters(), run.length(), m_letterSpacing, m_wordSpacing, runFlags, it.m_runWidthSoFar);
     return it.m_runWidthSoFar;
 }
 
@@ -154,11 +154,6 @@ public:
     Font();
     Font(const FontDescription&, short letterSpacing, short wordSpacing);
 
-    // 4/22/09 CSidhall - Added for lost pointer collection of SimpleFontData to fix leaks
-    static WTF::Vector<SimpleFontData*>* s_pCharFontDataArray;
-    static void staticFinalize();
-    static WTF::Vector<SimpleFontData*>* getSimpleFontArray();
-
 #if !PLATFORM(QT)
     Font(const FontPlatformData&, bool isPrinting); // This constructor is only used if the platform wants to start with a native font.
 #endif
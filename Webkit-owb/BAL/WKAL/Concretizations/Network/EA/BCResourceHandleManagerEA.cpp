@@ -80,6 +80,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <EAWebKit/internal/EAWebKitViewHelper.h> // For multiview support
 #include "WebError.h"
 #include <EAWebKit/internal/EAWebKitLog.h>
+#include <kjs/TokenCache.h>
 
 #ifdef GetJob // If windows.h has #defined GetJob to GetJobA...
     #undef GetJob
@@ -88,6 +89,37 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace Local
 {
+    // Lets the JavaScript parser keep the tokens of large external scripts beside them in the disk cache.
+    class FileCacheTokenClient : public KJS::TokenCacheClient
+    {
+    public:
+        virtual bool loadTokens(const KJS::UString& sourceURL, WTF::Vector<char>& data)
+        {
+            EA::WebKit::FixedString8_128 key;
+            GetKey(sourceURL, key);
+            return WebCore::ResourceHandleManager::sharedInstance()->ReadScriptTokens(key, data);
+        }
+
+        virtual void storeTokens(const KJS::UString& sourceURL, const WTF::Vector<char>& data)
+        {
+            EA::WebKit::FixedString8_128 key;
+            GetKey(sourceURL, key);
+            WebCore::ResourceHandleManager::sharedInstance()->WriteScriptTokens(key, data);
+        }
+
+    private:
+        // Same key the file cache uses for the resource itself: the URI, converted to 8 bit.
+        static void GetKey(const KJS::UString& sourceURL, EA::WebKit::FixedString8_128& key)
+        {
+            EA::WebKit::FixedString16_128 url16;
+            url16.assign(sourceURL.data(), sourceURL.size());
+            EA::WebKit::ConvertToString8(url16, key);
+        }
+    };
+
+    FileCacheTokenClient sFileCacheTokenClient;
+
+
     void ConvertWebCoreStr16ToEAString8(const WebCore::String& s16, EA::WebKit::FixedString8_128& s8)
     {
         uint32_t s16Len = s16.length()+1;       //webcore strings do not include the NULL terminator
@@ -248,6 +280,8 @@ ResourceHandleManager::~ResourceHandleManager()
     RemoveTransportHandlers();
 
     //Nicki Vankoughnett:  TransportHandlerFileCache is not added as a transport handler directly due to the special nature of the cache.
+    if(KJS::TokenStream::client() == &Local::sFileCacheTokenClient)
+        KJS::TokenStream::setClient(NULL);
     m_THFileCache.Shutdown(NULL);
     m_AuthenticationManager.Shutdown();
     m_cookieManager.Shutdown();
@@ -1739,7 +1773,21 @@ void ResourceHandleManager::ClearDiskCache()
 
 bool ResourceHandleManager::UseFileCache(bool enabled) 
 {
-    return m_THFileCache.UseFileCache(enabled);
+    const bool bResult = m_THFileCache.UseFileCache(enabled);
+    KJS::TokenStream::setClient(m_THFileCache.CacheEnabled() ? &Local::sFileCacheTokenClient : NULL);
+    return bResult;
+}
+
+
+bool ResourceHandleManager::ReadScriptTokens(const EA::WebKit::FixedString8_128& url, WTF::Vector<char>& data)
+{
+    return m_THFileCache.ReadScriptTokens(url, data);
+}
+
+
+bool ResourceHandleManager::WriteScriptTokens(const EA::WebKit::FixedString8_128& url, const WTF::Vector<char>& data)
+{
+    return m_THFileCache.WriteScriptTokens(url, data);
 }
 
 
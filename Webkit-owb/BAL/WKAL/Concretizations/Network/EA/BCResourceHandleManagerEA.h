@@ -166,6 +166,8 @@ public:
     bool                            SetCacheDirectory(const char8_t* pCacheDirectory);
     void                            GetCacheDirectory(EA::WebKit::FixedString8_128& cacheDirectory);
     void                            GetCacheDirectory(EA::WebKit::FixedString16_128& cacheDirectory);
+    bool                            ReadScriptTokens(const EA::WebKit::FixedString8_128& url, WTF::Vector<char>& data);
+    bool                            WriteScriptTokens(const EA::WebKit::FixedString8_128& url, const WTF::Vector<char>& data);
 
     void                            SetMaxCacheSize(uint32_t nCacheSize);
     uint32_t                        GetMaxCacheSize();
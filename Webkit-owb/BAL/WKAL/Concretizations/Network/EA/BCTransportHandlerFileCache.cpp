@@ -93,6 +93,8 @@ const char8_t*   kCacheLineEntry                       = "Cache Entry:";      //
 const char8_t*   kCacheChecksum                        = "Cache Checksum:";   // Each line
 const char16_t*  kCachedFileExtension                  = L".cache";
 const char16_t*  kSearchCachedFileExtension            = L"*.cache";          // This should work on all platforms
+const char16_t*  kScriptTokensFileExtension            = L".jst";             // Appended to the cached file name of a script
+const char16_t*  kSearchScriptTokensFileExtension      = L"*.jst";
 const int32_t    kMaxTransferLoops                     = 100;                 // Just a timeout safety which would limit the read loops in a frame for a file    
 const double     kMaxTransferLoopTime                  = (1.0/60.0);          // Timeout for large file read loops  
 const uint32_t   kMinAgeToCache                        = 1;                   // 1 second age min consider caching. 
@@ -925,7 +927,16 @@ void TransportHandlerFileCache::CacheToDisk(const EA::WebKit::FixedString16_128&
     newInfo.mnTimeTimeout  = newInfo.mnTimeCreated;
     newInfo.msCachedFileName = uriFNameStr.c_str();
     newInfo.msMIMEContentType = mimeStr;
-    newInfo.mnChecksum = GetByteChecksum(requestData.data(), requestData.size(), 0);
+    // Walk the buffer segments directly rather than flattening the whole resource.
+    const char* pSegment;
+    uint32_t position = 0;
+    uint32_t checksum = 0;
+    while(uint32_t segmentLength = requestData.getSomeData(pSegment, position))
+    {
+        checksum = GetByteChecksum(pSegment, (int32_t) segmentLength, checksum);
+        position += segmentLength;
+    }
+    newInfo.mnChecksum = checksum;
 
     bool validName = false;
     
@@ -954,7 +965,16 @@ void TransportHandlerFileCache::CacheToDisk(const EA::WebKit::FixedString16_128&
         {
             if(pFS->OpenFile(fileInfo.mFileObject, pathStr.c_str(), FileSystem::kWrite))
             {
-                bSuccess = pFS->WriteFile(fileInfo.mFileObject, requestData.data(), requestData.size());
+                bSuccess = true;
+                position = 0;
+                while(bSuccess)
+                {
+                    const uint32_t segmentLength = requestData.getSomeData(pSegment, position);
+                    if(!segmentLength)
+                        break;
+                    bSuccess = pFS->WriteFile(fileInfo.mFileObject, pSegment, segmentLength);
+                    position += segmentLength;
+                }
                 pFS->CloseFile(fileInfo.mFileObject);
 
                 if(bSuccess)
@@ -1274,6 +1294,91 @@ bool TransportHandlerFileCache::GetCachedDataValidity( const EA::WebKit::FixedSt
     return false;
 }
 
+bool TransportHandlerFileCache::ReadScriptTokens(const EA::WebKit::FixedString8_128& url, WTF::Vector<char>& data)
+{
+    THREAD_SAFE_CALL;
+
+    if(!mbEnabled)
+        return false;
+
+    DataMap::iterator it = mDataMap.find(url);
+    if((it == mDataMap.end()) || !((*it).second.mnLocation & kCacheLocationDisk))
+        return false;
+
+    EA::WebKit::FixedString8_128 path8;
+    GetScriptTokensPath((*it).second.msCachedFileName.c_str(), path8);
+
+    FileSystem* pFS = GetFileSystem();
+    int64_t fileSize = 0;
+    if(!pFS || !pFS->FileExists(path8.c_str()) || !pFS->GetFileSize(path8.c_str(), fileSize))
+        return false;
+    if((fileSize <= 0) || (fileSize > kMaxPracticalFileSize))
+        return false;
+
+    bool bSuccess = false;
+    FileSystem::FileObject fileObject = pFS->CreateFileObject();
+    if(fileObject != FileSystem::kFileObjectInvalid)
+    {
+        if(pFS->OpenFile(fileObject, path8.c_str(), FileSystem::kRead))
+        {
+            data.resize((size_t) fileSize);
+            bSuccess = (pFS->ReadFile(fileObject, data.data(), fileSize) == fileSize);
+            pFS->CloseFile(fileObject);
+        }
+        pFS->DestroyFileObject(fileObject);
+    }
+
+    if(!bSuccess)
+        data.clear();
+    return bSuccess;
+}
+
+bool TransportHandlerFileCache::WriteScriptTokens(const EA::WebKit::FixedString8_128& url, const WTF::Vector<char>& data)
+{
+    THREAD_SAFE_CALL;
+
+    if(!mbEnabled || data.isEmpty() || (data.size() > kMaxPracticalFileSize))
+        return false;
+
+    // Only scripts that made it into the disk cache get tokens; pending entries may still be abandoned.
+    DataMap::iterator it = mDataMap.find(url);
+    if((it == mDataMap.end()) || ((*it).second.mnLocation != kCacheLocationDisk))
+        return false;
+
+    EA::WebKit::FixedString8_128 path8;
+    GetScriptTokensPath((*it).second.msCachedFileName.c_str(), path8);
+
+    FileSystem* pFS = GetFileSystem();
+    if(!pFS)
+        return false;
+
+    bool bSuccess = false;
+    FileSystem::FileObject fileObject = pFS->CreateFileObject();
+    if(fileObject != FileSystem::kFileObjectInvalid)
+    {
+        if(pFS->OpenFile(fileObject, path8.c_str(), FileSystem::kWrite))
+        {
+            bSuccess = pFS->WriteFile(fileObject, data.data(), data.size());
+            pFS->CloseFile(fileObject);
+        }
+        pFS->DestroyFileObject(fileObject);
+    }
+
+    if(!bSuccess)
+        pFS->RemoveFile(path8.c_str());    // Don't leave a truncated file behind.
+    return bSuccess;
+}
+
+void TransportHandlerFileCache::GetScriptTokensPath(const char16_t* pFileName, EA::WebKit::FixedString8_128& path8) const
+{
+    EA::IO::Path::PathString16 sFilePath(msCacheDirectory.c_str());
+    EA::IO::Path::Join(sFilePath, pFileName);
+    sFilePath += kScriptTokensFileExtension;
+
+    EA::WebKit::FixedString16_128 path16(sFilePath.c_str()); 
+    EA::WebKit::ConvertToString8(path16, path8);
+}
+
 bool TransportHandlerFileCache::GetCachedDataValidity( const Info& cacheInfo )
 {
     if(!mbEnabled)
@@ -1602,6 +1707,7 @@ bool TransportHandlerFileCache::RemoveCachedFile(const char16_t* pFileName)
         FileSystem* pFS = GetFileSystem();
         if(pFS)
         {
+            RemoveScriptTokensFile(pFileName);
             --sCurFileCount;
             return (pFS->RemoveFile(path8.c_str()) );
         }
@@ -1610,6 +1716,19 @@ bool TransportHandlerFileCache::RemoveCachedFile(const char16_t* pFileName)
     return false;
 }
 
+bool TransportHandlerFileCache::RemoveScriptTokensFile(const char16_t* pFileName)
+{
+    // Takes the cached file name the tokens belong to. Most cached files have none.
+    EA::WebKit::FixedString8_128 path8;
+    GetScriptTokensPath(pFileName, path8);
+
+    FileSystem* pFS = GetFileSystem();
+    if(pFS && pFS->FileExists(path8.c_str()))
+        return pFS->RemoveFile(path8.c_str());
+
+    return false;
+}
+
 bool TransportHandlerFileCache::RemoveUnusedCachedFiles()
 {
     // Thread-safety not implemented here, as this is only called from init.
@@ -1637,6 +1756,32 @@ bool TransportHandlerFileCache::RemoveUnusedCachedFiles()
         }
     }
 
+    // Script tokens whose cached file is gone. These are not counted as cached files.
+    entryList.clear();
+    if(directoryIterator.Read(msCacheDirectory.c_str(), entryList, kSearchScriptTokensFileExtension, EA::IO::kDirectoryEntryFile))
+    {
+        const EA::IO::size_type extensionLength = EA::Internal::Strlen(kScriptTokensFileExtension);
+
+        for(EA::IO::DirectoryIterator::EntryList::iterator it = entryList.begin(); it != entryList.end(); ++it)
+        {
+            const EA::IO::DirectoryIterator::Entry& entry = *it;
+            if(entry.msName.length() <= extensionLength)
+                continue;
+
+            EA::WebKit::FixedString16_128 cachedFileName(entry.msName.c_str(), entry.msName.length() - extensionLength);
+            DataMap::iterator itMap = mDataMap.begin();
+
+            for(; itMap != mDataMap.end(); ++itMap)
+            {
+                if(EA::Internal::Stricmp((*itMap).second.msCachedFileName.c_str(), cachedFileName.c_str()) == 0)
+                    break;
+            }
+
+            if(itMap == mDataMap.end())
+                RemoveScriptTokensFile(cachedFileName.c_str());
+        }
+    }
+
     return true;
 }
 
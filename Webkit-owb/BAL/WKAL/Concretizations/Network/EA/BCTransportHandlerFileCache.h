@@ -43,6 +43,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "config.h"
 #include <wtf/FastAllocBase.h>
+#include <wtf/Vector.h>
 
 #include <EAWebKit/EAWebKit.h>
 #include <EAWebKit/EAWebKitTransport.h>
@@ -174,6 +175,11 @@ namespace EA
             bool GetCachedDataValidity( const FixedString16_128& url );
             bool GetCachedDataValidity( const FixedString8_128& url );
 
+            // Pre-lexed JavaScript for a cached script. It is stored in a file beside the cached resource 
+            // and goes away with it; the data carries its own validation (see KJS::TokenStream).
+            bool ReadScriptTokens(const FixedString8_128& url, WTF::Vector<char>& data);
+            bool WriteScriptTokens(const FixedString8_128& url, const WTF::Vector<char>& data);
+
             static int32_t GetOpenFileCount() { return sOpenFileCount; } 
             static int32_t GetOpenJobCount() { return sOpenJobCount; } 
             static int32_t GetFileCount() { return sCurFileCount; } 
@@ -236,6 +242,8 @@ namespace EA
 
             bool GetNewCacheFileName( int nMIMEType, int nMIMESubtype, FixedString16_128& sFileName);
             bool RemoveCachedFile(const char16_t* pFileName);
+            bool RemoveScriptTokensFile(const char16_t* pFileName);
+            void GetScriptTokensPath(const char16_t* pFileName, FixedString8_128& path8) const;
             bool RemoveUnusedCachedFiles();
             void DoPeriodicCacheMaintenance();
             DataMap::iterator FindLRUItem (); // oldest item in location
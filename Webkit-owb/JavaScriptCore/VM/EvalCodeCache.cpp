@@ -0,0 +1,113 @@
+/*
+Copyright (C) 2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "EvalCodeCache.h"
+
+#include "ExecState.h"
+#include "JSGlobalObject.h"
+#include "Parser.h"
+#include "debugger.h"
+#include "nodes.h"
+
+namespace KJS {
+
+static bool isCacheable(ExecState* exec, int sourceLength)
+{
+    // The debugger needs to see every source it steps through.
+    return sourceLength < EvalCodeCache::MaxCacheableSourceLength && !exec->dynamicGlobalObject()->debugger();
+}
+
+// The parameter list length keeps "a)b" + "c" and "a" + "b)c" apart.
+static UString functionKey(const UString& parameters, const UString& body)
+{
+    return UString::from(parameters.size()) + "(" + parameters + ")" + body;
+}
+
+// Makes room for one more entry. Which entry goes does not matter much; hot sources come back.
+template<typename Map> static void makeRoom(Map& map)
+{
+    if (map.size() >= EvalCodeCache::MaxCacheEntries)
+        map.remove(map.begin());
+}
+
+EvalCodeCache::EvalCodeCache()
+{
+}
+
+EvalCodeCache::~EvalCodeCache()
+{
+}
+
+PassRefPtr<EvalNode> EvalCodeCache::get(ExecState* exec, const UString& source, int* sourceId, int* errLine, UString* errMsg)
+{
+    bool cacheable = isCacheable(exec, source.size());
+    if (cacheable) {
+        if (EvalNode* evalNode = m_evalNodes.get(source.rep()).get())
+            return evalNode;
+    }
+
+    RefPtr<EvalNode> evalNode = exec->parser()->parse<EvalNode>(exec, UString(), 1, UStringSourceProvider::create(source), sourceId, errLine, errMsg);
+    if (evalNode && cacheable && !evalNode->needsClosure()) {
+        makeRoom(m_evalNodes);
+        m_evalNodes.set(source.rep(), evalNode);
+    }
+    return evalNode.release();
+}
+
+FunctionBodyNode* EvalCodeCache::getFunctionBody(ExecState* exec, const UString& parameters, const UString& body) const
+{
+    if (!isCacheable(exec, parameters.size() + body.size()))
+        return 0;
+    return m_functionBodies.get(functionKey(parameters, body).rep()).get();
+}
+
+void EvalCodeCache::addFunctionBody(ExecState* exec, const UString& parameters, const UString& body, FunctionBodyNode* functionBody)
+{
+    if (!isCacheable(exec, parameters.size() + body.size()))
+        return;
+    makeRoom(m_functionBodies);
+    m_functionBodies.set(functionKey(parameters, body).rep(), functionBody);
+}
+
+void EvalCodeCache::mark()
+{
+    // Eval code blocks register themselves with the global object, which marks them.
+    // Cached function bodies may outlive every function made from them.
+    FunctionBodyMap::iterator end = m_functionBodies.end();
+    for (FunctionBodyMap::iterator it = m_functionBodies.begin(); it != end; ++it)
+        it->second->mark();
+}
+
+void EvalCodeCache::clear()
+{
+    m_evalNodes.clear();
+    m_functionBodies.clear();
+}
+
+} // namespace KJS
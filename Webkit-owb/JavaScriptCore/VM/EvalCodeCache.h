@@ -0,0 +1,76 @@
+/*
+Copyright (C) 2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef EvalCodeCache_h
+#define EvalCodeCache_h
+
+#include "ustring.h"
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/RefPtr.h>
+
+namespace KJS {
+
+    class EvalNode;
+    class ExecState;
+    class FunctionBodyNode;
+
+    // Parsed and compiled code for eval() and the Function constructor, keyed by source text, so
+    // that pages which eval the same strings over and over (JSON, templating libraries) only parse
+    // them once. Owned and marked by a JSGlobalObject, and flushed when it is destroyed.
+    //
+    // Only code that means the same thing wherever it runs is cached. Eval code never resolves
+    // names statically, but functions nested in it are compiled against the scope chain they are
+    // first called in, so evals that declare or contain functions are not cached. Function
+    // constructor bodies always close over the global scope, so they are.
+    class EvalCodeCache : Noncopyable {
+    public:
+        enum { MaxCacheableSourceLength = 1024, MaxCacheEntries = 64 };
+
+        EvalCodeCache();
+        ~EvalCodeCache();
+
+        PassRefPtr<EvalNode> get(ExecState*, const UString& source, int* sourceId, int* errLine, UString* errMsg);
+
+        FunctionBodyNode* getFunctionBody(ExecState*, const UString& parameters, const UString& body) const;
+        void addFunctionBody(ExecState*, const UString& parameters, const UString& body, FunctionBodyNode*);
+
+        void mark();
+        void clear();
+
+    private:
+        typedef HashMap<RefPtr<UString::Rep>, RefPtr<EvalNode> > EvalMap;
+        typedef HashMap<RefPtr<UString::Rep>, RefPtr<FunctionBodyNode> > FunctionBodyMap;
+
+        EvalMap m_evalNodes;
+        FunctionBodyMap m_functionBodies;
+    };
+
+} // namespace KJS
+
+#endif // EvalCodeCache_h
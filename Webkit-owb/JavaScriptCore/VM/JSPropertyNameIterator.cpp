@@ -45,27 +45,27 @@ COMPILE_ASSERT(sizeof(JSPropertyNameIterator) <= CellSize<sizeof(void*)>::m_valu
 JSPropertyNameIterator* JSPropertyNameIterator::create(ExecState* exec, JSValue* v)
 {
     if (v->isUndefinedOrNull())
-        return new (exec) JSPropertyNameIterator(0, 0, 0);
+        return new (exec) JSPropertyNameIterator(0, 0);
 
     JSObject* o = v->toObject(exec);
-    PropertyNameArray propertyNames(exec);
-    o->getPropertyNames(exec, propertyNames);
-    size_t numProperties = propertyNames.size();
-    return new (exec) JSPropertyNameIterator(o, propertyNames.releaseIdentifiers(), numProperties);
+    return new (exec) JSPropertyNameIterator(o, o->propertyNamesForEnumeration(exec));
 }
 
-JSPropertyNameIterator::JSPropertyNameIterator(JSObject* object, Identifier* propertyNames, size_t numProperties)
+JSPropertyNameIterator::JSPropertyNameIterator(JSObject* object, PassRefPtr<PropertyNameArrayData> data)
     : m_object(object)
-    , m_propertyNames(propertyNames)
-    , m_position(propertyNames)
-    , m_end(propertyNames + numProperties)
+    , m_data(data)
+    , m_position(0)
+    , m_end(0)
 {
+    if (m_data) {
+        m_position = m_data->propertyNameVector().begin();
+        m_end = m_data->propertyNameVector().end();
+    }
 }
 
 JSPropertyNameIterator::~JSPropertyNameIterator()
 {
-    invalidate();               // 4/20/09 CSidhall - Call to clean up m_propertyNames (delete does not clean up the array in this case)
-    //delete m_propertyNames;
+    invalidate();
 }
 
 JSType JSPropertyNameIterator::type() const
@@ -129,23 +129,11 @@ JSValue* JSPropertyNameIterator::next(ExecState* exec)
 
 void JSPropertyNameIterator::invalidate()
 {
-    // 4/20/09 CSidhall - Leak fix.
-    // The identifier buffer was actually copied from a vector array and then set the m_size of that array 0 (so destructors not called).
-    // The delete here cleaned up the full memory buffer but only called the destructor on the first element in the original array, leaving
-    // the others to leak...
-    if(m_propertyNames) {
-        for( Identifier *it = m_propertyNames; it < m_end; it++)
-        {
-            it->~Identifier();
-        }
-        fastFree(m_propertyNames);
-        m_end = 0;
-    }
-    // Old code used a delete:
-    //delete m_propertyNames;
-
+    // The name list may be shared with the enumeration cache, so just drop our reference to it.
     m_object = 0;
-    m_propertyNames = 0;
+    m_data = 0;
+    m_position = 0;
+    m_end = 0;
 }
 
 } // namespace KJS
@@ -30,11 +30,13 @@
 #define JSPropertyNameIterator_h
 
 #include "JSValue.h"
+#include <wtf/RefPtr.h>
 
 namespace KJS {
 
     class Identifier;
     class JSObject;
+    class PropertyNameArrayData;
 
     class JSPropertyNameIterator : public JSCell {
     public:
@@ -56,12 +58,12 @@ namespace KJS {
         void invalidate();
 
     private:
-        JSPropertyNameIterator(JSObject*, Identifier* propertyNames, size_t numProperties);
+        JSPropertyNameIterator(JSObject*, PassRefPtr<PropertyNameArrayData>);
 
         JSObject* m_object;
-        Identifier* m_propertyNames;
-        Identifier* m_position;
-        Identifier* m_end;
+        RefPtr<PropertyNameArrayData> m_data;
+        const Identifier* m_position;
+        const Identifier* m_end;
     };
 
 } // namespace KJS
@@ -106,6 +106,13 @@ static int depth(ScopeChain& sc)
     return scopeDepth;
 }
 
+// Exact class check, so that subclasses overriding property access (ArrayPrototype,
+// RegExpMatchesArray) keep going through the virtual get and put.
+static inline bool isJSArray(JSValue* v)
+{
+    return !JSImmediate::isImmediate(v) && static_cast<JSCell*>(v)->classInfo() == &JSArray::info;
+}
+
 static inline bool jsLess(ExecState* exec, JSValue* v1, JSValue* v2)
 {
     if (JSImmediate::areBothImmediateNumbers(v1, v2))
@@ -173,8 +180,8 @@ static inline JSValue* jsAdd(ExecState* exec, JSValue* v1, JSValue* v2)
     if (bothTypes == ((NumberType << 3) | NumberType))
         return jsNumber(exec, v1->uncheckedGetNumber() + v2->uncheckedGetNumber());
     if (bothTypes == ((StringType << 3) | StringType)) {
-        UString value = static_cast<JSString*>(v1)->value() + static_cast<JSString*>(v2)->value();
-        if (value.isNull())
+        JSStringRope::Fiber value = static_cast<JSString*>(v1)->fiber();
+        if (!JSStringRope::concatenate(value, static_cast<JSString*>(v2)->fiber()))
             return throwOutOfMemoryError(exec);
         return jsString(exec, value);
     }
@@ -468,7 +475,7 @@ NEVER_INLINE JSValue* callEval(ExecState* exec, JSObject* thisObj, ScopeChainNod
     int sourceId;
     int errLine;
     UString errMsg;
-    RefPtr<EvalNode> evalNode = exec->parser()->parse<EvalNode>(exec, UString(), 1, UStringSourceProvider::create(static_cast<JSString*>(program)->value()), &sourceId, &errLine, &errMsg);
+    RefPtr<EvalNode> evalNode = scopeChain->globalObject()->evalCodeCache().get(exec, static_cast<JSString*>(program)->value(), &sourceId, &errLine, &errMsg);
 
     if (!evalNode) {
         exceptionValue = Error::create(exec, SyntaxError, errMsg, errLine, sourceId, NULL);
@@ -1893,9 +1900,14 @@ JSValue* Machine::privateExecute(ExecutionFlag flag, ExecState* exec, RegisterFi
         JSValue* subscript = r[property].u.jsValue;
         JSValue* result;
         uint32_t i;
-        if (subscript->getUInt32(i))
+        if (subscript->getUInt32(i)) {
+            if (isJSArray(baseValue) && static_cast<JSArray*>(baseValue)->canGetIndex(i)) {
+                r[dst].u.jsValue = static_cast<JSArray*>(baseValue)->getIndex(i);
+                ++vPC;
+                NEXT_OPCODE;
+            }
             result = baseValue->get(exec, i);
-        else {
+        } else {
             JSObject* baseObj = baseValue->toObject(exec); // may throw
         
             Identifier property;
@@ -1934,9 +1946,14 @@ JSValue* Machine::privateExecute(ExecutionFlag flag, ExecState* exec, RegisterFi
         JSValue* subscript = r[property].u.jsValue;
 
         uint32_t i;
-        if (subscript->getUInt32(i))
+        if (subscript->getUInt32(i)) {
+            if (isJSArray(baseValue) && static_cast<JSArray*>(baseValue)->canSetIndex(i)) {
+                static_cast<JSArray*>(baseValue)->setIndex(i, r[value].u.jsValue);
+                ++vPC;
+                NEXT_OPCODE;
+            }
             baseValue->put(exec, i, r[value].u.jsValue);
-        else {
+        } else {
             JSObject* baseObj = baseValue->toObject(exec);
 
             Identifier property;
@@ -285,6 +285,9 @@ JSValue* arrayProtoFuncPop(ExecState* exec, JSObject*, JSValue* thisValue, const
 {
     JSObject* thisObj = thisValue->toThisObject(exec);
     JSValue* result = 0;
+    if (thisObj->classInfo() == &JSArray::info && static_cast<JSArray*>(thisObj)->popDense(result))
+        return result;
+
     unsigned length = thisObj->get(exec, exec->propertyNames().length)->toUInt32(exec);
     if (length == 0) {
         thisObj->put(exec, exec->propertyNames().length, jsNumber(exec, length));
@@ -300,6 +303,9 @@ JSValue* arrayProtoFuncPop(ExecState* exec, JSObject*, JSValue* thisValue, const
 JSValue* arrayProtoFuncPush(ExecState* exec, JSObject*, JSValue* thisValue, const ArgList& args)
 {
     JSObject* thisObj = thisValue->toThisObject(exec);
+    if (thisObj->classInfo() == &JSArray::info && static_cast<JSArray*>(thisObj)->pushDense(exec, args))
+        return jsNumber(exec, static_cast<JSArray*>(thisObj)->getLength());
+
     unsigned length = thisObj->get(exec, exec->propertyNames().length)->toUInt32(exec);
     for (unsigned n = 0; n < args.size(); n++)
         thisObj->put(exec, length + n, args[n]);
@@ -336,6 +342,8 @@ JSValue* arrayProtoFuncShift(ExecState* exec, JSObject*, JSValue* thisValue, con
 {
     JSObject* thisObj = thisValue->toThisObject(exec);
     JSValue* result = 0;
+    if (thisObj->classInfo() == &JSArray::info && static_cast<JSArray*>(thisObj)->shiftDense(result))
+        return result;
 
     unsigned length = thisObj->get(exec, exec->propertyNames().length)->toUInt32(exec);
     if (length == 0) {
@@ -478,6 +486,13 @@ JSValue* arrayProtoFuncSplice(ExecState* exec, JSObject*, JSValue* thisValue, co
     else
         deleteCount = length - begin;
 
+    if (thisObj->classInfo() == &JSArray::info) {
+        ArgList items;
+        args.getSlice(2, items);
+        if (static_cast<JSArray*>(thisObj)->spliceDense(exec, begin, deleteCount, items, resObj))
+            return result;
+    }
+
     for (unsigned k = 0; k < deleteCount; k++) {
         if (JSValue* v = getProperty(exec, thisObj, k + begin))
             resObj->put(exec, k, v);
@@ -0,0 +1,117 @@
+/*
+Copyright (C) 2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "CollectorPolicy.h"
+
+#include "SystemTime.h"
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+namespace KJS {
+
+// Collections may take up to this share of the time between them before the threshold is
+// stretched to follow the allocation rate, and are stretched by at most kMaxRateScale.
+static const double kTargetPauseRatio = 0.1;
+static const double kMaxRateScale = 4.0;
+
+static size_t sMemoryBudget = 0;
+
+void CollectorPolicy::setMemoryBudget(size_t bytes)
+{
+    sMemoryBudget = bytes;
+}
+
+size_t CollectorPolicy::memoryBudget()
+{
+    return sMemoryBudget;
+}
+
+CollectorPolicy::CollectorPolicy()
+    : m_collectionStartTime(0.0)
+    , m_lastCollectionEndTime(0.0)
+    , m_pauseRatio(0.0)
+{
+}
+
+void CollectorPolicy::willCollect()
+{
+    m_collectionStartTime = OWBAL::currentTime();
+}
+
+void CollectorPolicy::didCollect(size_t heapBytes, size_t liveBytes, size_t bytesFreed)
+{
+    const double endTime = OWBAL::currentTime();
+    const double pause = max(endTime - m_collectionStartTime, 0.0);
+    const double mutatorTime = m_collectionStartTime - m_lastCollectionEndTime;
+
+    // The first collection has nothing to measure against.
+    if (m_lastCollectionEndTime == 0.0)
+        m_pauseRatio = 0.0;
+    else
+        m_pauseRatio = mutatorTime > 0.0 ? pause / mutatorTime : kMaxRateScale * kTargetPauseRatio;
+    m_lastCollectionEndTime = endTime;
+
+    m_statistics.collectionCount++;
+    m_statistics.lastPauseSeconds = pause;
+    m_statistics.maxPauseSeconds = max(m_statistics.maxPauseSeconds, pause);
+    m_statistics.totalPauseSeconds += pause;
+    m_statistics.lastBytesFreed = bytesFreed;
+    m_statistics.totalBytesFreed += bytesFreed;
+    m_statistics.heapBytes = heapBytes;
+    m_statistics.liveBytes = liveBytes;
+    m_statistics.memoryBudget = sMemoryBudget;
+}
+
+size_t CollectorPolicy::nextThreshold(size_t cellsBefore, size_t cellsAfter, size_t newCells, size_t cellSize) const
+{
+    // Half the survivors when the collection freed nearly everything, up to one and a half times
+    // them when it freed nothing; the old fixed policy sits at a 50% survival rate.
+    const double survival = cellsBefore ? static_cast<double>(cellsAfter) / cellsBefore : 1.0;
+    double threshold = cellsAfter * (0.5 + survival);
+
+    // At the current allocation rate, waiting for newCells * scale allocations spreads collections
+    // out far enough to bring the pause ratio back to the target.
+    if (m_pauseRatio > kTargetPauseRatio)
+        threshold = max(threshold, newCells * min(m_pauseRatio / kTargetPauseRatio, kMaxRateScale));
+
+    // The budget is a trigger, not a hard limit: a heap whose live cells already exceed it still
+    // grows, but it is collected as often as the minimum threshold allows. The headroom is shared
+    // by the cell and number heaps, so each is offered half of it.
+    if (sMemoryBudget) {
+        const size_t headroom = sMemoryBudget > m_statistics.liveBytes ? sMemoryBudget - m_statistics.liveBytes : 0;
+        threshold = min(threshold, static_cast<double>(headroom / 2 / cellSize));
+    }
+
+    const size_t result = static_cast<size_t>(threshold);
+    return result > minimumThreshold ? result : minimumThreshold;
+}
+
+} // namespace KJS
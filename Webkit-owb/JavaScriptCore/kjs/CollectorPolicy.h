@@ -0,0 +1,99 @@
+/*
+Copyright (C) 2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CollectorPolicy_h
+#define CollectorPolicy_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <wtf/Noncopyable.h>
+
+namespace KJS {
+
+    // Numbers reported to the host after each collection. Byte counts cover both the cell heap and
+    // the number heap; they do not include memory owned by cells, such as string buffers.
+    struct CollectorStatistics {
+        size_t collectionCount;
+        double lastPauseSeconds;
+        double maxPauseSeconds;
+        double totalPauseSeconds;
+        size_t lastBytesFreed;
+        uint64_t totalBytesFreed;
+        size_t heapBytes;   // Bytes held in collector blocks after the last collection.
+        size_t liveBytes;   // Bytes in cells that survived the last collection.
+        size_t memoryBudget;
+
+        CollectorStatistics()
+            : collectionCount(0)
+            , lastPauseSeconds(0.0)
+            , maxPauseSeconds(0.0)
+            , totalPauseSeconds(0.0)
+            , lastBytesFreed(0)
+            , totalBytesFreed(0)
+            , heapBytes(0)
+            , liveBytes(0)
+            , memoryBudget(0)
+        {
+        }
+    };
+
+    // Decides how many allocations each collector heap may make before the next collection.
+    // The old trigger waited for as many new cells as had survived the last collection. Here the
+    // multiplier follows the survival rate (a heap of long-lived objects gains little from being
+    // swept often), the threshold is raised when collections are eating too large a share of the
+    // time between them given the current allocation rate, and the whole is capped so that the
+    // live heap plus the allowance stays within the host's memory budget.
+    class CollectorPolicy : Noncopyable {
+    public:
+        static const size_t minimumThreshold = 4000;
+
+        CollectorPolicy();
+
+        void willCollect();
+        void didCollect(size_t heapBytes, size_t liveBytes, size_t bytesFreed);
+
+        // cellsBefore and cellsAfter are the heap's live cells either side of the sweep, newCells
+        // the allocations and extra cost charged to it since the previous collection.
+        size_t nextThreshold(size_t cellsBefore, size_t cellsAfter, size_t newCells, size_t cellSize) const;
+
+        const CollectorStatistics& statistics() const { return m_statistics; }
+
+        // 0 means unlimited. Set from EA::WebKit::Parameters::mJavaScriptHeapBudget.
+        static void setMemoryBudget(size_t bytes);
+        static size_t memoryBudget();
+
+    private:
+        double m_collectionStartTime;
+        double m_lastCollectionEndTime;
+        double m_pauseRatio; // Last pause over the time spent running script since the collection before it.
+        CollectorStatistics m_statistics;
+    };
+
+} // namespace KJS
+
+#endif // CollectorPolicy_h
@@ -64,23 +64,8 @@ CallType FunctionConstructor::getCallData(CallData& callData)
     return CallTypeNative;
 }
 
-// ECMA 15.3.2 The Function Constructor
-JSObject* constructFunction(ExecState* exec, const ArgList& args, const Identifier& functionName, const UString& sourceURL, int lineNumber)
+static PassRefPtr<FunctionBodyNode> parseFunctionBody(ExecState* exec, const UString& p, const UString& body, const UString& sourceURL, int lineNumber)
 {
-    UString p("");
-    UString body;
-    int argsSize = args.size();
-    if (argsSize == 0)
-        body = "";
-    else if (argsSize == 1)
-        body = args[0]->toString(exec);
-    else {
-        p = args[0]->toString(exec);
-        for (int k = 1; k < argsSize - 1; k++)
-            p += "," + args[k]->toString(exec);
-        body = args[argsSize - 1]->toString(exec);
-    }
-
     // parse the source code
     int sourceId;
     int errLine;
@@ -89,15 +74,13 @@ JSObject* constructFunction(ExecState* exec, const ArgList& args, const Identifi
     RefPtr<FunctionBodyNode> functionBody = exec->parser()->parse<FunctionBodyNode>(exec, sourceURL, lineNumber, source, &sourceId, &errLine, &errMsg);
 
     // No program node == syntax error - throw a syntax error
-    if (!functionBody)
+    if (!functionBody) {
         // We can't return a Completion(Throw) here, so just set the exception
-        // and return it
-        return throwError(exec, SyntaxError, errMsg, errLine, sourceId, sourceURL);
+        throwError(exec, SyntaxError, errMsg, errLine, sourceId, sourceURL);
+        return 0;
+    }
     
     functionBody->setSource(SourceRange(source, 0, source->length()));
-    ScopeChain scopeChain(exec->lexicalGlobalObject(), exec->globalThisValue());
-
-    JSFunction* function = new (exec) JSFunction(exec, functionName, functionBody.get(), scopeChain.node());
 
     // parse parameter list. throw syntax error on illegal identifiers
     int len = p.size();
@@ -127,9 +110,46 @@ JSObject* constructFunction(ExecState* exec, const ArgList& args, const Identifi
                 continue;
             } // else error
         }
-        return throwError(exec, SyntaxError, "Syntax error in parameter list");
+        throwError(exec, SyntaxError, "Syntax error in parameter list");
+        return 0;
     }
-  
+
+    return functionBody.release();
+}
+
+// ECMA 15.3.2 The Function Constructor
+JSObject* constructFunction(ExecState* exec, const ArgList& args, const Identifier& functionName, const UString& sourceURL, int lineNumber)
+{
+    UString p("");
+    UString body;
+    int argsSize = args.size();
+    if (argsSize == 0)
+        body = "";
+    else if (argsSize == 1)
+        body = args[0]->toString(exec);
+    else {
+        p = args[0]->toString(exec);
+        for (int k = 1; k < argsSize - 1; k++)
+            p += "," + args[k]->toString(exec);
+        body = args[argsSize - 1]->toString(exec);
+    }
+
+    // Bodies with a source URL come from WebCore (event handler attributes) and carry their
+    // location for the debugger and profiler; only anonymous ones are shared.
+    EvalCodeCache& codeCache = exec->lexicalGlobalObject()->evalCodeCache();
+    bool useCodeCache = sourceURL.isNull();
+    RefPtr<FunctionBodyNode> functionBody = useCodeCache ? codeCache.getFunctionBody(exec, p, body) : 0;
+    if (!functionBody) {
+        functionBody = parseFunctionBody(exec, p, body, sourceURL, lineNumber);
+        if (!functionBody)
+            return static_cast<JSObject*>(exec->exception());
+        if (useCodeCache)
+            codeCache.addFunctionBody(exec, p, body, functionBody.get());
+    }
+
+    ScopeChain scopeChain(exec->lexicalGlobalObject(), exec->globalThisValue());
+    JSFunction* function = new (exec) JSFunction(exec, functionName, functionBody.get(), scopeChain.node());
+
     JSObject* prototype = constructEmptyObject(exec);
     prototype->putDirect(exec->propertyNames().constructor, function, DontEnum);
     function->putDirect(exec->propertyNames().prototype, prototype, DontDelete);
@@ -28,7 +28,11 @@
 #include "JSArray.h"
 
 #include "ArrayPrototype.h"
+#include "CodeBlock.h"
+#include "JSString.h"
+#include "Machine.h"
 #include "PropertyNameArray.h"
+#include <algorithm>
 #include <wtf/AVLTree.h>
 #include <wtf/Assertions.h>
 #include <wtf/FastAllocBase.h>
@@ -39,48 +43,6 @@ using namespace std;
 
 namespace KJS {
 
-typedef HashMap<unsigned, JSValue*> SparseArrayValueMap;
-
-struct ArrayStorage {
-public:
-#if NO_MACRO_NEW
-	// Placement operator new.
-void* operator new(size_t, void* p) { return p; }
-void* operator new[](size_t, void* p) { return p; }
- 
-void* operator new(size_t size)
-{
-     void* p = fastMalloc(size);
-     fastMallocMatchValidateMalloc(p, WTF::Internal::AllocTypeClassNew);
-     return p;
-}
- 
-void operator delete(void* p)
-{
-     fastMallocMatchValidateFree(p, WTF::Internal::AllocTypeClassNew);
-     fastFree(p);  // We don't need to check for a null pointer; the compiler does this.
-}
- 
-void* operator new[](size_t size)
-{
-     void* p = fastMalloc(size);
-     fastMallocMatchValidateMalloc(p, WTF::Internal::AllocTypeClassNewArray);
-     return p;
-}
- 
-void operator delete[](void* p)
-{
-     fastMallocMatchValidateFree(p, WTF::Internal::AllocTypeClassNewArray);
-     fastFree(p);  // We don't need to check for a null pointer; the compiler does this.
-}
-#endif //NO_MACRO_NEW
-unsigned m_vectorLength;
-    unsigned m_numValuesInVector;
-    SparseArrayValueMap* m_sparseValueMap;
-    void* lazyCreationData; // An JSArray subclass can use this to fill the vector lazily.
-    JSValue* m_vector[1];
-};
-
 // 0xFFFFFFFF is a bit weird -- is not an array index even though it's an integer.
 static const unsigned maxArrayIndex = 0xFFFFFFFEU;
 
@@ -100,6 +62,22 @@ static inline size_t storageSize(unsigned vectorLength)
     return sizeof(ArrayStorage) - sizeof(JSValue*) + vectorLength * sizeof(JSValue*);
 }
 
+// shiftDense does not move the remaining values down; it slides the header up over the vacated
+// slot instead. The allocation therefore starts m_indexBias slots before the header.
+static inline void* storageBase(ArrayStorage* storage)
+{
+    return reinterpret_cast<JSValue**>(storage) - storage->m_indexBias;
+}
+
+static inline ArrayStorage* reallocateStorage(ArrayStorage* storage, unsigned newVectorLength)
+{
+    unsigned indexBias = storage->m_indexBias;
+    JSValue** base = static_cast<JSValue**>(fastRealloc(storageBase(storage), storageSize(newVectorLength + indexBias)));
+    if (!base)
+        return 0;
+    return reinterpret_cast<ArrayStorage*>(base + indexBias);
+}
+
 static inline unsigned increasedVectorLength(unsigned newLength)
 {
     return (newLength * 3 + 1) / 2;
@@ -145,7 +123,9 @@ JSArray::JSArray(JSObject* prototype, const ArgList& list)
 
     storage->m_vectorLength = length;
     storage->m_numValuesInVector = length;
+    storage->m_indexBias = 0;
     storage->m_sparseValueMap = 0;
+    storage->lazyCreationData = 0;
 
     size_t i = 0;
     ArgList::const_iterator end = list.end();
@@ -165,7 +145,7 @@ JSArray::~JSArray()
     checkConsistency(DestructorConsistencyCheck);
 
     delete m_storage->m_sparseValueMap;
-    fastFree(m_storage);
+    fastFree(storageBase(m_storage));
 }
 
 JSValue* JSArray::lengthGetter(ExecState* exec, const Identifier&, const PropertySlot& slot)
@@ -337,7 +317,7 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue* val
         }
     }
 
-    storage = static_cast<ArrayStorage*>(fastRealloc(storage, storageSize(newVectorLength)));
+    storage = reallocateStorage(storage, newVectorLength);
 
     unsigned vectorLength = storage->m_vectorLength;
     if (newNumValuesInVector == storage->m_numValuesInVector + 1) {
@@ -448,9 +428,24 @@ bool JSArray::increaseVectorLength(unsigned newLength)
     ASSERT(newLength > vectorLength);
     unsigned newVectorLength = increasedVectorLength(newLength);
 
-    storage = static_cast<ArrayStorage*>(fastRealloc(storage, storageSize(newVectorLength)));
-    if (!storage)
-        return false;
+    // Give back the slots left in front of the vector by shiftDense before asking for more memory.
+    unsigned capacity = vectorLength;
+    if (unsigned indexBias = storage->m_indexBias) {
+        ArrayStorage* base = static_cast<ArrayStorage*>(storageBase(storage));
+        memmove(base, storage, storageSize(vectorLength));
+        storage = base;
+        storage->m_indexBias = 0;
+        m_storage = storage;
+        capacity += indexBias;
+        if (newLength <= capacity)
+            newVectorLength = capacity;
+    }
+
+    if (newVectorLength > capacity) {
+        storage = static_cast<ArrayStorage*>(fastRealloc(storage, storageSize(newVectorLength)));
+        if (!storage)
+            return false;
+    }
 
     storage->m_vectorLength = newVectorLength;
 
@@ -500,6 +495,133 @@ void JSArray::setLength(unsigned newLength)
     checkConsistency();
 }
 
+bool JSArray::pushDense(ExecState*, const ArgList& values)
+{
+    if (!isDense())
+        return false;
+
+    unsigned length = m_length;
+    unsigned count = values.size();
+    if (count > maxArrayIndex - length)
+        return false;
+
+    unsigned newLength = length + count;
+    if (newLength > m_storage->m_vectorLength && !increaseVectorLength(newLength))
+        return false;
+
+    checkConsistency();
+
+    ArrayStorage* storage = m_storage;
+    ArgList::const_iterator end = values.end();
+    for (ArgList::const_iterator it = values.begin(); it != end; ++it)
+        storage->m_vector[length++] = *it;
+    storage->m_numValuesInVector += count;
+
+    m_length = newLength;
+    m_fastAccessCutoff = newLength;
+
+    checkConsistency();
+    return true;
+}
+
+bool JSArray::popDense(JSValue*& result)
+{
+    if (!isDense())
+        return false;
+
+    checkConsistency();
+
+    if (!m_length) {
+        result = jsUndefined();
+        return true;
+    }
+
+    ArrayStorage* storage = m_storage;
+    unsigned newLength = m_length - 1;
+    result = storage->m_vector[newLength];
+    storage->m_vector[newLength] = 0;
+    --storage->m_numValuesInVector;
+
+    m_length = newLength;
+    m_fastAccessCutoff = newLength;
+
+    checkConsistency();
+    return true;
+}
+
+bool JSArray::shiftDense(JSValue*& result)
+{
+    if (!isDense())
+        return false;
+
+    checkConsistency();
+
+    if (!m_length) {
+        result = jsUndefined();
+        return true;
+    }
+
+    // Rather than moving every remaining value down one slot, move the header up one slot over the
+    // value being removed. This makes repeated shifts O(1); increaseVectorLength reclaims the space.
+    ArrayStorage* storage = m_storage;
+    result = storage->m_vector[0];
+
+    ArrayStorage* newStorage = reinterpret_cast<ArrayStorage*>(reinterpret_cast<JSValue**>(storage) + 1);
+    memmove(newStorage, storage, storageSize(0));
+    ++newStorage->m_indexBias;
+    --newStorage->m_vectorLength;
+    --newStorage->m_numValuesInVector;
+
+    m_storage = newStorage;
+    --m_length;
+    m_fastAccessCutoff = m_length;
+
+    checkConsistency();
+    return true;
+}
+
+bool JSArray::spliceDense(ExecState* exec, unsigned begin, unsigned deleteCount, const ArgList& items, JSArray* removed)
+{
+    // The arguments were converted after the caller read the length, so they may have changed the array.
+    unsigned length = m_length;
+    if (!isDense() || begin > length || deleteCount > length - begin)
+        return false;
+
+    unsigned itemCount = items.size();
+    if (itemCount > deleteCount && itemCount - deleteCount > maxArrayIndex - length)
+        return false;
+
+    unsigned newLength = length - deleteCount + itemCount;
+    if (newLength > m_storage->m_vectorLength && !increaseVectorLength(newLength))
+        return false;
+
+    checkConsistency();
+
+    for (unsigned k = 0; k < deleteCount; ++k)
+        removed->put(exec, k, m_storage->m_vector[begin + k]);
+    removed->setLength(deleteCount);
+
+    ArrayStorage* storage = m_storage;
+    if (itemCount != deleteCount) {
+        unsigned tailLength = length - begin - deleteCount;
+        memmove(storage->m_vector + begin + itemCount, storage->m_vector + begin + deleteCount, tailLength * sizeof(JSValue*));
+        for (unsigned i = newLength; i < length; ++i)
+            storage->m_vector[i] = 0;
+    }
+
+    ArgList::const_iterator end = items.end();
+    unsigned i = begin;
+    for (ArgList::const_iterator it = items.begin(); it != end; ++it)
+        storage->m_vector[i++] = *it;
+
+    storage->m_numValuesInVector = newLength;
+    m_length = newLength;
+    m_fastAccessCutoff = newLength;
+
+    checkConsistency();
+    return true;
+}
+
 void JSArray::mark()
 {
     JSObject::mark();
@@ -532,6 +654,102 @@ static int compareByStringPairForQSort(const void* a, const void* b)
     return compare(va->second, vb->second);
 }
 
+static inline bool getInt32ForSorting(JSValue* value, int32_t& result)
+{
+    if (!value->isNumber())
+        return false;
+    double number = value->uncheckedGetNumber();
+    if (!(number >= -2147483648.0 && number <= 2147483647.0))
+        return false;
+    result = static_cast<int32_t>(number);
+    return result == number;
+}
+
+static inline unsigned decimalDigitCount(uint32_t n)
+{
+    unsigned count = 1;
+    while (n >= 10) {
+        n /= 10;
+        ++count;
+    }
+    return count;
+}
+
+// Orders magnitudes the way their decimal strings compare, without creating the strings.
+static inline bool decimalStringLess(uint32_t a, uint32_t b)
+{
+    unsigned aDigits = decimalDigitCount(a);
+    unsigned bDigits = decimalDigitCount(b);
+
+    // Pad the shorter number with zeros so both have the same number of digits; if that makes
+    // them equal, one string is a prefix of the other and the shorter one sorts first.
+    uint64_t paddedA = a;
+    uint64_t paddedB = b;
+    for (unsigned i = aDigits; i < bDigits; ++i)
+        paddedA *= 10;
+    for (unsigned i = bDigits; i < aDigits; ++i)
+        paddedB *= 10;
+
+    if (paddedA != paddedB)
+        return paddedA < paddedB;
+    return aDigits < bDigits;
+}
+
+typedef std::pair<JSValue*, int32_t> ArrayIntegerSortPair;
+
+static bool integerPairLessAsStrings(const ArrayIntegerSortPair& a, const ArrayIntegerSortPair& b)
+{
+    int32_t x = a.second;
+    int32_t y = b.second;
+
+    // '-' sorts before every digit, and "-12" against "-3" compares "12" against "3".
+    if ((x < 0) != (y < 0))
+        return x < 0;
+    if (x < 0)
+        return decimalStringLess(0U - static_cast<uint32_t>(x), 0U - static_cast<uint32_t>(y));
+    return decimalStringLess(x, y);
+}
+
+static bool stringPairLess(const ArrayQSortPair& a, const ArrayQSortPair& b)
+{
+    return compare(a.second, b.second) < 0;
+}
+
+// The default sort order compares string conversions. Arrays made only of integers or only
+// of strings can be sorted without calling toString on every element; other arrays return false.
+static bool sortWithoutStringConversion(JSValue** vector, unsigned count)
+{
+    int32_t integer;
+    if (getInt32ForSorting(vector[0], integer)) {
+        Vector<ArrayIntegerSortPair> values(count);
+        for (unsigned i = 0; i < count; ++i) {
+            if (!getInt32ForSorting(vector[i], integer))
+                return false;
+            values[i] = ArrayIntegerSortPair(vector[i], integer);
+        }
+        std::stable_sort(values.begin(), values.end(), integerPairLessAsStrings);
+        for (unsigned i = 0; i < count; ++i)
+            vector[i] = values[i].first;
+        return true;
+    }
+
+    if (vector[0]->isString()) {
+        Vector<ArrayQSortPair> values(count);
+        for (unsigned i = 0; i < count; ++i) {
+            if (!vector[i]->isString())
+                return false;
+            values[i].first = vector[i];
+            values[i].second = static_cast<JSString*>(vector[i])->value();
+        }
+        std::stable_sort(values.begin(), values.end(), stringPairLess);
+        for (unsigned i = 0; i < count; ++i)
+            vector[i] = values[i].first;
+        return true;
+    }
+
+    return false;
+}
+
 void JSArray::sort(ExecState* exec)
 {
     unsigned lengthNotIncludingUndefined = compactForSorting();
@@ -543,6 +761,11 @@ void JSArray::sort(ExecState* exec)
     if (!lengthNotIncludingUndefined)
         return;
 
+    if (sortWithoutStringConversion(m_storage->m_vector, lengthNotIncludingUndefined)) {
+        checkConsistency(SortConsistencyCheck);
+        return;
+    }
+
     // Converting JavaScript values to strings can be expensive, so we do it once up front and sort based on that.
     // This is a considerable improvement over doing it twice per comparison, though it requires a large temporary
     // buffer. Besides, this protects us from crashing if some objects have custom toString methods that return
@@ -725,8 +948,90 @@ typedef int32_t handle; // Handle is an index into m_nodes vector.
     static handle null() { return 0x7FFFFFFF; }
 };
 
+enum ComparatorShape { UnknownComparator, AscendingNumericComparator, DescendingNumericComparator };
+
+// Recognizes compare functions whose whole body is "return a - b;" or "return b - a;" from the
+// bytecode they compile to: op_sub into a temporary, then op_ret of that temporary.
+static ComparatorShape comparatorShape(ExecState* exec, const CallData& callData)
+{
+    FunctionBodyNode* body = callData.js.functionBody;
+    if (body->parameters().size() < 2)
+        return UnknownComparator;
+
+    CodeBlock& codeBlock = body->code(callData.js.scopeChain);
+    const Vector<Instruction>& instructions = codeBlock.instructions;
+    if (instructions.size() != 6)
+        return UnknownComparator;
+
+    Machine* machine = exec->machine();
+    if (machine->getOpcodeID(instructions[0].u.opcode) != op_sub || machine->getOpcodeID(instructions[4].u.opcode) != op_ret)
+        return UnknownComparator;
+    if (instructions[5].u.operand != instructions[1].u.operand)
+        return UnknownComparator;
+
+    // Parameters sit just above the "this" register, which is allocated below the variables.
+    int first = -codeBlock.numVars - codeBlock.numParameters + 1;
+    int src1 = instructions[2].u.operand;
+    int src2 = instructions[3].u.operand;
+    if (src1 == first && src2 == first + 1)
+        return AscendingNumericComparator;
+    if (src1 == first + 1 && src2 == first)
+        return DescendingNumericComparator;
+    return UnknownComparator;
+}
+
+typedef std::pair<JSValue*, double> ArrayNumberSortPair;
+
+static bool numberPairLess(const ArrayNumberSortPair& a, const ArrayNumberSortPair& b)
+{
+    return a.second < b.second;
+}
+
+static bool numberPairGreater(const ArrayNumberSortPair& a, const ArrayNumberSortPair& b)
+{
+    return a.second > b.second;
+}
+
+// With only numbers to compare, a - b has no side effects and cannot throw, so the sort can
+// be done natively. NaN makes the comparator inconsistent, so it is left to the generic sort.
+static bool sortNumbers(JSValue** vector, unsigned count, ComparatorShape shape)
+{
+    Vector<ArrayNumberSortPair> values(count);
+    for (unsigned i = 0; i < count; ++i) {
+        JSValue* value = vector[i];
+        if (!value->isNumber())
+            return false;
+        double number = value->uncheckedGetNumber();
+        if (isnan(number))
+            return false;
+        values[i] = ArrayNumberSortPair(value, number);
+    }
+
+    std::stable_sort(values.begin(), values.end(), shape == AscendingNumericComparator ? numberPairLess : numberPairGreater);
+    for (unsigned i = 0; i < count; ++i)
+        vector[i] = values[i].first;
+    return true;
+}
+
 void JSArray::sort(ExecState* exec, JSValue* compareFunction, CallType callType, const CallData& callData)
 {
+    if (callType == CallTypeJS) {
+        ComparatorShape shape = comparatorShape(exec, callData);
+        if (shape != UnknownComparator) {
+            // Compacting leaves the array in the layout the tree sort below produces, so it is
+            // harmless if the values turn out not to be numbers.
+            unsigned lengthNotIncludingUndefined = compactForSorting();
+            if (m_storage->m_sparseValueMap) {
+                exec->setException(Error::create(exec, GeneralError, "Out of memory"));
+                return;
+            }
+            if (sortNumbers(m_storage->m_vector, lengthNotIncludingUndefined, shape)) {
+                checkConsistency(SortConsistencyCheck);
+                return;
+            }
+        }
+    }
+
     checkConsistency();
 
     // FIXME: This ignores exceptions raised in the compare function or in toNumber.
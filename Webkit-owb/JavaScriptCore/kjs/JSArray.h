@@ -26,7 +26,47 @@
 
 namespace KJS {
 
-  struct ArrayStorage;
+  typedef HashMap<unsigned, JSValue*> SparseArrayValueMap;
+
+  struct ArrayStorage {
+#if NO_MACRO_NEW
+    // Placement operator new.
+    void* operator new(size_t, void* p) { return p; }
+    void* operator new[](size_t, void* p) { return p; }
+
+    void* operator new(size_t size)
+    {
+        void* p = fastMalloc(size);
+        fastMallocMatchValidateMalloc(p, WTF::Internal::AllocTypeClassNew);
+        return p;
+    }
+
+    void operator delete(void* p)
+    {
+        fastMallocMatchValidateFree(p, WTF::Internal::AllocTypeClassNew);
+        fastFree(p);  // We don't need to check for a null pointer; the compiler does this.
+    }
+
+    void* operator new[](size_t size)
+    {
+        void* p = fastMalloc(size);
+        fastMallocMatchValidateMalloc(p, WTF::Internal::AllocTypeClassNewArray);
+        return p;
+    }
+
+    void operator delete[](void* p)
+    {
+        fastMallocMatchValidateFree(p, WTF::Internal::AllocTypeClassNewArray);
+        fastFree(p);  // We don't need to check for a null pointer; the compiler does this.
+    }
+#endif //NO_MACRO_NEW
+    unsigned m_vectorLength;
+    unsigned m_numValuesInVector;
+    unsigned m_indexBias; // Vector slots left in front of this header by JSArray::shiftDense.
+    SparseArrayValueMap* m_sparseValueMap;
+    void* lazyCreationData; // An JSArray subclass can use this to fill the vector lazily.
+    JSValue* m_vector[1];
+  };
 
   class JSArray : public JSObject {
   public:
@@ -46,6 +86,20 @@ namespace KJS {
     void sort(ExecState*);
     void sort(ExecState*, JSValue* compareFunction, CallType, const CallData&);
 
+    // Fast paths for the Array.prototype builtins, used when every index below the length holds
+    // a value in the vector. They return false without changing the array when it is not dense,
+    // and the caller then falls back to the generic algorithm.
+    bool pushDense(ExecState*, const ArgList&);
+    bool popDense(JSValue*& result);
+    bool shiftDense(JSValue*& result);
+    bool spliceDense(ExecState*, unsigned begin, unsigned deleteCount, const ArgList& items, JSArray* removed);
+
+    // Direct access to the dense part of the vector, for the interpreter's indexed get and put.
+    bool canGetIndex(unsigned i) const { return i < m_fastAccessCutoff; }
+    JSValue* getIndex(unsigned i) const { ASSERT(canGetIndex(i)); return m_storage->m_vector[i]; }
+    bool canSetIndex(unsigned i) const { return i < m_fastAccessCutoff; }
+    void setIndex(unsigned i, JSValue* value) { ASSERT(canSetIndex(i)); m_storage->m_vector[i] = value; }
+
   protected:
     virtual void put(ExecState*, const Identifier& propertyName, JSValue*);
     virtual bool deleteProperty(ExecState*, const Identifier& propertyName);
@@ -65,6 +119,7 @@ namespace KJS {
     void putSlowCase(ExecState*, unsigned propertyName, JSValue*);
 
     bool increaseVectorLength(unsigned newLength);
+    bool isDense() const { return m_fastAccessCutoff == m_length && !m_storage->lazyCreationData; }
     
     unsigned compactForSorting();
 
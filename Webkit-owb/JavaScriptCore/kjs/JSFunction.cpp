@@ -553,7 +553,7 @@ JSValue* globalFuncEval(ExecState* exec, JSObject* function, JSValue* thisValue,
     int errLine;
     UString errMsg;
 
-    RefPtr<EvalNode> evalNode = exec->parser()->parse<EvalNode>(exec, UString(), 1, UStringSourceProvider::create(s), &sourceId, &errLine, &errMsg);
+    RefPtr<EvalNode> evalNode = globalObject->evalCodeCache().get(exec, s, &sourceId, &errLine, &errMsg);
     
     if (!evalNode)
         return throwError(exec, SyntaxError, errMsg, errLine, sourceId, NULL);
@@ -41,6 +41,7 @@
 #include "Machine.h"
 #include "nodes.h"
 #include "Parser.h"
+#include "RegExpCache.h"
 
 #if USE(MULTIPLE_THREADS)
 #include <wtf/Threading.h>
@@ -86,6 +87,7 @@ JSGlobalData::JSGlobalData()
     , parserObjectExtraRefCounts(0)
     , lexer(new Lexer(this))
     , parser(new Parser)
+    , regExpCache(new RegExpCache)
     , head(0)
 {
 }
@@ -93,6 +95,7 @@ JSGlobalData::JSGlobalData()
 JSGlobalData::~JSGlobalData()
 {
     // Modified by Paul Pedriana 1/17/2009 in order to fix memory leaks.
+    delete regExpCache;
     delete heap;
     delete machine;
 
@@ -171,5 +174,32 @@ void JSGlobalData::staticFinalize()
     #endif
 }
 
+void JSGlobalData::purgeCaches()
+{
+    #if USE(MULTIPLE_THREADS)
+        // We don't use MULTIPLE_THREADS at EA and so we don't try to figure out how to do this.
+    #else
+        if(gThreadInstance)
+            gThreadInstance->regExpCache->clear();
+        if(gSharedInstance)
+            gSharedInstance->regExpCache->clear();
+    #endif
+}
+
+bool JSGlobalData::collectorStatistics(CollectorStatistics& statistics)
+{
+    #if USE(MULTIPLE_THREADS)
+        return false;
+    #else
+        // WebCore runs all page script on the thread instance; the shared one only exists for
+        // legacy API clients.
+        JSGlobalData* globalData = gThreadInstance ? gThreadInstance : gSharedInstance;
+        if(!globalData)
+            return false;
+        statistics = globalData->heap->statistics();
+        return true;
+    #endif
+}
+
 }
 
@@ -46,6 +46,7 @@ namespace WTF {
 namespace KJS {
 
     class CommonIdentifiers;
+    struct CollectorStatistics;
     class Heap;
     class IdentifierTable;
     class JSGlobalObject;
@@ -53,6 +54,7 @@ namespace KJS {
     class Machine;
     class Parser;
     class ParserRefCounted;
+    class RegExpCache;
     class UString;
     struct HashTable;
 
@@ -115,10 +117,13 @@ public:
 
         Lexer* lexer;
         Parser* parser;
+        RegExpCache* regExpCache;
 
         JSGlobalObject* head;
 
         static void staticFinalize(); // Added by Paul Pedriana, 1/17/2008.
+        static void purgeCaches(); // Drops cached compiled code such as the RegExp cache; used by EA::WebKit::PurgeCache.
+        static bool collectorStatistics(CollectorStatistics&); // False if no heap has been created yet; used by EA::WebKit::GetJavaScriptGCStatistics.
 
     private:
         friend class WTF::ThreadSpecific<JSGlobalData>;
@@ -345,6 +345,7 @@ void JSGlobalObject::mark()
     HashSet<ProgramCodeBlock*>::const_iterator end = codeBlocks().end();
     for (HashSet<ProgramCodeBlock*>::const_iterator it = codeBlocks().begin(); it != end; ++it)
         (*it)->mark();
+    d()->evalCodeCache.mark();
 
     markIfNeeded(d()->globalExec->exception());
 
@@ -28,6 +28,7 @@
 #define KJS_GlobalObject_h
 
 #include <wtf/FastAllocBase.h>
+#include "EvalCodeCache.h"
 #include "JSGlobalData.h"
 #include "JSVariableObject.h"
 #include "RegisterFile.h"
@@ -127,6 +128,7 @@ namespace KJS {
             JSGlobalData* globalData;
 
             HashSet<ProgramCodeBlock*> codeBlocks;
+            EvalCodeCache evalCodeCache;
 
             OwnPtr<HashSet<JSObject*> > arrayVisitedElements; // Global data shared by array prototype functions.
         };
@@ -229,6 +231,7 @@ namespace KJS {
         HashSet<JSObject*>& arrayVisitedElements() { if (!d()->arrayVisitedElements) d()->arrayVisitedElements.set(new HashSet<JSObject*>); return *d()->arrayVisitedElements; }
 
         HashSet<ProgramCodeBlock*>& codeBlocks() { return d()->codeBlocks; }
+        EvalCodeCache& evalCodeCache() { return d()->evalCodeCache; }
 
         void copyGlobalsFrom(RegisterFile&);
         void copyGlobalsTo(RegisterFile&);
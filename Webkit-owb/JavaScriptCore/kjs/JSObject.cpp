@@ -429,6 +429,61 @@ void JSObject::getPropertyNames(ExecState* exec, PropertyNameArray& propertyName
         static_cast<JSObject*>(_proto)->getPropertyNames(exec, propertyNames);
 }
 
+// Plain objects have no ClassInfo and enumerate exactly the names in their property map. The
+// classes that add names of their own all have a ClassInfo, except variable objects.
+static inline bool hasOnlyPropertyMapNames(JSObject* object)
+{
+    return !object->classInfo() && !object->isVariableObject();
+}
+
+PassRefPtr<PropertyNameArrayData> JSObject::propertyNamesForEnumeration(ExecState* exec)
+{
+    if (PropertyNameArrayData* cached = _prop.cachedPropertyNames()) {
+        const PropertyNameArrayData::Chain& chain = cached->chain();
+        JSValue* current = this;
+        size_t i = 0;
+        for (; i < chain.size(); ++i) {
+            const PropertyNameArrayData::ChainEntry& entry = chain[i];
+            if (current != entry.object)
+                break;
+            const PropertyMap& map = entry.object->_prop;
+            if (map.modificationCount() != entry.modificationCount)
+                break;
+            if (!entry.modificationCount && map.enumerableSingleEntryKey() != entry.singleEntryKey)
+                break;
+            current = entry.object->_proto;
+        }
+        if (i == chain.size() && !current->isObject())
+            return cached;
+    }
+
+    PropertyNameArray propertyNames(exec);
+    getPropertyNames(exec, propertyNames);
+    RefPtr<PropertyNameArrayData> data = PropertyNameArrayData::create(propertyNames);
+
+    if (!_prop.modificationCount())
+        return data.release();
+
+    PropertyNameArrayData::Chain& chain = data->chain();
+    for (JSValue* v = this; v->isObject(); v = static_cast<JSObject*>(v)->_proto) {
+        JSObject* object = static_cast<JSObject*>(v);
+        if (!hasOnlyPropertyMapNames(object)) {
+            _prop.setCachedPropertyNames(0);
+            return data.release();
+        }
+
+        PropertyNameArrayData::ChainEntry entry;
+        entry.object = object;
+        entry.modificationCount = object->_prop.modificationCount();
+        if (!entry.modificationCount)
+            entry.singleEntryKey = object->_prop.enumerableSingleEntryKey();
+        chain.append(entry);
+    }
+
+    _prop.setCachedPropertyNames(data);
+    return data.release();
+}
+
 bool JSObject::toBoolean(ExecState*) const
 {
   return true;
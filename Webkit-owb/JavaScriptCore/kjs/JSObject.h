@@ -341,6 +341,10 @@ namespace KJS {
 
     virtual void getPropertyNames(ExecState*, PropertyNameArray&);
 
+    // The names a for-in loop over this object visits. When this object and its prototypes are
+    // plain objects, the list is cached on this object's property map until one of them changes.
+    PassRefPtr<PropertyNameArrayData> propertyNamesForEnumeration(ExecState*);
+
     virtual JSValue* toPrimitive(ExecState*, JSType preferredType = UnspecifiedType) const;
     virtual bool getPrimitiveNumber(ExecState*, double& number, JSValue*& value);
     virtual bool toBoolean(ExecState *exec) const;
@@ -29,13 +29,57 @@
 
 namespace KJS {
 
+  // A lazily concatenated string: a binary tree whose leaves are string reps.
+  // Ropes are not garbage collected, so a JSString can share its rope with the
+  // strings built from it. Both flattening and destruction walk the tree with
+  // an explicit stack, since building a string in a loop makes it very deep.
+  class JSStringRope : Noncopyable {
+  public:
+    // Strings shorter than this are concatenated eagerly; a rope costs more than the copy.
+    enum { MinRopeLength = 64 };
+
+    struct Fiber {
+      Fiber() { }
+      explicit Fiber(const UString& value) : string(value.rep()) { }
+      explicit Fiber(PassRefPtr<JSStringRope> value) : rope(value) { }
+
+      int length() const { return rope ? rope->length() : string->size(); }
+
+      RefPtr<UString::Rep> string;
+      RefPtr<JSStringRope> rope;
+    };
+
+    // Appends right to left, as a rope if the result is long enough.
+    // Returns false if the result would be too long or could not be allocated.
+    static bool concatenate(Fiber& left, const Fiber& right);
+
+    void ref() { ++m_refCount; }
+    void deref();
+
+    int length() const { return m_length; }
+    UString flatten() const;
+
+  private:
+    JSStringRope(const Fiber& left, const Fiber& right);
+
+    int m_refCount;
+    int m_length;
+    Fiber m_left;
+    Fiber m_right;
+  };
+
   class JSString : public JSCell {
   public:
     JSString(const UString& value) : m_value(value) { Heap::heap(this)->reportExtraMemoryCost(value.cost()); }
     enum HasOtherOwnerType { HasOtherOwner };
     JSString(const UString& value, HasOtherOwnerType) : m_value(value) { }
+    JSString(PassRefPtr<JSStringRope> rope) : m_rope(rope) { }
 
-    const UString& value() const { return m_value; }
+    const UString& value() const { if (m_rope) resolveRope(); return m_value; }
+    int length() const { return m_rope ? m_rope->length() : m_value.size(); }
+
+    // The string as a rope fiber, without flattening it.
+    JSStringRope::Fiber fiber() const;
 
     bool getStringPropertySlot(ExecState*, const Identifier& propertyName, PropertySlot&);
     bool getStringPropertySlot(unsigned propertyName, PropertySlot&);
@@ -62,9 +106,14 @@ namespace KJS {
     static JSValue* indexGetter(ExecState*, const Identifier&, const PropertySlot&);
     static JSValue* indexNumericPropertyGetter(ExecState*, unsigned, const PropertySlot&);
 
-    UString m_value;
+    void resolveRope() const;
+
+    mutable UString m_value;
+    mutable RefPtr<JSStringRope> m_rope;
   };
 
+  JSString* jsString(ExecState*, const JSStringRope::Fiber&);
+
 ALWAYS_INLINE bool JSString::getStringPropertySlot(ExecState* exec, const Identifier& propertyName, PropertySlot& slot)
 {
     if (propertyName == exec->propertyNames().length) {
@@ -74,7 +123,7 @@ ALWAYS_INLINE bool JSString::getStringPropertySlot(ExecState* exec, const Identi
 
     bool isStrictUInt32;
     unsigned i = propertyName.toStrictUInt32(&isStrictUInt32);
-    if (isStrictUInt32 && i < static_cast<unsigned>(m_value.size())) {
+    if (isStrictUInt32 && i < static_cast<unsigned>(length())) {
         slot.setCustomIndex(this, i, indexGetter);
         return true;
     }
@@ -84,7 +133,7 @@ ALWAYS_INLINE bool JSString::getStringPropertySlot(ExecState* exec, const Identi
     
 ALWAYS_INLINE bool JSString::getStringPropertySlot(unsigned propertyName, PropertySlot& slot)
 {
-    if (propertyName < static_cast<unsigned>(m_value.size())) {
+    if (propertyName < static_cast<unsigned>(length())) {
         slot.setCustomNumeric(this, indexNumericPropertyGetter);
         return true;
     }
@@ -27,6 +27,7 @@
 #include "debugger.h"
 
 #include "lexer.h"
+#include "TokenCache.h"
 #include <wtf/HashSet.h>
 #include <wtf/Vector.h>
 
@@ -69,12 +70,49 @@ void Parser::parse(ExecState* exec, const UString& sourceURL, int startingLineNu
     lexer.setCode(startingLineNumber, source);
     *sourceId = ++m_sourceId;
 
+    // Large external scripts replay the tokens stored the last time they were parsed, or record
+    // them for next time.
+    TokenStream cachedTokens;
+    TokenStream recordedTokens;
+    bool replayingTokens = false;
+    bool recordingTokens = false;
+    if (TokenStream::isCacheable(sourceURL, startingLineNumber, *source)) {
+        Vector<char> data;
+        if (TokenStream::client()->loadTokens(sourceURL, data) && cachedTokens.decode(&exec->globalData(), data, *source, startingLineNumber)) {
+            lexer.replayTokens(&cachedTokens);
+            replayingTokens = true;
+        } else {
+            lexer.recordTokens(&recordedTokens);
+            recordingTokens = true;
+        }
+    }
+
     int parseError = kjsyyparse(&exec->globalData());
     bool lexError = lexer.sawError();
     lexer.clear();
 
     ParserRefCounted::deleteNewObjects(&exec->globalData());
 
+    // Only error-free streams are stored, so a failed replay means the entry does not belong to this
+    // parser. Lex the source after all and replace the entry.
+    if (replayingTokens && (parseError || lexError)) {
+        m_sourceElements.clear();
+        lexer.setCode(startingLineNumber, source);
+        lexer.recordTokens(&recordedTokens);
+        recordingTokens = true;
+        parseError = kjsyyparse(&exec->globalData());
+        lexError = lexer.sawError();
+        lexer.clear();
+
+        ParserRefCounted::deleteNewObjects(&exec->globalData());
+    }
+
+    if (recordingTokens && !parseError && !lexError) {
+        Vector<char> data;
+        recordedTokens.encode(*source, startingLineNumber, data);
+        TokenStream::client()->storeTokens(sourceURL, data);
+    }
+
     if (parseError || lexError) {
         *errLine = lexer.lineNo();
         *errMsg = "Parse error";
@@ -169,6 +169,8 @@ unsigned sizeMask;
     unsigned keyCount;
     unsigned deletedSentinelCount;
     unsigned lastIndexUsed;
+    unsigned modificationCount;
+    PropertyNameArrayData* cachedPropertyNames;
     unsigned entryIndicies[1];
 
     PropertyMapEntry* entries()
@@ -194,6 +196,17 @@ unsigned sizeMask;
 static const unsigned emptyEntryIndex = 0;
 static const unsigned deletedSentinelIndex = 1;
 
+// Modification counts come from one sequence shared by all maps, so a count can only match the
+// map it was read from, even after that map is destroyed and another takes its address.
+static unsigned lastModificationCount;
+
+static inline unsigned nextModificationCount()
+{
+    if (!++lastModificationCount)
+        ++lastModificationCount;
+    return lastModificationCount;
+}
+
 #if !DO_PROPERTYMAP_CONSTENCY_CHECK
 
 inline void PropertyMap::checkConsistency()
@@ -217,6 +230,8 @@ PropertyMap::~PropertyMap()
         if (UString::Rep* key = m_u.table->entries()[i].key)
             key->deref();
     }
+    if (m_u.table->cachedPropertyNames)
+        m_u.table->cachedPropertyNames->deref();
     fastFree(m_u.table);
 }
 
@@ -241,6 +256,7 @@ void PropertyMap::clear()
         m_u.table->entryIndicies[i] = emptyEntryIndex;
     m_u.table->keyCount = 0;
     m_u.table->deletedSentinelCount = 0;
+    m_u.table->modificationCount = nextModificationCount();
 }
 
 JSValue* PropertyMap::get(const Identifier& name, unsigned& attributes) const
@@ -550,6 +566,7 @@ void PropertyMap::put(const Identifier& name, JSValue* value, unsigned attribute
     m_u.table->entries()[entryIndex - 1].attributes = attributes;
     m_u.table->entries()[entryIndex - 1].index = ++m_u.table->lastIndexUsed;
     ++m_u.table->keyCount;
+    m_u.table->modificationCount = nextModificationCount();
 
     checkConsistency();
 }
@@ -621,6 +638,7 @@ void PropertyMap::createTable()
     m_u.table = static_cast<Table*>(fastZeroedMalloc(Table::allocationSize(newTableSize)));
     m_u.table->size = newTableSize;
     m_u.table->sizeMask = newTableSize - 1;
+    m_u.table->modificationCount = nextModificationCount();
     m_usingTable = true;
 
 #if USE_SINGLE_ENTRY
@@ -646,6 +664,8 @@ void PropertyMap::rehash(unsigned newTableSize)
     m_u.table = static_cast<Table*>(fastZeroedMalloc(Table::allocationSize(newTableSize)));
     m_u.table->size = newTableSize;
     m_u.table->sizeMask = newTableSize - 1;
+    m_u.table->modificationCount = oldTable->modificationCount;
+    m_u.table->cachedPropertyNames = oldTable->cachedPropertyNames;
 
     unsigned lastIndexUsed = 0;
     unsigned entryCount = oldTable->keyCount + oldTable->deletedSentinelCount;
@@ -724,6 +744,7 @@ void PropertyMap::remove(const Identifier& name)
     ASSERT(m_u.table->keyCount >= 1);
     --m_u.table->keyCount;
     ++m_u.table->deletedSentinelCount;
+    m_u.table->modificationCount = nextModificationCount();
 
     if (m_u.table->deletedSentinelCount * 4 >= m_u.table->size)
         rehash();
@@ -836,6 +857,35 @@ void PropertyMap::getEnumerablePropertyNames(PropertyNameArray& propertyNames) c
         propertyNames.add(q[0]->key);
 }
 
+unsigned PropertyMap::modificationCount() const
+{
+    return m_usingTable ? m_u.table->modificationCount : 0;
+}
+
+UString::Rep* PropertyMap::enumerableSingleEntryKey() const
+{
+#if USE_SINGLE_ENTRY
+    if (!m_usingTable && !(m_singleEntryAttributes & DontEnum))
+        return m_singleEntryKey;
+#endif
+    return 0;
+}
+
+PropertyNameArrayData* PropertyMap::cachedPropertyNames() const
+{
+    return m_usingTable ? m_u.table->cachedPropertyNames : 0;
+}
+
+void PropertyMap::setCachedPropertyNames(PassRefPtr<PropertyNameArrayData> propertyNames)
+{
+    if (!m_usingTable)
+        return;
+
+    if (m_u.table->cachedPropertyNames)
+        m_u.table->cachedPropertyNames->deref();
+    m_u.table->cachedPropertyNames = propertyNames.releaseRef();
+}
+
 #if DO_PROPERTYMAP_CONSTENCY_CHECK
 
 void PropertyMap::checkConsistency()
@@ -25,12 +25,14 @@
 #include "identifier.h"
 #include "protect.h"
 #include <wtf/OwnArrayPtr.h>
+#include <wtf/PassRefPtr.h>
 
 namespace KJS {
 
     class JSObject;
     class JSValue;
     class PropertyNameArray;
+    class PropertyNameArrayData;
     
     struct PropertyMapEntry;
     struct PropertyMapHashTable;
@@ -52,6 +54,14 @@ namespace KJS {
         void mark() const;
         void getEnumerablePropertyNames(PropertyNameArray&) const;
 
+        // Support for caching for-in enumerations. Maps with a hash table get a new modification
+        // count whenever a property is added or removed; smaller maps report 0 and are identified
+        // by their enumerable key instead. Only maps with a hash table can hold a cached list.
+        unsigned modificationCount() const;
+        UString::Rep* enumerableSingleEntryKey() const;
+        PropertyNameArrayData* cachedPropertyNames() const;
+        void setCachedPropertyNames(PassRefPtr<PropertyNameArrayData>);
+
         bool hasGetterSetterProperties() const { return m_getterSetterFlag; }
         void setHasGetterSetterProperties(bool f) { m_getterSetterFlag = f; }
 
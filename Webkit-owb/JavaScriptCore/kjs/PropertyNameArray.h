@@ -30,6 +30,9 @@
 #include "ExecState.h"
 #include "identifier.h"
 #include <wtf/HashSet.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefCounted.h>
+#include <wtf/RefPtr.h>
 #include <wtf/Vector.h>
 
 namespace KJS {
@@ -96,6 +99,39 @@ void operator delete[](void* p)
         JSGlobalData* m_globalData;
     };
 
+    class JSObject;
+
+    // The names a for-in loop visits, shared between JSPropertyNameIterator and the enumeration
+    // cache on the property map of the enumerated object. The chain records the objects and
+    // property map states the names were collected from, so the cache can tell when it is stale.
+    class PropertyNameArrayData : public RefCounted<PropertyNameArrayData> {
+    public:
+        typedef Vector<Identifier> PropertyNameVector;
+
+        struct ChainEntry {
+            JSObject* object;
+            unsigned modificationCount;
+            RefPtr<UString::Rep> singleEntryKey; // Only used for maps without a hash table.
+        };
+        typedef Vector<ChainEntry> Chain;
+
+        static PassRefPtr<PropertyNameArrayData> create(const PropertyNameArray& propertyNames) { return adoptRef(new PropertyNameArrayData(propertyNames)); }
+
+        const PropertyNameVector& propertyNameVector() const { return m_propertyNameVector; }
+
+        const Chain& chain() const { return m_chain; }
+        Chain& chain() { return m_chain; }
+
+    private:
+        PropertyNameArrayData(const PropertyNameArray& propertyNames)
+        {
+            m_propertyNameVector.appendRange(propertyNames.begin(), propertyNames.end());
+        }
+
+        PropertyNameVector m_propertyNameVector;
+        Chain m_chain;
+    };
+
 } // namespace KJS
 
 #endif // PropertyNameArray_h
@@ -0,0 +1,170 @@
+/*
+Copyright (C) 2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "RegExpCache.h"
+
+namespace KJS {
+
+// The key is the flags length (or a marker for the flagless create), the flags, then the pattern, so 
+// that no two pattern/flags pairs produce the same key.
+static const UChar kNoFlagsKeyMarker = 0xFFFF;
+
+static UString makeKey(const UString& pattern, const UString* flags)
+{
+    const UChar prefix = flags ? static_cast<UChar>(flags->size()) : kNoFlagsKeyMarker;
+    UString key(&prefix, 1);
+    if (flags)
+        key.append(*flags);
+    key.append(pattern);
+    return key;
+}
+
+RegExpCache::RegExpCache()
+    : m_head(0)
+    , m_tail(0)
+    , m_maxEntries(kDefaultMaxEntries)
+    , m_maxBytes(kDefaultMaxBytes)
+    , m_byteCount(0)
+    , m_hitCount(0)
+    , m_missCount(0)
+    , m_evictionCount(0)
+{
+}
+
+RegExpCache::~RegExpCache()
+{
+    clear();
+}
+
+PassRefPtr<RegExp> RegExpCache::lookupOrCreate(const UString& pattern)
+{
+    return lookupOrCreate(makeKey(pattern, 0), pattern, 0);
+}
+
+PassRefPtr<RegExp> RegExpCache::lookupOrCreate(const UString& pattern, const UString& flags)
+{
+    // Flags are at most a handful of characters; anything long enough to clash with the marker isn't worth caching.
+    if (flags.size() >= kNoFlagsKeyMarker)
+        return RegExp::create(pattern, flags);
+    return lookupOrCreate(makeKey(pattern, &flags), pattern, &flags);
+}
+
+PassRefPtr<RegExp> RegExpCache::lookupOrCreate(const UString& key, const UString& pattern, const UString* flags)
+{
+    EntryMap::iterator it = m_map.find(key.rep());
+    if (it != m_map.end()) {
+        ++m_hitCount;
+        Entry* entry = it->second;
+        if (entry != m_head) {
+            unlink(entry);
+            linkAtHead(entry);
+        }
+        return entry->regExp;
+    }
+
+    ++m_missCount;
+    RefPtr<RegExp> regExp = flags ? RegExp::create(pattern, *flags) : RegExp::create(pattern);
+
+    // Rough footprint: the RegExp, its pattern and flags, our key and the compiled pcre code, which
+    // is typically a few bytes per pattern character.
+    const unsigned cost = sizeof(RegExp) + sizeof(Entry) + (key.size() * 2 + pattern.size() * 2) * sizeof(UChar);
+    if (cost > m_maxBytes / 4)
+        return regExp.release();
+
+    Entry* entry = new Entry;
+    entry->key = key.rep();
+    entry->regExp = regExp;
+    entry->cost = cost;
+    linkAtHead(entry);
+    m_map.set(entry->key, entry);
+    m_byteCount += cost;
+
+    prune();
+    return regExp.release();
+}
+
+void RegExpCache::setCapacity(unsigned maxEntries, unsigned maxBytes)
+{
+    m_maxEntries = maxEntries;
+    m_maxBytes = maxBytes;
+    prune();
+}
+
+void RegExpCache::clear()
+{
+    Entry* entry = m_head;
+    while (entry) {
+        Entry* next = entry->next;
+        delete entry;
+        entry = next;
+    }
+    m_map.clear();
+    m_head = 0;
+    m_tail = 0;
+    m_byteCount = 0;
+}
+
+void RegExpCache::unlink(Entry* entry)
+{
+    if (entry->previous)
+        entry->previous->next = entry->next;
+    else
+        m_head = entry->next;
+
+    if (entry->next)
+        entry->next->previous = entry->previous;
+    else
+        m_tail = entry->previous;
+}
+
+void RegExpCache::linkAtHead(Entry* entry)
+{
+    entry->previous = 0;
+    entry->next = m_head;
+    if (m_head)
+        m_head->previous = entry;
+    m_head = entry;
+    if (!m_tail)
+        m_tail = entry;
+}
+
+void RegExpCache::prune()
+{
+    while (m_tail && (m_map.size() > m_maxEntries || m_byteCount > m_maxBytes)) {
+        Entry* entry = m_tail;
+        unlink(entry);
+        m_map.remove(entry->key);
+        m_byteCount -= entry->cost;
+        ++m_evictionCount;
+        // RegExps still held by script objects or parse trees stay alive through their own references.
+        delete entry;
+    }
+}
+
+} // namespace KJS
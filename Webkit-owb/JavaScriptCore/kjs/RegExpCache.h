@@ -0,0 +1,92 @@
+/*
+Copyright (C) 2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef RegExpCache_h
+#define RegExpCache_h
+
+#include "regexp.h"
+#include "ustring.h"
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/RefPtr.h>
+
+namespace KJS {
+
+    // Compiled regular expressions keyed by pattern and flags. RegExp is immutable once compiled, so
+    // regexp literals, the RegExp constructor, RegExp.prototype.compile and the String methods that
+    // build a RegExp from a string can all share one instance instead of recompiling the pattern.
+    // The least recently used entries are dropped once either the entry or the byte limit is exceeded.
+    class RegExpCache : Noncopyable {
+    public:
+        enum { kDefaultMaxEntries = 256, kDefaultMaxBytes = 256 * 1024 };
+
+        RegExpCache();
+        ~RegExpCache();
+
+        PassRefPtr<RegExp> lookupOrCreate(const UString& pattern);
+        PassRefPtr<RegExp> lookupOrCreate(const UString& pattern, const UString& flags);
+
+        void setCapacity(unsigned maxEntries, unsigned maxBytes);
+        void clear();
+
+        unsigned hitCount() const { return m_hitCount; }
+        unsigned missCount() const { return m_missCount; }
+        unsigned evictionCount() const { return m_evictionCount; }
+        unsigned entryCount() const { return m_map.size(); }
+        unsigned byteCount() const { return m_byteCount; }
+
+    private:
+        struct Entry {
+            RefPtr<UString::Rep> key;
+            RefPtr<RegExp> regExp;
+            unsigned cost;
+            Entry* previous; // Towards the most recently used entry.
+            Entry* next;
+        };
+
+        typedef HashMap<RefPtr<UString::Rep>, Entry*> EntryMap;
+
+        PassRefPtr<RegExp> lookupOrCreate(const UString& key, const UString& pattern, const UString* flags);
+        void unlink(Entry*);
+        void linkAtHead(Entry*);
+        void prune();
+
+        EntryMap m_map;
+        Entry* m_head; // Most recently used.
+        Entry* m_tail; // Least recently used; evicted first.
+        unsigned m_maxEntries;
+        unsigned m_maxBytes;
+        unsigned m_byteCount;
+        unsigned m_hitCount;
+        unsigned m_missCount;
+        unsigned m_evictionCount;
+    };
+
+} // namespace KJS
+
+#endif // RegExpCache_h
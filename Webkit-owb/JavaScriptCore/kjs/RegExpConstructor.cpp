@@ -30,6 +30,7 @@
 #include "JSArray.h"
 #include "JSString.h"
 #include "ObjectPrototype.h"
+#include "RegExpCache.h"
 #include "RegExpObject.h"
 #include "RegExpPrototype.h"
 #include "regexp.h"
@@ -313,7 +314,7 @@ static JSObject* constructRegExp(ExecState* exec, const ArgList& args)
   UString pattern = arg0->isUndefined() ? UString("") : arg0->toString(exec);
   UString flags = arg1->isUndefined() ? UString("") : arg1->toString(exec);
   
-  RefPtr<RegExp> regExp = RegExp::create(pattern, flags);
+  RefPtr<RegExp> regExp = exec->globalData().regExpCache->lookupOrCreate(pattern, flags);
   return regExp->isValid()
     ? new (exec) RegExpObject(exec->lexicalGlobalObject()->regExpPrototype(), regExp.release())
     : throwError(exec, SyntaxError, UString("Invalid regular expression: ").append(regExp->errorMessage()));
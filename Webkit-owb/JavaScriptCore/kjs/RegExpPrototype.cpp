@@ -28,6 +28,7 @@
 #include "JSString.h"
 #include "JSValue.h"
 #include "ObjectPrototype.h"
+#include "RegExpCache.h"
 #include "RegExpObject.h"
 #include "regexp.h"
 
@@ -83,7 +84,7 @@ JSValue* regExpProtoFuncCompile(ExecState* exec, JSObject*, JSValue* thisValue,
     } else {
         UString pattern = args.isEmpty() ? UString("") : arg0->toString(exec);
         UString flags = arg1->isUndefined() ? UString("") : arg1->toString(exec);
-        regExp = RegExp::create(pattern, flags);
+        regExp = exec->globalData().regExpCache->lookupOrCreate(pattern, flags);
     }
 
     if (!regExp->isValid())
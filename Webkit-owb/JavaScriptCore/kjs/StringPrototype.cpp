@@ -23,7 +23,9 @@
 
 #include "JSArray.h"
 #include "ObjectPrototype.h"
+#include "operations.h"
 #include "PropertyNameArray.h"
+#include "RegExpCache.h"
 #include "RegExpConstructor.h"
 #include "RegExpObject.h"
 #include <wtf/MathExtras.h>
@@ -346,11 +348,13 @@ JSValue* stringProtoFuncCharCodeAt(ExecState* exec, JSObject*, JSValue* thisValu
 
 JSValue* stringProtoFuncConcat(ExecState* exec, JSObject*, JSValue* thisValue, const ArgList& args)
 {
-    UString s = thisValue->toThisString(exec);
+    JSStringRope::Fiber s = thisValue->isString() ? static_cast<JSString*>(thisValue)->fiber() : JSStringRope::Fiber(thisValue->toThisString(exec));
 
     ArgList::const_iterator end = args.end();
     for (ArgList::const_iterator it = args.begin(); it != end; ++it) {
-        s += (*it)->toString(exec);
+        JSValue* arg = *it;
+        if (!JSStringRope::concatenate(s, arg->isString() ? static_cast<JSString*>(arg)->fiber() : JSStringRope::Fiber(arg->toString(exec))))
+            return throwOutOfMemoryError(exec);
     }
     return jsString(exec, s);
 }
@@ -405,7 +409,7 @@ JSValue* stringProtoFuncMatch(ExecState* exec, JSObject*, JSValue* thisValue, co
        *  If regexp is not an object whose [[Class]] property is "RegExp", it is
        *  replaced with the result of the expression new RegExp(regexp).
        */
-      reg = RegExp::create(a0->toString(exec));
+      reg = exec->globalData().regExpCache->lookupOrCreate(a0->toString(exec));
     }
     RegExpConstructor* regExpObj = exec->lexicalGlobalObject()->regExpConstructor();
     int pos;
@@ -458,7 +462,7 @@ JSValue* stringProtoFuncSearch(ExecState* exec, JSObject*, JSValue* thisValue, c
        *  If regexp is not an object whose [[Class]] property is "RegExp", it is
        *  replaced with the result of the expression new RegExp(regexp).
        */
-      reg = RegExp::create(a0->toString(exec));
+      reg = exec->globalData().regExpCache->lookupOrCreate(a0->toString(exec));
     }
     RegExpConstructor* regExpObj = exec->lexicalGlobalObject()->regExpConstructor();
     int pos;
@@ -0,0 +1,324 @@
+/*
+Copyright (C) 2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "TokenCache.h"
+
+#include "SourceProvider.h"
+#include <string.h>
+
+namespace KJS {
+
+// Bump whenever the encoding, the token numbering in grammar.y or the lexer's output changes.
+static const unsigned kTokenStreamMagic = 0x4B4A5354; // 'KJST'
+static const unsigned kTokenStreamVersion = 1;
+
+TokenCacheClient* TokenStream::s_client = 0;
+
+// 64-bit FNV-1a over the source characters; together with the length this is what ties a stored
+// stream to the exact text it was lexed from.
+static unsigned long long hashSource(const SourceProvider& source)
+{
+    const UChar* characters = source.data();
+    const int length = source.length();
+    unsigned long long hash = 14695981039346656037ULL;
+    for (int i = 0; i < length; ++i) {
+        hash = (hash ^ (characters[i] & 0xFF)) * 1099511628211ULL;
+        hash = (hash ^ (characters[i] >> 8)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+template <typename T> static inline void write(Vector<char>& data, const T& value)
+{
+    data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void writeString(Vector<char>& data, const UString& string)
+{
+    write(data, static_cast<unsigned>(string.size()));
+    data.append(reinterpret_cast<const char*>(string.data()), string.size() * sizeof(UChar));
+}
+
+namespace {
+
+    // Bounds-checked reader; any overrun leaves it failed rather than reading past the buffer.
+    class Reader {
+    public:
+        Reader(const Vector<char>& data)
+            : m_current(data.data())
+            , m_end(data.data() + data.size())
+            , m_failed(false)
+        {
+        }
+
+        template <typename T> T read()
+        {
+            T value = T();
+            if (static_cast<size_t>(m_end - m_current) < sizeof(T)) {
+                m_failed = true;
+                return value;
+            }
+            memcpy(&value, m_current, sizeof(T));
+            m_current += sizeof(T);
+            return value;
+        }
+
+        const UChar* readCharacters(unsigned& length)
+        {
+            length = read<unsigned>();
+            if (m_failed || static_cast<size_t>(m_end - m_current) / sizeof(UChar) < length) {
+                m_failed = true;
+                return 0;
+            }
+            const char* characters = m_current;
+            m_current += length * sizeof(UChar);
+            return reinterpret_cast<const UChar*>(characters);
+        }
+
+        bool failed() const { return m_failed; }
+        bool atEnd() const { return m_current == m_end; }
+
+    private:
+        const char* m_current;
+        const char* m_end;
+        bool m_failed;
+    };
+
+} // namespace
+
+TokenStream::TokenStream()
+    : m_position(0)
+{
+}
+
+bool TokenStream::isCacheable(const UString& sourceURL, int startingLineNumber, const SourceProvider& source)
+{
+    // External scripts are evaluated from line 1 with their own URL; inline scripts share the
+    // document's URL at varying lines, and small scripts lex faster than a cache lookup.
+    return s_client && startingLineNumber == 1 && !sourceURL.isEmpty() && source.length() >= MinCacheableSourceLength;
+}
+
+TokenStream::Token& TokenStream::appendToken(int token, int line, bool terminator, ValueType valueType)
+{
+    m_tokens.resize(m_tokens.size() + 1);
+    Token& entry = m_tokens.last();
+    entry.token = token;
+    entry.line = line;
+    entry.terminator = terminator;
+    entry.valueType = static_cast<unsigned char>(valueType);
+    entry.intValue = 0;
+    entry.doubleValue = 0;
+    entry.index = 0;
+    entry.flagsIndex = 0;
+    return entry;
+}
+
+void TokenStream::appendToken(int token, int line, bool terminator)
+{
+    appendToken(token, line, terminator, NoValue);
+}
+
+void TokenStream::appendToken(int token, int line, bool terminator, int value)
+{
+    appendToken(token, line, terminator, IntValue).intValue = value;
+}
+
+void TokenStream::appendToken(int token, int line, bool terminator, double value)
+{
+    appendToken(token, line, terminator, DoubleValue).doubleValue = value;
+}
+
+void TokenStream::appendToken(int token, int line, bool terminator, const Identifier& value)
+{
+    // Identifiers are atomic, so the rep identifies the name.
+    std::pair<HashMap<UString::Rep*, unsigned>::iterator, bool> result = m_identifierIndexes.add(value.ustring().rep(), m_identifiers.size());
+    if (result.second)
+        m_identifiers.append(value);
+    appendToken(token, line, terminator, IdentifierValue).index = result.first->second;
+}
+
+void TokenStream::appendToken(int token, int line, bool terminator, const UString& value)
+{
+    appendToken(token, line, terminator, StringValue).index = addString(value);
+}
+
+void TokenStream::appendRegExp(const UString& pattern, const UString& flags)
+{
+    Token& entry = appendToken(0, 0, false, RegExpValue);
+    entry.index = addString(pattern);
+    entry.flagsIndex = addString(flags);
+}
+
+unsigned TokenStream::addString(const UString& string)
+{
+    m_strings.append(string);
+    return m_strings.size() - 1;
+}
+
+void TokenStream::encode(const SourceProvider& source, int startingLineNumber, Vector<char>& data) const
+{
+    data.clear();
+    write(data, kTokenStreamMagic);
+    write(data, kTokenStreamVersion);
+    write(data, source.length());
+    write(data, hashSource(source));
+    write(data, startingLineNumber);
+    write(data, static_cast<unsigned>(m_identifiers.size()));
+    write(data, static_cast<unsigned>(m_strings.size()));
+    write(data, static_cast<unsigned>(m_tokens.size()));
+
+    for (size_t i = 0; i < m_identifiers.size(); ++i)
+        writeString(data, m_identifiers[i].ustring());
+    for (size_t i = 0; i < m_strings.size(); ++i)
+        writeString(data, m_strings[i]);
+
+    for (size_t i = 0; i < m_tokens.size(); ++i) {
+        const Token& token = m_tokens[i];
+        write(data, token.valueType);
+        if (token.valueType == RegExpValue) {
+            write(data, token.index);
+            write(data, token.flagsIndex);
+            continue;
+        }
+        write(data, token.token);
+        write(data, token.line);
+        write(data, static_cast<unsigned char>(token.terminator));
+        switch (token.valueType) {
+            case IntValue:
+                write(data, token.intValue);
+                break;
+            case DoubleValue:
+                write(data, token.doubleValue);
+                break;
+            case IdentifierValue:
+            case StringValue:
+                write(data, token.index);
+                break;
+        }
+    }
+}
+
+bool TokenStream::decode(JSGlobalData* globalData, const Vector<char>& data, const SourceProvider& source, int startingLineNumber)
+{
+    ASSERT(m_tokens.isEmpty());
+    if (decodeTokens(globalData, data, source, startingLineNumber))
+        return true;
+
+    m_tokens.clear();
+    m_identifiers.clear();
+    m_strings.clear();
+    return false;
+}
+
+bool TokenStream::decodeTokens(JSGlobalData* globalData, const Vector<char>& data, const SourceProvider& source, int startingLineNumber)
+{
+    Reader reader(data);
+    if (reader.read<unsigned>() != kTokenStreamMagic || reader.read<unsigned>() != kTokenStreamVersion)
+        return false;
+    if (reader.read<int>() != source.length())
+        return false;
+    const unsigned long long storedHash = reader.read<unsigned long long>();
+    if (reader.read<int>() != startingLineNumber || reader.failed())
+        return false;
+
+    const unsigned identifierCount = reader.read<unsigned>();
+    const unsigned stringCount = reader.read<unsigned>();
+    const unsigned tokenCount = reader.read<unsigned>();
+    // Every entry takes at least one byte, which bounds the counts before anything is allocated.
+    if (reader.failed() || static_cast<unsigned long long>(identifierCount) + stringCount + tokenCount > data.size())
+        return false;
+
+    // Hash last: it is the only check that reads the whole source.
+    if (storedHash != hashSource(source))
+        return false;
+
+    m_identifiers.reserveCapacity(identifierCount);
+    for (unsigned i = 0; i < identifierCount; ++i) {
+        unsigned length;
+        const UChar* characters = reader.readCharacters(length);
+        if (reader.failed())
+            return false;
+        m_identifiers.append(Identifier(globalData, characters, length));
+    }
+
+    m_strings.reserveCapacity(stringCount);
+    for (unsigned i = 0; i < stringCount; ++i) {
+        unsigned length;
+        const UChar* characters = reader.readCharacters(length);
+        if (reader.failed())
+            return false;
+        m_strings.append(UString(characters, length));
+    }
+
+    m_tokens.reserveCapacity(tokenCount);
+    for (unsigned i = 0; i < tokenCount; ++i) {
+        const ValueType valueType = static_cast<ValueType>(reader.read<unsigned char>());
+        if (valueType == RegExpValue) {
+            Token& token = appendToken(0, 0, false, RegExpValue);
+            token.index = reader.read<unsigned>();
+            token.flagsIndex = reader.read<unsigned>();
+            if (token.index >= stringCount || token.flagsIndex >= stringCount)
+                return false;
+            continue;
+        }
+
+        const int tokenValue = reader.read<int>();
+        const int line = reader.read<int>();
+        const bool terminator = reader.read<unsigned char>() != 0;
+        Token& token = appendToken(tokenValue, line, terminator, valueType);
+        switch (valueType) {
+            case NoValue:
+                break;
+            case IntValue:
+                token.intValue = reader.read<int>();
+                break;
+            case DoubleValue:
+                token.doubleValue = reader.read<double>();
+                break;
+            case IdentifierValue:
+                token.index = reader.read<unsigned>();
+                if (token.index >= identifierCount)
+                    return false;
+                break;
+            case StringValue:
+                token.index = reader.read<unsigned>();
+                if (token.index >= stringCount)
+                    return false;
+                break;
+            default:
+                return false;
+        }
+        if (reader.failed())
+            return false;
+    }
+
+    return !reader.failed() && reader.atEnd();
+}
+
+} // namespace KJS
@@ -0,0 +1,112 @@
+/*
+Copyright (C) 2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef TokenCache_h
+#define TokenCache_h
+
+#include "identifier.h"
+#include "ustring.h"
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace KJS {
+
+    class SourceProvider;
+
+    // Persistent storage for token streams, supplied by the embedder. Entries are keyed by script URL;
+    // the stream itself records the length and a hash of the source it was lexed from, so a stale
+    // entry is detected by TokenStream::decode and the script is simply lexed again.
+    class TokenCacheClient {
+    public:
+        virtual ~TokenCacheClient() { }
+
+        virtual bool loadTokens(const UString& sourceURL, Vector<char>& data) = 0;
+        virtual void storeTokens(const UString& sourceURL, const Vector<char>& data) = 0;
+    };
+
+    // The tokens (and regexp literal bodies) the lexer handed to the parser for one source, in the
+    // order the parser asked for them. The grammar is deterministic, so replaying the recorded stream
+    // rebuilds the same tree as lexing the source again, without touching the source characters.
+    class TokenStream : Noncopyable {
+    public:
+        enum { MinCacheableSourceLength = 4096 };
+
+        enum ValueType { NoValue, IntValue, DoubleValue, IdentifierValue, StringValue, RegExpValue };
+
+        struct Token {
+            int token;
+            int line;
+            bool terminator;
+            unsigned char valueType;
+            int intValue;
+            double doubleValue;
+            unsigned index;         // Identifier or string table index; the pattern for a regexp.
+            unsigned flagsIndex;    // String table index of a regexp's flags.
+        };
+
+        TokenStream();
+
+        static bool isCacheable(const UString& sourceURL, int startingLineNumber, const SourceProvider&);
+
+        // Recording, driven by the lexer.
+        void appendToken(int token, int line, bool terminator);
+        void appendToken(int token, int line, bool terminator, int value);
+        void appendToken(int token, int line, bool terminator, double value);
+        void appendToken(int token, int line, bool terminator, const Identifier& value);
+        void appendToken(int token, int line, bool terminator, const UString& value);
+        void appendRegExp(const UString& pattern, const UString& flags);
+
+        // Replay, driven by the lexer. Returns 0 once the stream is exhausted.
+        const Token* next() { return m_position < m_tokens.size() ? &m_tokens[m_position++] : 0; }
+        const Identifier& identifier(unsigned index) const { return m_identifiers[index]; }
+        const UString& string(unsigned index) const { return m_strings[index]; }
+
+        void encode(const SourceProvider&, int startingLineNumber, Vector<char>& data) const;
+        bool decode(JSGlobalData*, const Vector<char>& data, const SourceProvider&, int startingLineNumber);
+
+        static void setClient(TokenCacheClient* client) { s_client = client; }
+        static TokenCacheClient* client() { return s_client; }
+
+    private:
+        Token& appendToken(int token, int line, bool terminator, ValueType);
+        unsigned addString(const UString&);
+        bool decodeTokens(JSGlobalData*, const Vector<char>& data, const SourceProvider&, int startingLineNumber);
+
+        Vector<Token> m_tokens;
+        Vector<Identifier> m_identifiers;
+        Vector<UString> m_strings;
+        HashMap<UString::Rep*, unsigned> m_identifierIndexes;
+        size_t m_position;
+
+        static TokenCacheClient* s_client;
+    };
+
+} // namespace KJS
+
+#endif // TokenCache_h
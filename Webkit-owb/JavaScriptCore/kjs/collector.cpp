@@ -80,6 +80,7 @@
 #define COLLECT_ON_EVERY_ALLOCATION 0
 
 using std::max;
+using std::min;
 
 
 namespace EA
@@ -97,7 +98,6 @@ namespace KJS {
 const size_t SPARE_EMPTY_BLOCKS = 2;
 const size_t GROWTH_FACTOR = 2;
 const size_t LOW_WATER_FACTOR = 4;
-const size_t ALLOCATIONS_PER_COLLECTION = 4000;
 // This value has to be a macro to be used in max() without introducing
 // a PIC branch in Mach-O binaries, see <rdar://problem/5971391>.
 #define MIN_ARRAY_SIZE (static_cast<size_t>(14))
@@ -144,6 +144,8 @@ Heap::Heap(Machine* machine)
 {
     memset(&primaryHeap, 0, sizeof(CollectorHeap));
     memset(&numberHeap, 0, sizeof(CollectorHeap));
+    primaryHeap.collectionThreshold = CollectorPolicy::minimumThreshold;
+    numberHeap.collectionThreshold = CollectorPolicy::minimumThreshold;
 }
 
 Heap::~Heap()
@@ -151,6 +153,10 @@ Heap::~Heap()
     JSLock lock;
 
     delete m_markListSet;
+    // Finish the last collection's sweep, which clears its marks; a second pass then finds every
+    // remaining cell unmarked and destroys it.
+    sweep<PrimaryHeap>();
+    scheduleSweep<PrimaryHeap>();
     sweep<PrimaryHeap>();
     // No need to sweep number heap, because the JSNumber destructor doesn't do anything.
 
@@ -300,11 +306,10 @@ template <Heap::HeapType heapType> ALWAYS_INLINE void* Heap::heapAllocate(size_t
 
     // if we have a huge amount of extra cost, we'll try to collect even if we still have
     // free cells left.
-    if (heapType == PrimaryHeap && heap.extraCost > ALLOCATIONS_PER_COLLECTION) {
-        size_t numLiveObjectsAtLastCollect = heap.numLiveObjectsAtLastCollect;
-        size_t numNewObjects = numLiveObjects - numLiveObjectsAtLastCollect;
+    if (heapType == PrimaryHeap && heap.extraCost > CollectorPolicy::minimumThreshold) {
+        size_t numNewObjects = numLiveObjects - heap.numLiveObjectsAtLastCollect;
         const size_t newCost = numNewObjects + heap.extraCost;
-        if (newCost >= ALLOCATIONS_PER_COLLECTION && newCost >= numLiveObjectsAtLastCollect)
+        if (newCost >= heap.collectionThreshold)
             goto collect;
     }
 
@@ -319,24 +324,36 @@ scan:
     size_t targetBlockUsedCells;
     if (i != usedBlocks) {
         targetBlock = (Block*)heap.blocks[i];
+        if (targetBlock->pendingSweep) {
+            sweepBlock<heapType>((CollectorBlock*)targetBlock);
+            numLiveObjects = heap.numLiveObjects;
+        }
         targetBlockUsedCells = targetBlock->usedCells;
         ASSERT(targetBlockUsedCells <= HeapConstants<heapType>::cellsPerBlock);
         while (targetBlockUsedCells == HeapConstants<heapType>::cellsPerBlock) {
             if (++i == usedBlocks)
                 goto collect;
             targetBlock = (Block*)heap.blocks[i];
+            if (targetBlock->pendingSweep) {
+                sweepBlock<heapType>((CollectorBlock*)targetBlock);
+                numLiveObjects = heap.numLiveObjects;
+            }
             targetBlockUsedCells = targetBlock->usedCells;
             ASSERT(targetBlockUsedCells <= HeapConstants<heapType>::cellsPerBlock);
         }
-        heap.firstBlockWithPossibleSpace = i;
+        if (heap.firstBlockWithPossibleSpace != i) {
+            heap.firstBlockWithPossibleSpace = i;
+            // Moving on to another block is rare enough to pay for sweeping one more in the background.
+            sweepNextBlockInBackground<heapType>();
+            numLiveObjects = heap.numLiveObjects;
+        }
     } else {
 
 collect:
-        size_t numLiveObjectsAtLastCollect = heap.numLiveObjectsAtLastCollect;
-        size_t numNewObjects = numLiveObjects - numLiveObjectsAtLastCollect;
+        size_t numNewObjects = numLiveObjects - heap.numLiveObjectsAtLastCollect;
         const size_t newCost = numNewObjects + heap.extraCost;
 
-        if (newCost >= ALLOCATIONS_PER_COLLECTION && newCost >= numLiveObjectsAtLastCollect) {
+        if (newCost >= heap.collectionThreshold) {
 #ifndef NDEBUG
             heap.operationInProgress = NoOperation;
 #endif
@@ -344,9 +361,10 @@ collect:
 #ifndef NDEBUG
             heap.operationInProgress = Allocation;
 #endif
+            // Even when it reclaims nothing, the collection finishes the previous sweep.
+            numLiveObjects = heap.numLiveObjects;
+            usedBlocks = heap.usedBlocks;
             if (collected) {
-                numLiveObjects = heap.numLiveObjects;
-                usedBlocks = heap.usedBlocks;
                 i = heap.firstBlockWithPossibleSpace;
                 goto scan;
             }
@@ -831,103 +849,204 @@ void Heap::markProtectedObjects()
     }
 }
 
-template <Heap::HeapType heapType> size_t Heap::sweep()
+COMPILE_ASSERT(sizeof(CollectorBlock) <= BLOCK_SIZE, CollectorBlock_fits_in_BLOCK_SIZE);
+COMPILE_ASSERT(sizeof(SmallCellCollectorBlock) <= BLOCK_SIZE, SmallCellCollectorBlock_fits_in_BLOCK_SIZE);
+
+static inline size_t bitCount(uint32_t bits)
+{
+    bits = bits - ((bits >> 1) & 0x55555555);
+    bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+    return (((bits + (bits >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+// The number of cells a sweep of the block will keep, read from the mark bits alone. It is exact for
+// the primary heap; a number heap mark bit covers two cells, so there it may overcount.
+template <Heap::HeapType heapType> static size_t markedCellCount(const typename HeapConstants<heapType>::Block* block)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < BITMAP_WORDS; ++i)
+        count += bitCount(block->marked.bits[i]);
+    return min<size_t>(count << HeapConstants<heapType>::bitmapShift, block->usedCells);
+}
+
+static void removeBlock(CollectorHeap& heap, size_t block)
+{
+#if !DEBUG_COLLECTOR
+    freeBlock(heap.blocks[block]);
+#endif
+    // swap with the last block so we compact as we go
+    heap.blocks[block] = heap.blocks[heap.usedBlocks - 1];
+    heap.usedBlocks--;
+    if (heap.firstBlockWithPossibleSpace > block)
+        heap.firstBlockWithPossibleSpace = block;
+
+    if (heap.numBlocks > MIN_ARRAY_SIZE && heap.usedBlocks < heap.numBlocks / LOW_WATER_FACTOR) {
+        heap.numBlocks = heap.numBlocks / GROWTH_FACTOR; 
+        heap.blocks = (CollectorBlock**)fastRealloc(heap.blocks, heap.numBlocks * sizeof(CollectorBlock*));
+    }
+}
+
+template <Heap::HeapType heapType> void Heap::sweepBlock(CollectorBlock* block)
 {
     typedef typename HeapConstants<heapType>::Block Block;
     typedef typename HeapConstants<heapType>::Cell Cell;
 
     // SWEEP: delete everything with a zero refcount (garbage) and unmark everything else
     CollectorHeap& heap = heapType == Heap::PrimaryHeap ? primaryHeap : numberHeap;
+    Block* curBlock = (Block*)block;
+    ASSERT(curBlock->pendingSweep);
+
+    // The collection counted this block's survivors as markedCellCount; correct the heap totals by
+    // whatever the sweep actually keeps.
+    const size_t estimatedCells = markedCellCount<heapType>(curBlock);
     
-    size_t emptyBlocks = 0;
-    size_t numLiveObjects = heap.numLiveObjects;
+    size_t usedCells = curBlock->usedCells;
+    Cell* freeList = curBlock->freeList;
     
-    for (size_t block = 0; block < heap.usedBlocks; block++) {
-        Block* curBlock = (Block*)heap.blocks[block];
-        
-        size_t usedCells = curBlock->usedCells;
-        Cell* freeList = curBlock->freeList;
-        
-        if (usedCells == HeapConstants<heapType>::cellsPerBlock) {
-            // special case with a block where all cells are used -- testing indicates this happens often
-            for (size_t i = 0; i < HeapConstants<heapType>::cellsPerBlock; i++) {
-                if (!curBlock->marked.get(i >> HeapConstants<heapType>::bitmapShift)) {
-                    Cell* cell = curBlock->cells + i;
+    if (usedCells == HeapConstants<heapType>::cellsPerBlock) {
+        // special case with a block where all cells are used -- testing indicates this happens often
+        for (size_t i = 0; i < HeapConstants<heapType>::cellsPerBlock; i++) {
+            if (!curBlock->marked.get(i >> HeapConstants<heapType>::bitmapShift)) {
+                Cell* cell = curBlock->cells + i;
+                
+                if (heapType != Heap::NumberHeap) {
+                    JSCell* imp = reinterpret_cast<JSCell*>(cell);
+                    // special case for allocated but uninitialized object
+                    // (We don't need this check earlier because nothing prior this point 
+                    // assumes the object has a valid vptr.)
+                    if (cell->u.freeCell.zeroIfFree == 0)
+                        continue;
                     
+                    imp->~JSCell();
+                }
+                
+                --usedCells;
+                
+                // put cell on the free list
+                cell->u.freeCell.zeroIfFree = 0;
+                cell->u.freeCell.next = freeList - (cell + 1);
+                freeList = cell;
+            }
+        }
+    } else {
+        size_t minimumCellsToProcess = usedCells;
+        for (size_t i = 0; (i < minimumCellsToProcess) & (i < HeapConstants<heapType>::cellsPerBlock); i++) {
+            Cell* cell = curBlock->cells + i;
+            if (cell->u.freeCell.zeroIfFree == 0) {
+                ++minimumCellsToProcess;
+            } else {
+                if (!curBlock->marked.get(i >> HeapConstants<heapType>::bitmapShift)) {
                     if (heapType != Heap::NumberHeap) {
                         JSCell* imp = reinterpret_cast<JSCell*>(cell);
-                        // special case for allocated but uninitialized object
-                        // (We don't need this check earlier because nothing prior this point 
-                        // assumes the object has a valid vptr.)
-                        if (cell->u.freeCell.zeroIfFree == 0)
-                            continue;
-                        
                         imp->~JSCell();
                     }
-                    
                     --usedCells;
-                    --numLiveObjects;
                     
                     // put cell on the free list
                     cell->u.freeCell.zeroIfFree = 0;
-                    cell->u.freeCell.next = freeList - (cell + 1);
+                    cell->u.freeCell.next = freeList - (cell + 1); 
                     freeList = cell;
                 }
             }
-        } else {
-            size_t minimumCellsToProcess = usedCells;
-            for (size_t i = 0; (i < minimumCellsToProcess) & (i < HeapConstants<heapType>::cellsPerBlock); i++) {
-                Cell* cell = curBlock->cells + i;
-                if (cell->u.freeCell.zeroIfFree == 0) {
-                    ++minimumCellsToProcess;
-                } else {
-                    if (!curBlock->marked.get(i >> HeapConstants<heapType>::bitmapShift)) {
-                        if (heapType != Heap::NumberHeap) {
-                            JSCell* imp = reinterpret_cast<JSCell*>(cell);
-                            imp->~JSCell();
-                        }
-                        --usedCells;
-                        --numLiveObjects;
-                        
-                        // put cell on the free list
-                        cell->u.freeCell.zeroIfFree = 0;
-                        cell->u.freeCell.next = freeList - (cell + 1); 
-                        freeList = cell;
-                    }
-                }
-            }
         }
+    }
+    
+    curBlock->usedCells = static_cast<uint32_t>(usedCells);
+    curBlock->freeList = freeList;
+    curBlock->marked.clearAll();
+    curBlock->pendingSweep = false;
+
+    // Both totals move together so that the count of cells allocated since the collection is unchanged.
+    heap.numLiveObjects = heap.numLiveObjects + usedCells - estimatedCells;
+    heap.numLiveObjectsAtLastCollect = heap.numLiveObjectsAtLastCollect + usedCells - estimatedCells;
+}
+
+// Sweeps every block the last collection left behind, releasing all but SPARE_EMPTY_BLOCKS of the
+// empty ones. Called before marking, so the marks are clear and the conservative scan cannot find a
+// dead object that was never destroyed.
+template <Heap::HeapType heapType> size_t Heap::sweep()
+{
+    CollectorHeap& heap = heapType == Heap::PrimaryHeap ? primaryHeap : numberHeap;
+    
+    size_t emptyBlocks = 0;
+    size_t numLiveObjects = heap.numLiveObjects;
+    
+    for (size_t block = 0; block < heap.usedBlocks; block++) {
+        CollectorBlock* curBlock = heap.blocks[block];
+        if (curBlock->pendingSweep)
+            sweepBlock<heapType>(curBlock);
         
-        curBlock->usedCells = static_cast<uint32_t>(usedCells);
-        curBlock->freeList = freeList;
-        curBlock->marked.clearAll();
-        
-        if (usedCells == 0) {
+        if (curBlock->usedCells == 0) {
             emptyBlocks++;
             if (emptyBlocks > SPARE_EMPTY_BLOCKS) {
-#if !DEBUG_COLLECTOR
-                freeBlock((CollectorBlock*)curBlock);
-#endif
-                // swap with the last block so we compact as we go
-                heap.blocks[block] = heap.blocks[heap.usedBlocks - 1];
-                heap.usedBlocks--;
+                removeBlock(heap, block);
                 block--; // Don't move forward a step in this case
-                
-                if (heap.numBlocks > MIN_ARRAY_SIZE && heap.usedBlocks < heap.numBlocks / LOW_WATER_FACTOR) {
-                    heap.numBlocks = heap.numBlocks / GROWTH_FACTOR; 
-                    heap.blocks = (CollectorBlock**)fastRealloc(heap.blocks, heap.numBlocks * sizeof(CollectorBlock*));
-                }
             }
         }
     }
     
     if (heap.numLiveObjects != numLiveObjects)
         heap.firstBlockWithPossibleSpace = 0;
-        
+    heap.backgroundSweepIndex = 0;
+    return heap.numLiveObjects;
+}
+
+// After marking: flags every block for sweeping and sets the heap totals from the mark bits, leaving
+// the destructors to run as the allocator reaches each block.
+template <Heap::HeapType heapType> void Heap::scheduleSweep()
+{
+    typedef typename HeapConstants<heapType>::Block Block;
+
+    CollectorHeap& heap = heapType == Heap::PrimaryHeap ? primaryHeap : numberHeap;
+
+    size_t numLiveObjects = 0;
+    for (size_t block = 0; block < heap.usedBlocks; block++) {
+        Block* curBlock = (Block*)heap.blocks[block];
+        curBlock->pendingSweep = true;
+        numLiveObjects += markedCellCount<heapType>(curBlock);
+    }
+
     heap.numLiveObjects = numLiveObjects;
     heap.numLiveObjectsAtLastCollect = numLiveObjects;
     heap.extraCost = 0;
-    return numLiveObjects;
+    heap.firstBlockWithPossibleSpace = 0;
+    heap.backgroundSweepIndex = heap.usedBlocks;
+    heap.emptyBlocksKept = 0;
+}
+
+template <Heap::HeapType heapType> void Heap::sweepNextBlockInBackground()
+{
+    CollectorHeap& heap = heapType == Heap::PrimaryHeap ? primaryHeap : numberHeap;
+
+    // Stop short of the allocator's block; it sweeps everything from there on by itself.
+    while (heap.backgroundSweepIndex > heap.firstBlockWithPossibleSpace + 1) {
+        size_t block = --heap.backgroundSweepIndex;
+        CollectorBlock* curBlock = heap.blocks[block];
+        if (!curBlock->pendingSweep)
+            continue;
+
+        sweepBlock<heapType>(curBlock);
+        if (curBlock->usedCells == 0 && ++heap.emptyBlocksKept > SPARE_EMPTY_BLOCKS)
+            removeBlock(heap, block); // Everything past block is swept, so the block moved here needs nothing.
+        return;
+    }
+}
+
+bool Heap::sweepIfDead(JSValue* value)
+{
+    // Only primary heap cells have an identity worth caching.
+    if (JSImmediate::isImmediate(value) || value->isNumber())
+        return false;
+
+    JSCell* cell = value->asCell();
+    CollectorBlock* block = cellBlock(cell);
+    if (!block->pendingSweep || block->marked.get(cellOffset(cell)))
+        return false;
+
+    Heap* heap = block->heap;
+    ASSERT(heap->primaryHeap.operationInProgress == NoOperation);
+    heap->sweepBlock<PrimaryHeap>(block);
+    return true;
 }
     
 bool Heap::collect()
@@ -946,6 +1065,12 @@ bool Heap::collect()
     primaryHeap.operationInProgress = Collection;
     numberHeap.operationInProgress = Collection;
 
+    m_policy.willCollect();
+
+    // Finish sweeping after the previous collection; marking needs every mark bit clear.
+    sweep<PrimaryHeap>();
+    sweep<NumberHeap>();
+
     // MARK: first mark all referenced objects recursively starting out from the set of root objects
 
     markStackObjectsConservatively();
@@ -954,9 +1079,22 @@ bool Heap::collect()
     if (m_markListSet && m_markListSet->size())
         ArgList::markLists(*m_markListSet);
 
-    size_t originalLiveObjects = primaryHeap.numLiveObjects + numberHeap.numLiveObjects;
-    size_t numLiveObjects = sweep<PrimaryHeap>();
-    numLiveObjects += sweep<NumberHeap>();
+    const size_t primaryCellsBefore = primaryHeap.numLiveObjects;
+    const size_t numberCellsBefore = numberHeap.numLiveObjects;
+    const size_t primaryNewCells = primaryCellsBefore - primaryHeap.numLiveObjectsAtLastCollect + primaryHeap.extraCost;
+    const size_t numberNewCells = numberCellsBefore - numberHeap.numLiveObjectsAtLastCollect;
+
+    size_t originalLiveObjects = primaryCellsBefore + numberCellsBefore;
+    scheduleSweep<PrimaryHeap>();
+    scheduleSweep<NumberHeap>();
+    size_t numLiveObjects = primaryHeap.numLiveObjects + numberHeap.numLiveObjects;
+
+    const size_t heapBytes = (primaryHeap.usedBlocks + numberHeap.usedBlocks) * BLOCK_SIZE;
+    const size_t liveBytes = primaryHeap.numLiveObjects * CELL_SIZE + numberHeap.numLiveObjects * SMALL_CELL_SIZE;
+    const size_t bytesFreed = (primaryCellsBefore - primaryHeap.numLiveObjects) * CELL_SIZE + (numberCellsBefore - numberHeap.numLiveObjects) * SMALL_CELL_SIZE;
+    m_policy.didCollect(heapBytes, liveBytes, bytesFreed);
+    primaryHeap.collectionThreshold = m_policy.nextThreshold(primaryCellsBefore, primaryHeap.numLiveObjects, primaryNewCells, CELL_SIZE);
+    numberHeap.collectionThreshold = m_policy.nextThreshold(numberCellsBefore, numberHeap.numLiveObjects, numberNewCells, SMALL_CELL_SIZE);
   
     primaryHeap.operationInProgress = NoOperation;
     numberHeap.operationInProgress = NoOperation;
@@ -26,6 +26,7 @@
 #ifndef KJSCOLLECTOR_H_
 #define KJSCOLLECTOR_H_
 
+#include "CollectorPolicy.h"
 #include <wtf/FastAllocBase.h>
 #include <stddef.h>
 #include <string.h>
@@ -84,6 +85,13 @@ CollectorBlock** blocks;
         size_t numLiveObjects;
         size_t numLiveObjectsAtLastCollect;
         size_t extraCost;
+        size_t collectionThreshold; // New cells plus extra cost that trigger the next collection; see CollectorPolicy.
+
+        // Blocks are swept lazily: the allocator sweeps each one as it reaches it, and every time it
+        // moves on to another block it also sweeps one from the end of the array, releasing it if it
+        // turns out empty. Blocks at or past backgroundSweepIndex need no sweep.
+        size_t backgroundSweepIndex;
+        size_t emptyBlocksKept;
 
         OperationInProgress operationInProgress;
     };
@@ -144,6 +152,7 @@ public:
         void reportExtraMemoryCost(size_t cost);
 
         size_t size();
+        const CollectorStatistics& statistics() const { return m_policy.statistics(); }
 
         void protect(JSValue*);
         void unprotect(JSValue*);
@@ -164,6 +173,12 @@ public:
         static bool isCellMarked(const JSCell*);
         static void markCell(JSCell*);
 
+        // Caches that hold cells without marking them (the DOM wrapper maps and the like) must call
+        // this before handing a cached cell out again. If the last collection found the cell dead and
+        // its block has not been swept yet, it sweeps the block, which runs the cell's destructor and
+        // so drops it from the cache, and returns true.
+        static bool sweepIfDead(JSValue*);
+
         void markConservatively(void* start, void* end);
 
         HashSet<ArgList*>& markListSet() { if (!m_markListSet) m_markListSet = new HashSet<ArgList*>; return *m_markListSet; }
@@ -171,6 +186,9 @@ public:
     private:
         template <Heap::HeapType heapType> void* heapAllocate(size_t);
         template <Heap::HeapType heapType> size_t sweep();
+        template <Heap::HeapType heapType> void scheduleSweep();
+        template <Heap::HeapType heapType> void sweepBlock(CollectorBlock*);
+        template <Heap::HeapType heapType> void sweepNextBlockInBackground();
         static const CollectorBlock* cellBlock(const JSCell*);
         static CollectorBlock* cellBlock(JSCell*);
         static size_t cellOffset(const JSCell*);
@@ -194,6 +212,7 @@ public:
         ProtectCountSet protectedValues;
         HashSet<ArgList*>* m_markListSet;
         Machine* m_machine;
+        CollectorPolicy m_policy;
     };
 
     // tunable parameters
@@ -317,6 +336,7 @@ void operator delete[](void* p)
         CollectorCell* freeList;
         CollectorBitmap marked;
         Heap* heap;
+        bool pendingSweep; // Set by a collection; the unmarked cells are garbage that has not been destroyed yet.
     };
 
     class SmallCellCollectorBlock {
@@ -358,6 +378,7 @@ void operator delete[](void* p)
         SmallCollectorCell* freeList;
         CollectorBitmap marked;
         Heap* heap;
+        bool pendingSweep;
     };
 
     inline const CollectorBlock* Heap::cellBlock(const JSCell* cell)
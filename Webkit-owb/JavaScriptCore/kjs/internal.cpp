@@ -34,6 +34,7 @@
 #include "lexer.h"
 #include "nodes.h"
 #include "operations.h"
+#include <limits>
 #include <math.h>
 #include <stdio.h>
 #include <wtf/Assertions.h>
@@ -43,8 +44,112 @@
 
 namespace KJS {
 
+// ------------------------------ JSStringRope --------------------------------
+
+JSStringRope::JSStringRope(const Fiber& left, const Fiber& right)
+    : m_refCount(1)
+    , m_length(left.length() + right.length())
+    , m_left(left)
+    , m_right(right)
+{
+}
+
+bool JSStringRope::concatenate(Fiber& left, const Fiber& right)
+{
+    int leftLength = left.length();
+    int rightLength = right.length();
+    if (!rightLength)
+        return true;
+    if (!leftLength) {
+        left = right;
+        return true;
+    }
+    if (leftLength > std::numeric_limits<int>::max() - rightLength)
+        return false;
+
+    if (leftLength + rightLength < MinRopeLength) {
+        // Both sides are flat, since a rope is never shorter than MinRopeLength.
+        ASSERT(left.string && right.string);
+        UString result = UString(left.string) + UString(right.string);
+        if (result.isNull())
+            return false;
+        left = Fiber(result);
+        return true;
+    }
+
+    left = Fiber(adoptRef(new JSStringRope(left, right)));
+    return true;
+}
+
+void JSStringRope::deref()
+{
+    if (--m_refCount)
+        return;
+
+    // Releasing the root of a deep rope would otherwise recurse once per level.
+    Vector<JSStringRope*, 32> deadRopes;
+    deadRopes.append(this);
+    while (!deadRopes.isEmpty()) {
+        JSStringRope* rope = deadRopes.last();
+        deadRopes.removeLast();
+        Fiber* fibers[2] = { &rope->m_left, &rope->m_right };
+        for (int i = 0; i < 2; ++i) {
+            if (JSStringRope* child = fibers[i]->rope.release().releaseRef()) {
+                if (!--child->m_refCount)
+                    deadRopes.append(child);
+            }
+        }
+        delete rope;
+    }
+}
+
+UString JSStringRope::flatten() const
+{
+    // Appending the leaves in order lets UString::append grow the result
+    // in place, and reuse spare capacity at the end of the leftmost leaf.
+    UString result;
+    Vector<const Fiber*, 32> pending;
+    pending.append(&m_right);
+    pending.append(&m_left);
+    while (!pending.isEmpty()) {
+        const Fiber* fiber = pending.last();
+        pending.removeLast();
+        if (fiber->rope) {
+            pending.append(&fiber->rope->m_right);
+            pending.append(&fiber->rope->m_left);
+        } else if (result.isNull())
+            result = UString(fiber->string);
+        else
+            result.append(UString(fiber->string));
+    }
+    return result;
+}
+
 // ------------------------------ JSString ------------------------------------
 
+JSStringRope::Fiber JSString::fiber() const
+{
+    if (m_rope)
+        return JSStringRope::Fiber(m_rope);
+    return JSStringRope::Fiber(m_value);
+}
+
+void JSString::resolveRope() const
+{
+    ASSERT(m_rope);
+    m_value = m_rope->flatten();
+    m_rope = 0;
+    // The rope's cost was never reported; the flat copy is what the collector should see.
+    Heap::heap(const_cast<JSString*>(this))->reportExtraMemoryCost(m_value.cost());
+}
+
+JSString* jsString(ExecState* exec, const JSStringRope::Fiber& fiber)
+{
+    if (fiber.rope)
+        return new (exec) JSString(fiber.rope);
+    return jsString(exec, UString(fiber.string));
+}
+
 JSValue* JSString::toPrimitive(ExecState*, JSType) const
 {
   return const_cast<JSString*>(this);
@@ -53,28 +158,28 @@ JSValue* JSString::toPrimitive(ExecState*, JSType) const
 bool JSString::getPrimitiveNumber(ExecState*, double& number, JSValue*& value)
 {
     value = this;
-    number = m_value.toDouble();
+    number = JSString::value().toDouble();
     return false;
 }
 
 bool JSString::toBoolean(ExecState*) const
 {
-    return !m_value.isEmpty();
+    return length() != 0;
 }
 
 double JSString::toNumber(ExecState*) const
 {
-    return m_value.toDouble();
+    return value().toDouble();
 }
 
 UString JSString::toString(ExecState*) const
 {
-    return m_value;
+    return value();
 }
 
 UString JSString::toThisString(ExecState*) const
 {
-    return m_value;
+    return value();
 }
 
 JSString* JSString::toThisJSString(ExecState*)
@@ -99,7 +204,7 @@ JSObject* JSString::toThisObject(ExecState* exec) const
 
 JSValue* JSString::lengthGetter(ExecState* exec, const Identifier&, const PropertySlot& slot)
 {
-    return jsNumber(exec, static_cast<JSString*>(slot.slotBase())->value().size());
+    return jsNumber(exec, static_cast<JSString*>(slot.slotBase())->length());
 }
 
 JSValue* JSString::indexGetter(ExecState* exec, const Identifier&, const PropertySlot& slot)
@@ -31,6 +31,7 @@
 #include "JSFunction.h"
 #include "nodes.h"
 #include "NodeInfo.h"
+#include "TokenCache.h"
 #include <ctype.h>
 #include <limits.h>
 #include <string.h>
@@ -78,6 +79,8 @@ Lexer::Lexer(JSGlobalData* globalData)
     , next2(0)
     , next3(0)
     , m_globalData(globalData)
+    , m_recordTokens(0)
+    , m_replayTokens(0)
     , mainTable(KJS::mainTable)
 {
     m_buffer8.reserveCapacity(initialReadBufferCapacity);
@@ -148,6 +151,75 @@ void Lexer::setDone(State s)
 }
 
 int Lexer::lex(void* p1, void* p2)
+{
+  if (m_replayTokens)
+    return replayToken(p1, p2);
+
+  int token = scanToken(p1, p2);
+  if (m_recordTokens && token >= 0)
+    recordToken(token, p1);
+  return token;
+}
+
+int Lexer::replayToken(void* p1, void* p2)
+{
+  YYSTYPE* lvalp = static_cast<YYSTYPE*>(p1);
+  YYLTYPE* llocp = static_cast<YYLTYPE*>(p2);
+
+  const TokenStream::Token* entry = m_replayTokens->next();
+  if (!entry || entry->valueType == TokenStream::RegExpValue) {
+    // The stream does not match this parse; Parser::parse lexes the source instead.
+    error = true;
+    return -1;
+  }
+
+  yylineno = entry->line;
+  terminator = entry->terminator;
+  llocp->first_line = yylineno;
+  llocp->last_line = yylineno;
+
+  switch (entry->valueType) {
+  case TokenStream::IntValue:
+    lvalp->intValue = entry->intValue;
+    break;
+  case TokenStream::DoubleValue:
+    lvalp->doubleValue = entry->doubleValue;
+    break;
+  case TokenStream::IdentifierValue:
+    lvalp->ident = const_cast<KJS::Identifier*>(&m_replayTokens->identifier(entry->index));
+    break;
+  case TokenStream::StringValue:
+    lvalp->string = const_cast<UString*>(&m_replayTokens->string(entry->index));
+    break;
+  }
+  return entry->token;
+}
+
+void Lexer::recordToken(int token, const void* p1)
+{
+  const YYSTYPE* lvalp = static_cast<const YYSTYPE*>(p1);
+
+  switch (token) {
+  case IDENT:
+    m_recordTokens->appendToken(token, yylineno, terminator, *lvalp->ident);
+    break;
+  case STRING:
+    m_recordTokens->appendToken(token, yylineno, terminator, *lvalp->string);
+    break;
+  case NUMBER:
+    m_recordTokens->appendToken(token, yylineno, terminator, lvalp->doubleValue);
+    break;
+  case OPENBRACE:
+  case CLOSEBRACE:
+    m_recordTokens->appendToken(token, yylineno, terminator, lvalp->intValue);
+    break;
+  default:
+    m_recordTokens->appendToken(token, yylineno, terminator);
+    break;
+  }
+}
+
+int Lexer::scanToken(void* p1, void* p2)
 {
   YYSTYPE* lvalp = static_cast<YYSTYPE*>(p1);
   YYLTYPE* llocp = static_cast<YYLTYPE*>(p2);
@@ -549,7 +621,7 @@ int Lexer::lex(void* p1, void* p2)
     // Apply anonymous-function hack below (eat the identifier).
     if (eatNextIdentifier) {
       eatNextIdentifier = false;
-      token = lex(lvalp, llocp);
+      token = scanToken(lvalp, llocp);
       break;
     }
     lvalp->ident = makeIdentifier(m_buffer16);
@@ -832,6 +904,17 @@ void Lexer::record16(UChar c)
 
 bool Lexer::scanRegExp()
 {
+  if (m_replayTokens) {
+    const TokenStream::Token* entry = m_replayTokens->next();
+    if (!entry || entry->valueType != TokenStream::RegExpValue) {
+      error = true;
+      return false;
+    }
+    m_pattern = m_replayTokens->string(entry->index);
+    m_flags = m_replayTokens->string(entry->flagsIndex);
+    return true;
+  }
+
   m_buffer16.clear();
   bool lastWasEscape = false;
   bool inBrackets = false;
@@ -866,6 +949,8 @@ bool Lexer::scanRegExp()
   }
   m_flags = UString(m_buffer16);
 
+  if (m_recordTokens)
+    m_recordTokens->appendRegExp(m_pattern, m_flags);
   return true;
 }
 
@@ -891,6 +976,9 @@ void Lexer::clear()
 
     m_pattern = 0;
     m_flags = 0;
+
+    m_recordTokens = 0;
+    m_replayTokens = 0;
 }
 
 Identifier* Lexer::makeIdentifier(const Vector<UChar>& buffer)
@@ -38,6 +38,7 @@ namespace KJS {
 
   class Identifier;
   class RegExp;
+  class TokenStream;
 
   class Lexer : Noncopyable {
 public:
@@ -76,6 +77,11 @@ public:
     void setCode(int startingLineNumber, PassRefPtr<SourceProvider> source);
     int lex(void* lvalp, void* llocp);
 
+    // Record the tokens of the current parse into a stream, or take them from one instead of
+    // scanning the source. Both are reset by clear().
+    void recordTokens(TokenStream* tokens) { m_recordTokens = tokens; }
+    void replayTokens(TokenStream* tokens) { m_replayTokens = tokens; }
+
     int lineNo() const { return yylineno; }
 
     bool prevTerminator() const { return terminator; }
@@ -147,6 +153,9 @@ public:
 
     State state;
     void setDone(State);
+    int scanToken(void* lvalp, void* llocp);
+    int replayToken(void* lvalp, void* llocp);
+    void recordToken(int token, const void* lvalp);
     unsigned int pos;
     void shift(unsigned int p);
     void nextLine();
@@ -185,6 +194,9 @@ public:
     UString m_pattern;
     UString m_flags;
 
+    TokenStream* m_recordTokens;
+    TokenStream* m_replayTokens;
+
     const HashTable& mainTable;
   };
 
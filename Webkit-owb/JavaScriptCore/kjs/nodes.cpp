@@ -35,6 +35,7 @@
 #include "JSGlobalObject.h"
 #include "Parser.h"
 #include "PropertyNameArray.h"
+#include "RegExpCache.h"
 #include "RegExpObject.h"
 #include "debugger.h"
 #include "lexer.h"
@@ -342,6 +343,12 @@ RegisterID* StringNode::emitCode(CodeGenerator& generator, RegisterID* dst)
 
 // ------------------------------ RegExpNode -----------------------------------
 
+RegExpNode::RegExpNode(JSGlobalData* globalData, const UString& pattern, const UString& flags)
+    : ExpressionNode(globalData)
+    , m_regExp(globalData->regExpCache->lookupOrCreate(pattern, flags))
+{
+}
+
 RegisterID* RegExpNode::emitCode(CodeGenerator& generator, RegisterID* dst)
 {
     if (!m_regExp->isValid())
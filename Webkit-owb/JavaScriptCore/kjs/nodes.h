@@ -384,11 +384,7 @@ public:
 
     class RegExpNode : public ExpressionNode {
     public:
-        RegExpNode(JSGlobalData* globalData, const UString& pattern, const UString& flags) KJS_FAST_CALL
-            : ExpressionNode(globalData)
-            , m_regExp(RegExp::create(pattern, flags))
-        {
-        }
+        RegExpNode(JSGlobalData*, const UString& pattern, const UString& flags) KJS_FAST_CALL;
 
         virtual RegisterID* emitCode(CodeGenerator&, RegisterID* = 0) KJS_FAST_CALL;
 
@@ -2545,6 +2545,246 @@ static inline JSRegExp* returnError(ErrorCode errorcode, const char** errorPtr)
     return 0;
 }
 
+/*************************************************
+*       Recognize patterns with a fast path      *
+*************************************************/
+
+/* A handful of pattern shapes account for most of the regular expressions run
+by real pages: plain strings, ^-anchored strings, and runs of one character class
+such as \s+ or [a-z0-9]+. These are recognized directly from the pattern source
+and matched by jsRegExpExecute() without going through match(). The grammar
+accepted here is deliberately narrow; anything outside it, or anything whose
+meaning depends on case folding beyond ASCII, falls back to the bytecode. */
+
+struct FastPathInfo {
+    FastPathInfo()
+        : kind(NoFastPath)
+        , flags(0)
+        , length(0)
+        , dataSize(0)
+    {
+        memset(classBitmap, 0, sizeof(classBitmap));
+    }
+
+    RegExpFastPath kind;
+    unsigned char flags;
+    unsigned length;
+    size_t dataSize;
+    const UChar* literalStart;
+    const UChar* literalEnd;
+    unsigned char classBitmap[FAST_PATH_CLASS_BITMAP_SIZE];
+};
+
+static inline void addToClassBitmap(unsigned char* bitmap, int c)
+{
+    bitmap[c >> 3] |= 1 << (c & 7);
+}
+
+/* Returns the character a backslash escape stands for outside a class, or -1 if
+the escape is not a plain character (\d, \b, backreferences, \x and so on). */
+
+static int fastPathEscapedChar(UChar c)
+{
+    switch (c) {
+        case 'f':
+            return '\f';
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'v':
+            return '\v';
+    }
+    if (c < 128 && !isASCIIAlphanumeric(c))
+        return c;
+    return -1;
+}
+
+static bool addClassEscapeToBitmap(UChar c, unsigned char* bitmap)
+{
+    if (c != 'd' && c != 's' && c != 'w')
+        return false;
+    for (int i = 0; i < 128; ++i) {
+        if ((c == 'd' && isASCIIDigit(i)) || (c == 's' && isSpaceChar(i)) || (c == 'w' && isWordChar(i)))
+            addToClassBitmap(bitmap, i);
+    }
+    return true;
+}
+
+/* Parses a run of literal characters up to patternEnd, writing the (case folded)
+characters to out if it is non-null. Returns the number of characters, or -1 if
+the run contains anything but literals. */
+
+static int parseFastPathLiteral(const UChar* ptr, const UChar* patternEnd, bool ignoreCase, UChar* out)
+{
+    int length = 0;
+    while (ptr < patternEnd) {
+        int c = *ptr++;
+        switch (c) {
+            case '^': case '$': case '.': case '|': case '?': case '*': case '+':
+            case '(': case ')': case '[': case ']': case '{': case '}':
+                return -1;
+            case '\\':
+                if (ptr == patternEnd)
+                    return -1;
+                c = fastPathEscapedChar(*ptr++);
+                if (c < 0)
+                    return -1;
+                break;
+        }
+        if (ignoreCase) {
+            if (c >= 128)
+                return -1;
+            c = foldASCIICase(c);
+        }
+        if (out)
+            out[length] = c;
+        ++length;
+    }
+    return length;
+}
+
+/* Parses one class item: a character, a range or one of \d, \s and \w, adding
+it to the bitmap. Only ASCII members are accepted. */
+
+static bool parseFastPathClassItem(const UChar*& ptr, const UChar* patternEnd, unsigned char* bitmap)
+{
+    int first = *ptr++;
+    if (first == '\\') {
+        if (ptr == patternEnd)
+            return false;
+        if (addClassEscapeToBitmap(*ptr, bitmap)) {
+            ++ptr;
+            return true;
+        }
+        first = fastPathEscapedChar(*ptr++);
+    } else if (first == '[')
+        first = -1;
+    if (first < 0 || first >= 128)
+        return false;
+
+    int last = first;
+    if (ptr + 1 < patternEnd && *ptr == '-' && ptr[1] != ']') {
+        last = ptr[1];
+        ptr += 2;
+        if (last == '\\') {
+            if (ptr == patternEnd)
+                return false;
+            last = fastPathEscapedChar(*ptr++);
+        } else if (last == '[')
+            last = -1;
+        if (last < first || last >= 128)
+            return false;
+    }
+    for (int c = first; c <= last; ++c)
+        addToClassBitmap(bitmap, c);
+    return true;
+}
+
+static void classifyFastPath(const UChar* pattern, int patternLength, unsigned options, FastPathInfo& info)
+{
+    const UChar* ptr = pattern;
+    const UChar* patternEnd = pattern + patternLength;
+    bool ignoreCase = options & IgnoreCaseOption;
+
+    if (ptr < patternEnd && *ptr == '^') {
+        if (options & MatchAcrossMultipleLinesOption)
+            return;
+        info.flags |= FAST_PATH_ANCHORED;
+        ++ptr;
+    }
+
+    int literalLength = parseFastPathLiteral(ptr, patternEnd, ignoreCase, 0);
+    if (literalLength >= 0) {
+        info.kind = LiteralFastPath;
+        info.length = literalLength;
+        info.literalStart = ptr;
+        info.literalEnd = patternEnd;
+        info.dataSize = literalLength * sizeof(UChar);
+        if (!(info.flags & FAST_PATH_ANCHORED) && literalLength >= FAST_PATH_MIN_SHIFT_TABLE_LENGTH) {
+            info.flags |= FAST_PATH_SHIFT_TABLE;
+            info.dataSize += 256;
+        }
+        return;
+    }
+
+    /* A single class atom followed by +. */
+    if (patternEnd - ptr < 2 || patternEnd[-1] != '+')
+        return;
+    const UChar* classEnd = patternEnd - 1;
+    if (*ptr == '\\' && classEnd - ptr == 2) {
+        UChar c = ptr[1];
+        if (isASCIIUpper(c)) {
+            info.flags |= FAST_PATH_NEGATED_CLASS;
+            c = toASCIILower(c);
+        }
+        if (!addClassEscapeToBitmap(c, info.classBitmap))
+            return;
+    } else if (*ptr == '[' && classEnd[-1] == ']') {
+        ++ptr;
+        if (ptr < classEnd && *ptr == '^') {
+            info.flags |= FAST_PATH_NEGATED_CLASS;
+            ++ptr;
+        }
+        const UChar* itemsEnd = classEnd - 1;
+        if (ptr == itemsEnd)
+            return;
+        while (ptr < itemsEnd) {
+            if (*ptr == ']' || !parseFastPathClassItem(ptr, itemsEnd, info.classBitmap))
+                return;
+        }
+        if (ptr != itemsEnd)
+            return;
+    } else
+        return;
+
+    /* Caseless classes containing letters also match non-ASCII case variants. */
+    if (ignoreCase) {
+        for (int c = 'A'; c <= 'z'; ++c) {
+            if (isASCIIAlpha(c) && (info.classBitmap[c >> 3] & (1 << (c & 7))))
+                return;
+        }
+    }
+
+    info.kind = ClassRepeatFastPath;
+    info.length = 1;
+    info.dataSize = FAST_PATH_CLASS_BITMAP_SIZE;
+}
+
+static void storeFastPath(JSRegExp* re, const FastPathInfo& info, size_t offset, bool ignoreCase)
+{
+    re->fastPath = info.kind;
+    re->fastPathFlags = info.flags;
+    re->fastPathLength = info.length;
+    re->fastPathOffset = offset;
+    if (info.kind == NoFastPath)
+        return;
+
+    char* data = reinterpret_cast<char*>(re) + offset;
+    if (info.kind == ClassRepeatFastPath) {
+        memcpy(data, info.classBitmap, FAST_PATH_CLASS_BITMAP_SIZE);
+        return;
+    }
+
+    UChar* literal = reinterpret_cast<UChar*>(data);
+    parseFastPathLiteral(info.literalStart, info.literalEnd, ignoreCase, literal);
+    if (!(info.flags & FAST_PATH_SHIFT_TABLE))
+        return;
+
+    /* Boyer-Moore-Horspool shifts, indexed by the low byte of the character at
+     the end of the window. Characters sharing a low byte share the smallest
+     shift, which keeps the table small and is always safe. */
+    unsigned char* shiftTable = reinterpret_cast<unsigned char*>(literal + info.length);
+    memset(shiftTable, info.length < 255 ? info.length : 255, 256);
+    for (unsigned i = 0; i + 1 < info.length; ++i) {
+        unsigned shift = info.length - 1 - i;
+        if (shift < 256)
+            shiftTable[literal[i] & 0xFF] = shift;
+    }
+}
+
 JSRegExp* jsRegExpCompile(const UChar* pattern, int patternLength,
                 JSRegExpIgnoreCaseOption ignoreCase, JSRegExpMultilineOption multiline,
                 unsigned* numSubpatterns, const char** errorPtr)
@@ -2573,12 +2813,22 @@ JSRegExp* jsRegExpCompile(const UChar* pattern, int patternLength,
     size_t stringOffset = (size + sizeof(UChar) - 1) / sizeof(UChar) * sizeof(UChar);
     size = stringOffset + patternLength * sizeof(UChar);
 #endif
+
+    unsigned options = (ignoreCase ? IgnoreCaseOption : 0) | (multiline ? MatchAcrossMultipleLinesOption : 0);
+    FastPathInfo fastPath;
+    classifyFastPath(pattern, patternLength, options, fastPath);
+    size_t fastPathOffset = 0;
+    if (fastPath.kind != NoFastPath) {
+        fastPathOffset = (size + sizeof(UChar) - 1) / sizeof(UChar) * sizeof(UChar);
+        size = fastPathOffset + fastPath.dataSize;
+    }
+
 	JSRegExp* re = reinterpret_cast<JSRegExp*>(EAWEBKIT_NEW("JSRegExp") char[size]);//;WTF::fastNewArray<char>(size));
     
     if (!re)
         return returnError(ERR13, errorPtr);
     
-    re->options = (ignoreCase ? IgnoreCaseOption : 0) | (multiline ? MatchAcrossMultipleLinesOption : 0);
+    re->options = options;
     
     /* The starting points of the name/number translation table and of the code are
      passed around in the compile data block. */
@@ -2679,6 +2929,8 @@ JSRegExp* jsRegExpCompile(const UChar* pattern, int patternLength,
     memcpy(reinterpret_cast<char*>(re) + stringOffset, pattern, patternLength * 2);
 #endif
 
+    storeFastPath(re, fastPath, fastPathOffset, ignoreCase);
+
     if (numSubpatterns)
         *numSubpatterns = re->topBracket;
     return re;
@@ -1955,6 +1955,118 @@ static bool tryRequiredByteOptimization(const UChar*& subjectPtr, const UChar* e
     return false;
 }
 
+/*************************************************
+*        Match patterns with a fast path         *
+*************************************************/
+
+/* These handle the pattern shapes recognized by classifyFastPath() in
+pcre_compile.cpp. None of them have subpatterns, so a match only needs to
+report its start and end. */
+
+static inline UChar fastPathChar(UChar c, bool ignoreCase)
+{
+    return ignoreCase ? foldASCIICase(c) : c;
+}
+
+static inline bool literalMatchesAt(const UChar* subject, const UChar* literal, int literalLength, bool ignoreCase)
+{
+    for (int i = 0; i < literalLength; ++i) {
+        if (fastPathChar(subject[i], ignoreCase) != literal[i])
+            return false;
+    }
+    return true;
+}
+
+static int findLiteral(const JSRegExp* re, const UChar* subject, int length, int startOffset)
+{
+    const UChar* literal = reinterpret_cast<const UChar*>(reinterpret_cast<const char*>(re) + re->fastPathOffset);
+    int literalLength = re->fastPathLength;
+    bool ignoreCase = re->options & IgnoreCaseOption;
+    int lastStart = length - literalLength;
+
+    if (startOffset > lastStart)
+        return -1;
+    if (re->fastPathFlags & FAST_PATH_ANCHORED)
+        return literalMatchesAt(subject + startOffset, literal, literalLength, ignoreCase) ? startOffset : -1;
+    if (!literalLength)
+        return startOffset;
+
+    if (re->fastPathFlags & FAST_PATH_SHIFT_TABLE) {
+        const unsigned char* shiftTable = reinterpret_cast<const unsigned char*>(literal + literalLength);
+        int lastIndex = literalLength - 1;
+        UChar lastChar = literal[lastIndex];
+        for (int position = startOffset; position <= lastStart; ) {
+            UChar c = fastPathChar(subject[position + lastIndex], ignoreCase);
+            if (c == lastChar && literalMatchesAt(subject + position, literal, lastIndex, ignoreCase))
+                return position;
+            position += shiftTable[c & 0xFF];
+        }
+        return -1;
+    }
+
+    UChar firstChar = literal[0];
+    for (int position = startOffset; position <= lastStart; ++position) {
+        if (fastPathChar(subject[position], ignoreCase) == firstChar
+                && literalMatchesAt(subject + position + 1, literal + 1, literalLength - 1, ignoreCase))
+            return position;
+    }
+    return -1;
+}
+
+static inline bool classContains(const unsigned char* bitmap, bool negated, UChar c)
+{
+    bool inBitmap = c < 128 && (bitmap[c >> 3] & (1 << (c & 7)));
+    return inBitmap != negated;
+}
+
+static int findClassRun(const JSRegExp* re, const UChar* subject, int length, int startOffset, int& matchEnd)
+{
+    const unsigned char* bitmap = reinterpret_cast<const unsigned char*>(re) + re->fastPathOffset;
+    bool negated = re->fastPathFlags & FAST_PATH_NEGATED_CLASS;
+
+    int position = startOffset;
+    if (re->fastPathFlags & FAST_PATH_ANCHORED) {
+        if (position >= length || !classContains(bitmap, negated, subject[position]))
+            return -1;
+    } else {
+        while (position < length && !classContains(bitmap, negated, subject[position]))
+            ++position;
+        if (position == length)
+            return -1;
+    }
+
+    int matchStart = position;
+    while (position < length && classContains(bitmap, negated, subject[position]))
+        ++position;
+    matchEnd = position;
+    return matchStart;
+}
+
+static int matchFastPath(const JSRegExp* re, const UChar* subject, int length, int startOffset, int* offsets, int offsetCount)
+{
+    /* ^ without the multiline flag only matches at the start of the subject. */
+    if (startOffset > length || ((re->fastPathFlags & FAST_PATH_ANCHORED) && startOffset))
+        return JSRegExpErrorNoMatch;
+
+    int matchStart;
+    int matchEnd;
+    if (re->fastPath == LiteralFastPath) {
+        matchStart = findLiteral(re, subject, length, startOffset);
+        matchEnd = matchStart + re->fastPathLength;
+    } else {
+        ASSERT(re->fastPath == ClassRepeatFastPath);
+        matchStart = findClassRun(re, subject, length, startOffset, matchEnd);
+    }
+
+    if (matchStart < 0)
+        return JSRegExpErrorNoMatch;
+    if (offsetCount < 2)
+        return 0;
+    offsets[0] = matchStart;
+    offsets[1] = matchEnd;
+    return 1;
+}
+
 int jsRegExpExecute(const JSRegExp* re,
                     const UChar* subject, int length, int start_offset, int* offsets,
                     int offsetCount)
@@ -1966,6 +2078,9 @@ int jsRegExpExecute(const JSRegExp* re,
 
     HistogramTimeLogger logger(re);
 
+    if (re->fastPath != NoFastPath)
+        return matchFastPath(re, subject, length, start_offset, offsets, offsetCount);
+
     MatchData matchBlock;
     matchBlock.startSubject = subject;
     matchBlock.endSubject = matchBlock.startSubject + length;
@@ -187,6 +187,33 @@ enum RegExpOptions {
     MatchAcrossMultipleLinesOption = 0x00000002
 };
 
+/* Patterns simple enough to be matched without running the bytecode. They are
+recognized from the pattern source by jsRegExpCompile(); the data the matcher
+needs is stored after the compiled code, at fastPathOffset. The bytecode is
+still compiled so that error reporting and subpattern counts are unchanged. */
+
+enum RegExpFastPath {
+    NoFastPath,
+    LiteralFastPath,          /* literal UChars, plus a BMH shift table if long enough */
+    ClassRepeatFastPath       /* one ASCII class repeated with +, as a 128-bit bitmap */
+};
+
+#define FAST_PATH_ANCHORED       0x01   /* pattern starts with ^ (single-line only) */
+#define FAST_PATH_NEGATED_CLASS  0x02   /* class matches everything not in the bitmap */
+#define FAST_PATH_SHIFT_TABLE    0x04   /* literal is followed by a 256 byte shift table */
+
+#define FAST_PATH_MIN_SHIFT_TABLE_LENGTH 4
+#define FAST_PATH_CLASS_BITMAP_SIZE 16
+
+/* Case folding used by the literal fast path. Only ASCII letters are folded,
+which is what OP_ASCII_LETTER_IGNORING_CASE does; patterns containing other
+letters are not given a fast path when ignoring case. */
+
+static inline UChar foldASCIICase(UChar c)
+{
+    return (c >= 'A' && c <= 'Z') ? c | 0x20 : c;
+}
+
 /* Flags added to firstByte or reqByte; a "non-literal" item is either a
 variable-length repeat, or a anything other than literal characters. */
 
@@ -334,6 +361,11 @@ struct JSRegExp/*: public WTF::FastAllocBase*/ {
     unsigned short firstByte;
     unsigned short reqByte;
 
+    unsigned char fastPath;
+    unsigned char fastPathFlags;
+    unsigned fastPathLength;
+    unsigned fastPathOffset;
+
 #if REGEXP_HISTOGRAM
     size_t stringOffset;
     size_t stringLength;
@@ -145,7 +145,11 @@ void ScriptInterpreter::staticFinalize()
 
 DOMObject* ScriptInterpreter::getDOMObject(void* objectHandle) 
 {
-    return domObjects().get(objectHandle);
+    DOMObject* wrapper = domObjects().get(objectHandle);
+    // A wrapper the last collection found dead takes itself out of the map when its block is swept.
+    if (wrapper && Heap::sweepIfDead(wrapper))
+        return domObjects().get(objectHandle);
+    return wrapper;
 }
 
 void ScriptInterpreter::putDOMObject(void* objectHandle, DOMObject* wrapper) 
@@ -162,8 +166,11 @@ void ScriptInterpreter::forgetDOMObject(void* objectHandle)
 JSNode* ScriptInterpreter::getDOMNodeForDocument(Document* document, WebCore::Node* node)
 {
     if (!document)
-        return static_cast<JSNode*>(domObjects().get(node));
-    return document->wrapperCache().get(node);
+        return static_cast<JSNode*>(getDOMObject(node));
+    JSNode* wrapper = document->wrapperCache().get(node);
+    if (wrapper && Heap::sweepIfDead(wrapper))
+        return document->wrapperCache().get(node);
+    return wrapper;
 }
 
 void ScriptInterpreter::forgetDOMNodeForDocument(Document* document, WebCore::Node* node)
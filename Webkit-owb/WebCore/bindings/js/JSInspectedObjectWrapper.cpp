@@ -85,7 +85,8 @@ JSValue* JSInspectedObjectWrapper::wrap(ExecState* unwrappedExec, JSValue* unwra
 
     if (WrapperMap* wrapperMap = wrappers().get(unwrappedExec->dynamicGlobalObject()))
         if (JSInspectedObjectWrapper* wrapper = wrapperMap->get(unwrappedObject))
-            return wrapper;
+            if (!Heap::sweepIfDead(wrapper))
+                return wrapper;
 
     JSValue* prototype = unwrappedObject->prototype();
     JSValue* wrappedPrototype = prototype ? wrap(unwrappedExec, prototype) : 0;
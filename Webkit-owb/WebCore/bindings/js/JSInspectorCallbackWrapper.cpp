@@ -53,7 +53,8 @@ JSValue* JSInspectorCallbackWrapper::wrap(ExecState* unwrappedExec, JSValue* unw
         return unwrappedObject;
 
     if (JSInspectorCallbackWrapper* wrapper = wrappers().get(unwrappedObject))
-        return wrapper;
+        if (!Heap::sweepIfDead(wrapper))
+            return wrapper;
 
     JSValue* prototype = unwrappedObject->prototype();
     JSValue* wrappedPrototype = prototype ? wrap(unwrappedExec, prototype) : 0;
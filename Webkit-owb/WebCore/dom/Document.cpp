@@ -115,6 +115,7 @@
 #include "ScriptController.h"
 #include "StaticConstructors.h"
 #include <EAWebKit/internal/EAWebKitViewHelper.h> // For multiview support
+#include <EAWebKit/EAWebKitView.h>  // For user notify
 
 #if ENABLE(DATABASE)
 #include "Database.h"
@@ -161,6 +162,10 @@ static const int cLayoutScheduleThreshold = 250;
 // Use 1 to represent the document's default form.
 static HTMLFormElement* const defaultForm = reinterpret_cast<HTMLFormElement*>(1);
 
+// Style recalcs of all documents currently in progress. Only the outermost one is reported to the process 
+// trace, so that the recalc of a child frame's document within its parent's isn't counted twice.
+static int sStyleRecalcTraceDepth = 0;
+
 // Golden ratio - arbitrary start value to avoid mapping all 0's to all 0's
 static const unsigned PHI = 0x9e3779b9U;
 
@@ -1109,6 +1114,8 @@ void Document::recalcStyle(StyleChange change)
         return; // Guard against re-entrancy. -dwh
         
     m_inStyleRecalc = true;
+    if (!sStyleRecalcTraceDepth++)
+        NOTIFY_PROCESS_STATUS(EA::WebKit::kVProcessTypeStyleRecalc, EA::WebKit::kVProcessStatusStarted);
     suspendPostAttachCallbacks();
     
     ASSERT(!renderer() || renderArena());
@@ -1178,6 +1185,8 @@ bail_out:
     setDocumentChanged(false);
     
     resumePostAttachCallbacks();
+    if (!--sStyleRecalcTraceDepth)
+        NOTIFY_PROCESS_STATUS(EA::WebKit::kVProcessTypeStyleRecalc, EA::WebKit::kVProcessStatusEnded);
     m_inStyleRecalc = false;
     
     // If we wanted to call implicitClose() during recalcStyle, do so now that we're finished.
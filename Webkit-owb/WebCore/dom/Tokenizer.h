@@ -33,6 +33,7 @@
 namespace WebCore {
 
     class SegmentedString;
+    class TextResourceDecoder;
 
     class Tokenizer/*: public WTF::FastAllocBase*/ {
     public:
@@ -58,6 +59,11 @@ namespace WebCore {
         virtual bool wantsRawData() const { return false; }
         virtual bool writeRawData(const char* data, int len) { return false; }
 
+        // Gives a tokenizer that can read the document's encoding itself the chance to take the
+        // bytes before the loader runs them through the TextResourceDecoder. Returns false if the
+        // data was not taken, in which case the loader decodes it and calls write() as usual.
+        virtual bool writeUndecodedData(const char* data, int len, TextResourceDecoder*) { return false; }
+
         bool inViewSourceMode() const { return m_inViewSourceMode; }
         void setInViewSourceMode(bool mode) { m_inViewSourceMode = mode; }
 
@@ -50,6 +50,7 @@
 #include "SystemTime.h"
 #include "ScriptController.h"
 #include <wtf/ASCIICType.h>
+#include <EAWebKit/EAWebKitView.h>  // For user notify
 
 #include "HTMLEntityNames.c"
 
@@ -95,6 +96,10 @@ static const char textareaEnd [] = "</textarea";
 static const char titleEnd [] = "</title";
 static const char iframeEnd [] = "</iframe";
 
+// Writes to all tokenizers currently in progress. Only the outermost one is reported to the process trace,
+// so that a write into another document's tokenizer from within a script isn't counted twice.
+static int sHTMLParseTraceDepth = 0;
+
 // Full support for MS Windows extensions to Latin-1.
 // Technically these extensions should only be activated for pages
 // marked "windows-1252" or "cp1252", but
@@ -1642,6 +1647,9 @@ bool HTMLTokenizer::write(const SegmentedString& str, bool appendData)
 
     bool wasInWrite = inWrite;
     inWrite = true;
+
+    if (!sHTMLParseTraceDepth++)
+        NOTIFY_PROCESS_STATUS(EA::WebKit::kVProcessTypeHTMLParse, EA::WebKit::kVProcessStatusStarted);
     
 #ifdef INSTRUMENT_LAYOUT_SCHEDULING
     if (!m_doc->ownerElement())
@@ -1772,6 +1780,9 @@ bool HTMLTokenizer::write(const SegmentedString& str, bool appendData)
        OWB_PRINTF("Ending write at time %d\n", m_doc->elapsedTime());
 #endif
     
+    if (!--sHTMLParseTraceDepth)
+        NOTIFY_PROCESS_STATUS(EA::WebKit::kVProcessTypeHTMLParse, EA::WebKit::kVProcessStatusEnded);
+
     inWrite = wasInWrite;
 
     m_state = state;
@@ -79,8 +79,20 @@ void CachedCSSStyleSheet::data(PassRefPtr<SharedBuffer> data, bool allDataReceiv
     m_data = data;
     setEncodedSize(m_data.get() ? m_data->size() : 0);
     if (m_data.get()) {
-        m_sheet = m_decoder->decode(m_data->data(), encodedSize());
-        m_sheet += m_decoder->flush();
+        // Decode segment by segment; the decoder keeps partial characters between calls.
+        // The pieces are gathered in one buffer, as appending to a String copies it every time.
+        Vector<UChar> characters;
+        const char* segment;
+        unsigned position = 0;
+        characters.reserveCapacity(m_data->size());
+        while (unsigned length = m_data->getSomeData(segment, position)) {
+            String decoded = m_decoder->decode(segment, length);
+            characters.append(decoded.characters(), decoded.length());
+            position += length;
+        }
+        String decoded = m_decoder->flush();
+        characters.append(decoded.characters(), decoded.length());
+        m_sheet = String::adopt(characters);
     }
     m_loading = false;
     checkNotify();
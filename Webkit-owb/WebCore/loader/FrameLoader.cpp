@@ -1009,6 +1009,14 @@ void FrameLoader::write(const char* str, int len, bool flush)
         m_frame->document()->setDecoder(m_decoder.get());
     }
 
+    if (tokenizer && tokenizer->writeUndecodedData(str, len, m_decoder.get())) {
+        if (!m_receivedData) {
+            m_receivedData = true;
+            m_frame->document()->recalcStyle(Node::Force);
+        }
+        return;
+    }
+
     String decoded = m_decoder->decode(str, len);
     if (flush)
         decoded += m_decoder->flush();
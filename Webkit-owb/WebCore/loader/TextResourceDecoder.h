@@ -51,6 +51,7 @@ public:
 
     void setEncoding(const TextEncoding&, EncodingSource);
     const TextEncoding& encoding() const { return m_decoder.encoding(); }
+    EncodingSource encodingSource() const { return m_source; }
 
     String decode(const char* data, size_t length);
     String flush();
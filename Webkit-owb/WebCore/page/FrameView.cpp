@@ -49,11 +49,16 @@
 #include "RenderTheme.h"
 #include "RenderView.h"
 #include <EAWebKit/internal/EAWebKitViewHelper.h> // For multiview support
+#include <EAWebKit/EAWebKitView.h>  // For user notify
 
 namespace WebCore {
 
 using namespace HTMLNames;
 
+// Layouts of all frames currently in progress. Only the outermost one is reported to the process trace, 
+// so that the layout of a child frame within its parent's isn't counted twice.
+static int sLayoutTraceDepth = 0;
+
 struct ScheduledEvent/*: public WTF::FastAllocBase*/ {
     RefPtr<Event> m_event;
     RefPtr<EventTargetNode> m_eventTarget;
@@ -406,6 +411,8 @@ void FrameView::layout(bool allowSubtree)
     }
 
     d->m_nestedLayoutCount++;
+    if (!sLayoutTraceDepth++)
+        NOTIFY_PROCESS_STATUS(EA::WebKit::kVProcessTypeLayout, EA::WebKit::kVProcessStatusStarted);
 
     ScrollbarMode hMode = d->m_hmode;
     ScrollbarMode vMode = d->m_vmode;
@@ -543,6 +550,8 @@ void FrameView::layout(bool allowSubtree)
         ASSERT(d->m_enqueueEvents);
     }
 
+    if (!--sLayoutTraceDepth)
+        NOTIFY_PROCESS_STATUS(EA::WebKit::kVProcessTypeLayout, EA::WebKit::kVProcessStatusEnded);
     d->m_nestedLayoutCount--;
 }
 
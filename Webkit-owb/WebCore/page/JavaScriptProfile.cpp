@@ -248,7 +248,7 @@ JSValue* toJS(ExecState* exec, Profile* profile)
         return jsNull();
 
     JSValue* profileWrapper = profileCache().get(profile);
-    if (profileWrapper)
+    if (profileWrapper && !Heap::sweepIfDead(profileWrapper))
         return profileWrapper;
 
     profile->ref();
@@ -228,7 +228,7 @@ JSValue* toJS(ExecState* exec, ProfileNode* ProfileNode)
         return jsNull();
 
     JSValue* ProfileNodeWrapper = ProfileNodeCache().get(ProfileNode);
-    if (ProfileNodeWrapper)
+    if (ProfileNodeWrapper && !Heap::sweepIfDead(ProfileNodeWrapper))
         return ProfileNodeWrapper;
 
     ProfileNode->ref();
@@ -137,6 +137,7 @@
 //bal-internationalization
 #include "TextEncodingRegistry.h"
 #include "TextEncoding.h"
+#include "TextBreakIterator.h"
 
 //bal-network
 #include "CookieJar.h"
@@ -2780,8 +2781,6 @@ void WebView::staticFinalizePart2()
     //none
     //-
 
-    Font::staticFinalize(); // 4/27/09 CSidhall - Added for leak collector - This needs to be done before the font cache
-
     //static and global from bal-fonts project
     FontCache::staticFinalize();
     GlyphPageTreeNode::staticFinalize();
@@ -2833,6 +2832,7 @@ void WebView::staticFinalizePart2()
 
     //static and global from bal-internationalization project
     releaseBaseTextCodecMaps();
+    staticFinalizeTextBreakIterators();
     TextEncoding::staticFinalize();
     OWBAL::StringImpl::staticFinalize();
     StyledElement::staticFinalize();        // 4/14/09 CSidhall - Order dependent! Needs to be called before AtomicString::staticFinalize
@@ -0,0 +1,334 @@
+/*
+Copyright (C) 2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// EAPageLoadBenchmark.cpp
+//
+// Standalone page load benchmark. It loads each page of the corpus in
+// benchmark/pages through the file transport into an offscreen View, ticking
+// it until the load completes, and writes one JSON record per page with the
+// time spent in each phase as reported by GetProcessTraceSummary().
+//
+// Usage: EAPageLoadBenchmark [corpus directory] [iterations] [output.json]
+// The corpus directory defaults to benchmark\pages below the current
+// directory. Without an output path the JSON goes to stdout.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <EAWebKit/EAWebKit.h>
+#include <EAWebKit/EAWebKitView.h>
+#include <EAWebKit/EAWebKitViewNotification.h>
+#include <EAWebKit/EAWebKitProcessTrace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#endif
+
+
+namespace
+{
+    const int    kViewWidth     = 1024;
+    const int    kViewHeight    = 768;
+    const int    kSettleTicks   = 4;       // Ticks after the load completes, so that pending layout and paint timers fire.
+    const double kLoadTimeout   = 30.0;    // Seconds before a page that never completes is reported as failed.
+    const int    kPathCapacity  = 512;
+
+    // The bundled corpus. Each page stresses mostly one phase.
+    const char* const kPages[] =
+    {
+        "text.html",        // Long flowing text: parse, line layout and glyph drawing.
+        "table.html",       // A large table: table layout.
+        "style.html",       // Many rules and selectors: style sheet parse and style recalc.
+        "script.html",      // DOM built from script: JS and repeated style/layout.
+        "frames.html",      // Child frames written from the parent's script: nested parse, style and layout.
+        "images.html"       // Scaled and tiled images: decode and image drawing.
+    };
+
+    const int kPageCount = (int)(sizeof(kPages) / sizeof(kPages[0]));
+
+    // The reported phases. A phase may run inside another one (layout is often run from
+    // paint, and decode from image drawing), so the phases don't add up to the total.
+    struct Phase
+    {
+        const char*              mpName;
+        EA::WebKit::VProcessType mType;
+    };
+
+    const Phase kPhases[] =
+    {
+        { "parse",      EA::WebKit::kVProcessTypeHTMLParse },
+        { "cssParse",   EA::WebKit::kVProcessTypeCSSParseSheet },
+        { "style",      EA::WebKit::kVProcessTypeStyleRecalc },
+        { "layout",     EA::WebKit::kVProcessTypeLayout },
+        { "paint",      EA::WebKit::kVProcessTypeDraw },
+        { "jsParse",    EA::WebKit::kVProcessTypeJavaScriptParser },
+        { "jsExecute",  EA::WebKit::kVProcessTypeJavaScriptExecute },
+        { "decode",     EA::WebKit::kVProcessTypeImageDecoder }
+    };
+
+    const int kPhaseCount = (int)(sizeof(kPhases) / sizeof(kPhases[0]));
+
+
+    // The Windows DLL only exports CreateEAWebkitInstance (see EAWebkit_Windows.def), so it is looked up at runtime.
+    EA::WebKit::IEAWebkit* CreateWebKit()
+    {
+        #if defined(_WIN32)
+            typedef EA::WebKit::IEAWebkit* (*CreateEAWebkitInstanceFunction)(void);
+
+            #if defined(_DEBUG)
+                HMODULE hModule = LoadLibraryA("EAWebKit_d.dll");
+            #else
+                HMODULE hModule = LoadLibraryA("EAWebkit.dll");
+            #endif
+            if(!hModule)
+                return NULL;
+
+            CreateEAWebkitInstanceFunction pCreate = (CreateEAWebkitInstanceFunction)GetProcAddress(hModule, "CreateEAWebkitInstance");
+            return pCreate ? pCreate() : NULL;
+        #else
+            return CreateEAWebkitInstance();
+        #endif
+    }
+
+
+    double GetSeconds()
+    {
+        #if defined(_WIN32)
+            LARGE_INTEGER frequency, counter;
+            QueryPerformanceFrequency(&frequency);
+            QueryPerformanceCounter(&counter);
+            return (double)counter.QuadPart / (double)frequency.QuadPart;
+        #else
+            return (double)clock() / (double)CLOCKS_PER_SEC;
+        #endif
+    }
+
+
+    // Builds a file:/// URI for the page from the corpus directory.
+    bool GetPageURI(const char* pDirectory, const char* pPage, char* pURI, size_t uriCapacity)
+    {
+        char path[kPathCapacity];
+
+        #if defined(_WIN32)
+            char fullPath[kPathCapacity];
+
+            _snprintf(path, sizeof(path), "%s\\%s", pDirectory, pPage);
+            path[sizeof(path) - 1] = 0;
+
+            const DWORD length = GetFullPathNameA(path, sizeof(fullPath), fullPath, NULL);
+            if((length == 0) || (length >= sizeof(fullPath)) || (GetFileAttributesA(fullPath) == INVALID_FILE_ATTRIBUTES))
+                return false;
+
+            for(char* p = fullPath; *p; ++p)
+            {
+                if(*p == '\\')
+                    *p = '/';
+            }
+
+            _snprintf(pURI, uriCapacity, "file:///%s", fullPath);
+        #else
+            // The directory is expected to be absolute here.
+            snprintf(path, sizeof(path), "%s/%s", pDirectory, pPage);
+            FILE* pPageFile = fopen(path, "rb");
+            if(!pPageFile)
+                return false;
+            fclose(pPageFile);
+
+            snprintf(pURI, uriCapacity, "file://%s", path);
+        #endif
+
+        pURI[uriCapacity - 1] = 0;
+        return true;
+    }
+
+
+    // Watches for the main page load of the benchmark View to finish.
+    class LoadNotification : public EA::WebKit::ViewNotification
+    {
+    public:
+        LoadNotification() : mpView(NULL), mbCompleted(false) { }
+
+        void Reset(EA::WebKit::View* pView) { mpView = pView; mbCompleted = false; }
+        bool IsCompleted() const { return mbCompleted; }
+
+        // kLETLoadCompleted is sent once the whole page (subresources and child frames included) has
+        // finished, whether or not every resource loaded.
+        virtual bool LoadUpdate(EA::WebKit::LoadInfo& loadInfo)
+        {
+            if((loadInfo.mpView == mpView) && (loadInfo.mLET == EA::WebKit::kLETLoadCompleted))
+                mbCompleted = true;
+            return false;
+        }
+
+    private:
+        EA::WebKit::View* mpView;
+        bool              mbCompleted;
+    };
+
+
+    // Writes the results as a JSON array, one object per page. Times are in milliseconds per load.
+    class Report
+    {
+    public:
+        Report(FILE* pFile) : mpFile(pFile), mnCount(0) { fprintf(mpFile, "["); }
+        ~Report() { fprintf(mpFile, "\n]\n"); }
+
+        void Add(const char* pPage, bool bCompleted, int iterations, double totalSeconds, const double* pPhaseSeconds)
+        {
+            fprintf(mpFile, "%s\n  {\"page\":\"%s\",\"completed\":%s,\"iterations\":%d,\"totalMs\":%.3f",
+                    mnCount++ ? "," : "", pPage, bCompleted ? "true" : "false", iterations, totalSeconds * 1000.0 / iterations);
+
+            for(int p = 0; p < kPhaseCount; ++p)
+                fprintf(mpFile, ",\"%sMs\":%.3f", kPhases[p].mpName, pPhaseSeconds[p] * 1000.0 / iterations);
+
+            fprintf(mpFile, "}");
+            fflush(mpFile);
+        }
+
+    private:
+        FILE* mpFile;
+        int   mnCount;
+    };
+
+
+    // Loads the page once, adding the wall time and the time of each phase. Returns false if it didn't complete.
+    bool LoadPage(EA::WebKit::IEAWebkit* pWebKit, EA::WebKit::View* pView, LoadNotification& notification,
+                  const char* pURI, double& totalSeconds, double* pPhaseSeconds)
+    {
+        // Drop the decoded images and style sheets of the previous load, so every load parses and decodes them again.
+        pWebKit->PurgeCache(true, false, false);
+
+        notification.Reset(pView);
+        pWebKit->StartProcessTrace();
+
+        const double start = GetSeconds();
+        pView->SetURI(pURI);
+
+        while(!notification.IsCompleted() && ((GetSeconds() - start) < kLoadTimeout))
+            pView->Tick();
+
+        for(int i = 0; i < kSettleTicks; ++i)
+            pView->Tick();
+
+        totalSeconds += GetSeconds() - start;
+        pWebKit->StopProcessTrace();
+
+        EA::WebKit::ProcessTraceSummary summary;
+        pWebKit->GetProcessTraceSummary(summary);
+
+        for(int p = 0; p < kPhaseCount; ++p)
+            pPhaseSeconds[p] += summary.mTypeStats[kPhases[p].mType].mTotalTime;
+
+        if(summary.mDroppedEventCount)
+            fprintf(stderr, "%s: %u trace events were dropped; the phase times are low.\n", pURI, summary.mDroppedEventCount);
+
+        return notification.IsCompleted();
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* pDirectory = (argc > 1) ? argv[1] : "benchmark\\pages";
+    const int   iterations = (argc > 2) ? atoi(argv[2]) : 10;
+    FILE*       pFile      = (argc > 3) ? fopen(argv[3], "w") : stdout;
+
+    if((iterations <= 0) || !pFile)
+    {
+        fprintf(stderr, "Usage: EAPageLoadBenchmark [corpus directory] [iterations] [output.json]\n");
+        return 1;
+    }
+
+    EA::WebKit::IEAWebkit* pWebKit = CreateWebKit();
+    if(!pWebKit)
+    {
+        fprintf(stderr, "Unable to load EAWebKit.\n");
+        return 1;
+    }
+    pWebKit->Init(NULL);
+
+    // Nothing is recorded by the process trace unless profiling is enabled.
+    EA::WebKit::Parameters parameters = pWebKit->GetParameters();
+    parameters.mbEnableProfiling     = true;
+    parameters.mbEnableFileTransport = true;
+    pWebKit->SetParameters(parameters);
+
+    // The default font server starts out empty; NULL reads the system font directory.
+    pWebKit->GetFontServer()->AddDirectory(NULL, NULL);
+
+    LoadNotification notification;
+    pWebKit->SetViewNotification(&notification);
+
+    EA::WebKit::ViewParameters viewParameters;
+    viewParameters.mWidth  = kViewWidth;
+    viewParameters.mHeight = kViewHeight;
+
+    EA::WebKit::View* pView = pWebKit->CreateView();
+    pView->InitView(viewParameters);
+
+    {
+        Report report(pFile);
+        char   uri[kPathCapacity + 16];
+
+        for(int i = 0; i < kPageCount; ++i)
+        {
+            if(!GetPageURI(pDirectory, kPages[i], uri, sizeof(uri)))
+            {
+                fprintf(stderr, "Unable to find %s in %s.\n", kPages[i], pDirectory);
+                continue;
+            }
+
+            // The first load warms up the font and glyph caches and isn't reported.
+            double warmupSeconds = 0.0;
+            double warmupPhaseSeconds[kPhaseCount] = { 0.0 };
+            LoadPage(pWebKit, pView, notification, uri, warmupSeconds, warmupPhaseSeconds);
+
+            double totalSeconds = 0.0;
+            double phaseSeconds[kPhaseCount] = { 0.0 };
+            bool   bCompleted = true;
+
+            for(int j = 0; j < iterations; ++j)
+                bCompleted = LoadPage(pWebKit, pView, notification, uri, totalSeconds, phaseSeconds) && bCompleted;
+
+            report.Add(kPages[i], bCompleted, iterations, totalSeconds, phaseSeconds);
+        }
+    }
+
+    pView->ShutdownView();
+    pWebKit->DestroyView(pView);
+    pWebKit->SetViewNotification(NULL);
+    pWebKit->Shutdown();
+
+    if(pFile != stdout)
+        fclose(pFile);
+
+    return 0;
+}
@@ -0,0 +1,460 @@
+/*
+Copyright (C) 2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// EARasterBenchmark.cpp
+//
+// Standalone throughput benchmark for the EARaster software rasterizer.
+// It drives the rasterizer returned by GetSoftwareRasterInstance() and
+// writes one JSON record per case, with the pixel rate in MPix/s.
+//
+// Usage: EARasterBenchmark [iterations] [output.json]
+// Without an output path the JSON goes to stdout.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <EAWebKit/EAWebKit.h>
+#include <EARaster/EARaster.h>
+#include <EARaster/EARasterColor.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#endif
+
+
+namespace
+{
+    const int kSurfaceWidth  = 512;
+    const int kSurfaceHeight = 512;
+    const int kTileSize      = 64;
+    const int kZoomSize      = 256;     // Zoomed 2x up to the full surface size.
+    const int kGlyphWidth    = 12;
+    const int kGlyphHeight   = 16;
+    const int kGlyphCount    = 40;      // Roughly one line of text.
+    const int kTextureSize   = 256;
+
+    struct PixelFormatName
+    {
+        EA::Raster::PixelFormatType mType;
+        const char*                 mpName;
+    };
+
+    const PixelFormatName kPixelFormats[] =
+    {
+        { EA::Raster::kPixelFormatTypeARGB, "ARGB" },
+        { EA::Raster::kPixelFormatTypeRGBA, "RGBA" },
+        { EA::Raster::kPixelFornatTypeXRGB, "XRGB" },
+        { EA::Raster::kPixelFormatTypeRGBX, "RGBX" },
+        { EA::Raster::kPixelFormatTypeRGB,  "RGB"  }
+    };
+
+    const int kPixelFormatCount = (int)(sizeof(kPixelFormats) / sizeof(kPixelFormats[0]));
+
+    const EA::Raster::Matrix2D kIdentity(1.0, 0.0, 0.0, 1.0, 0.0, 0.0);
+
+
+    // The Windows DLL only exports CreateEAWebkitInstance (see EAWebkit_Windows.def), so it is looked up at runtime.
+    EA::WebKit::IEAWebkit* CreateWebKit()
+    {
+        #if defined(_WIN32)
+            typedef EA::WebKit::IEAWebkit* (*CreateEAWebkitInstanceFunction)(void);
+
+            #if defined(_DEBUG)
+                HMODULE hModule = LoadLibraryA("EAWebKit_d.dll");
+            #else
+                HMODULE hModule = LoadLibraryA("EAWebkit.dll");
+            #endif
+            if(!hModule)
+                return NULL;
+
+            CreateEAWebkitInstanceFunction pCreate = (CreateEAWebkitInstanceFunction)GetProcAddress(hModule, "CreateEAWebkitInstance");
+            return pCreate ? pCreate() : NULL;
+        #else
+            return CreateEAWebkitInstance();
+        #endif
+    }
+
+
+    double GetSeconds()
+    {
+        #if defined(_WIN32)
+            LARGE_INTEGER frequency, counter;
+            QueryPerformanceFrequency(&frequency);
+            QueryPerformanceCounter(&counter);
+            return (double)counter.QuadPart / (double)frequency.QuadPart;
+        #else
+            return (double)clock() / (double)CLOCKS_PER_SEC;
+        #endif
+    }
+
+
+    // Writes the results as a JSON array, one object per case.
+    class Report
+    {
+    public:
+        Report(FILE* pFile) : mpFile(pFile), mnCount(0) { fprintf(mpFile, "["); }
+        ~Report() { fprintf(mpFile, "\n]\n"); }
+
+        // pixelsPerIteration is the number of destination pixels one iteration touches.
+        void Add(const char* pCase, const char* pVariant, int iterations, double pixelsPerIteration, double seconds)
+        {
+            const double pixels        = pixelsPerIteration * iterations;
+            const double mpixPerSecond = (seconds > 0.0) ? (pixels / seconds / 1000000.0) : 0.0;
+
+            fprintf(mpFile, "%s\n  {\"case\":\"%s\",\"variant\":\"%s\",\"iterations\":%d,\"pixels\":%.0f,\"seconds\":%.6f,\"mpixPerSecond\":%.3f}",
+                    mnCount++ ? "," : "", pCase, pVariant, iterations, pixels, seconds, mpixPerSecond);
+            fflush(mpFile);
+        }
+
+    private:
+        FILE* mpFile;
+        int   mnCount;
+    };
+
+
+    // Fills every byte of the surface with a pattern. Noise defeats RLE; otherwise the
+    // surface gets flat horizontal bands, which is the case RLE is meant for.
+    void FillSurface(EA::Raster::ISurface* pSurface, bool bNoise, uint8_t alpha)
+    {
+        void* pData  = NULL;
+        int   stride = 0;
+        pSurface->Lock(&pData, &stride);
+        if(!pData)
+            return;
+
+        int width, height;
+        pSurface->GetDimensions(&width, &height);
+        const EA::Raster::PixelFormat& pf = pSurface->GetPixelFormat();
+
+        uint32_t seed = 0x12345678;
+        for(int y = 0; y < height; ++y)
+        {
+            uint8_t* pRow = (uint8_t*)pData + (y * stride);
+
+            for(int x = 0; x < width; ++x)
+            {
+                uint32_t argb;
+                if(bNoise)
+                {
+                    seed = (seed * 1103515245) + 12345;
+                    argb = (seed >> 8) & 0x00ffffff;
+                }
+                else
+                    argb = ((y / 8) * 0x00102030) & 0x00ffffff;
+
+                argb |= (uint32_t)alpha << 24;
+
+                if(pf.mBytesPerPixel == 4)
+                {
+                    const uint32_t r = (argb >> 16) & 0xff, g = (argb >> 8) & 0xff, b = argb & 0xff, a = argb >> 24;
+                    ((uint32_t*)pRow)[x] = (r << pf.mRShift) | (g << pf.mGShift) | (b << pf.mBShift) | ((a << pf.mAShift) & pf.mAMask);
+                }
+                else
+                {
+                    pRow[(x * 3) + 0] = (uint8_t)(argb >> 16);
+                    pRow[(x * 3) + 1] = (uint8_t)(argb >> 8);
+                    pRow[(x * 3) + 2] = (uint8_t)(argb);
+                }
+            }
+        }
+
+        pSurface->Unlock();
+    }
+
+
+    // A glyph atlas held in plain memory, laid out the way the EAText glyph cache hands it to DrawGlyphs.
+    class BenchmarkTextureInfo : public EA::WebKit::ITextureInfo
+    {
+    public:
+        BenchmarkTextureInfo(uint32_t format)
+          : mFormat(format),
+            mStride(kTextureSize * (format == EA::WebKit::kBFARGB ? 4 : 1)),
+            mpData((uint8_t*)malloc(mStride * kTextureSize))
+        {
+            // Each glyph cell gets a diagonal ramp of coverage.
+            for(int y = 0; y < kTextureSize; ++y)
+            {
+                for(int x = 0; x < kTextureSize; ++x)
+                {
+                    const uint8_t coverage = (uint8_t)((((x % kGlyphWidth) + (y % kGlyphHeight)) * 255) / (kGlyphWidth + kGlyphHeight));
+
+                    if(mFormat == EA::WebKit::kBFARGB)
+                        ((uint32_t*)(mpData + (y * mStride)))[x] = ((uint32_t)coverage << 24) | 0x00ffffff;
+                    else
+                        mpData[(y * mStride) + x] = coverage;
+                }
+            }
+        }
+
+        ~BenchmarkTextureInfo() { free(mpData); }
+
+        virtual int      AddRef()                      { return 1; }
+        virtual int      Release()                     { return 1; }
+        virtual uint32_t GetSize()                     { return kTextureSize; }
+        virtual intptr_t GetStride()                   { return mStride; }
+        virtual uint8_t* GetData()                     { return mpData; }
+        virtual uint32_t GetFormat()                   { return mFormat; }
+        virtual void*    GetTextureInfoPointer()       { return NULL; }
+        virtual void     SetTextureInfoPointer(void*)  { }
+        virtual void     DestroyWrapper()              { }
+
+    private:
+        uint32_t mFormat;
+        intptr_t mStride;
+        uint8_t* mpData;
+    };
+
+
+    void BenchmarkBlit(EA::Raster::IEARaster* pRaster, Report& report, int iterations)
+    {
+        const EA::Raster::Rect fullRect(0, 0, kSurfaceWidth, kSurfaceHeight);
+        char variant[32];
+
+        for(int s = 0; s < kPixelFormatCount; ++s)
+        {
+            EA::Raster::ISurface* pSource = pRaster->CreateSurface(kSurfaceWidth, kSurfaceHeight, kPixelFormats[s].mType, EA::Raster::kSurfaceCategoryImage);
+            EA::Raster::ISurface* pTile   = pRaster->CreateSurface(kTileSize, kTileSize, kPixelFormats[s].mType, EA::Raster::kSurfaceCategoryImage);
+            FillSurface(pSource, true, 0x80);
+            FillSurface(pTile, true, 0x80);
+
+            for(int d = 0; d < kPixelFormatCount; ++d)
+            {
+                EA::Raster::ISurface* pDest = pRaster->CreateSurface(kSurfaceWidth, kSurfaceHeight, kPixelFormats[d].mType, EA::Raster::kSurfaceCategoryMainView);
+                FillSurface(pDest, false, 0xff);
+                sprintf(variant, "%s->%s", kPixelFormats[s].mpName, kPixelFormats[d].mpName);
+
+                double start = GetSeconds();
+                for(int i = 0; i < iterations; ++i)
+                    pRaster->DrawSurface(pSource, fullRect, pDest, fullRect, kIdentity, 1.0f);
+                report.Add("Blit", variant, iterations, (double)kSurfaceWidth * kSurfaceHeight, GetSeconds() - start);
+
+                const EA::Raster::Rect tileRect(0, 0, kTileSize, kTileSize);
+                start = GetSeconds();
+                for(int i = 0; i < iterations; ++i)
+                    pRaster->DrawSurfaceTiled(pTile, tileRect, pDest, fullRect, fullRect, kIdentity, 1.0f);
+                report.Add("BlitTiled", variant, iterations, (double)kSurfaceWidth * kSurfaceHeight, GetSeconds() - start);
+
+                pRaster->DestroySurface(pDest);
+            }
+
+            pRaster->DestroySurface(pTile);
+            pRaster->DestroySurface(pSource);
+        }
+    }
+
+
+    void BenchmarkShapes(EA::Raster::IEARaster* pRaster, Report& report, int iterations)
+    {
+        EA::Raster::ISurface* pDest = pRaster->CreateSurface(kSurfaceWidth, kSurfaceHeight, EA::Raster::kPixelFormatTypeARGB, EA::Raster::kSurfaceCategoryMainView);
+        FillSurface(pDest, false, 0xff);
+
+        const EA::Raster::Rect fullRect(0, 0, kSurfaceWidth, kSurfaceHeight);
+        const EA::Raster::Color opaque(0xff, 0x40, 0x80, 0xc0);
+        const EA::Raster::Color translucent(0x80, 0x40, 0x80, 0xc0);
+        const double fullArea = (double)kSurfaceWidth * kSurfaceHeight;
+
+        double start = GetSeconds();
+        for(int i = 0; i < iterations; ++i)
+            pRaster->RectangleFilled(pDest, fullRect, opaque);
+        report.Add("RectangleFilled", "opaque", iterations, fullArea, GetSeconds() - start);
+
+        start = GetSeconds();
+        for(int i = 0; i < iterations; ++i)
+            pRaster->RectangleFilled(pDest, fullRect, translucent);
+        report.Add("RectangleFilled", "translucent", iterations, fullArea, GetSeconds() - start);
+
+        // Shapes report the area of their bounding box.
+        const int rx = (kSurfaceWidth / 2) - 1;
+        const int ry = (kSurfaceHeight / 2) - 1;
+
+        start = GetSeconds();
+        for(int i = 0; i < iterations; ++i)
+            pRaster->EllipseFilled(pDest, kSurfaceWidth / 2, kSurfaceHeight / 2, rx, ry, translucent);
+        report.Add("EllipseFilled", "translucent", iterations, fullArea, GetSeconds() - start);
+
+        start = GetSeconds();
+        for(int i = 0; i < iterations; ++i)
+            pRaster->EllipseOutlinedAA(pDest, kSurfaceWidth / 2, kSurfaceHeight / 2, rx, ry, translucent);
+        report.Add("AAEllipse", "translucent", iterations, fullArea, GetSeconds() - start);
+
+        // A star, so the polygon has concave edges.
+        static const int vx[10] = { 256, 316, 506, 354, 414, 256,  98, 158,   6, 196 };
+        static const int vy[10] = {   6, 190, 190, 306, 506, 388, 506, 306, 190, 190 };
+
+        start = GetSeconds();
+        for(int i = 0; i < iterations; ++i)
+            pRaster->PolygonFilled(pDest, vx, vy, 10, translucent);
+        report.Add("PolygonFilled", "translucent", iterations, fullArea, GetSeconds() - start);
+
+        start = GetSeconds();
+        for(int i = 0; i < iterations; ++i)
+            pRaster->PolygonOutlinedAA(pDest, vx, vy, 10, translucent);
+        report.Add("AAPolygon", "translucent", iterations, fullArea, GetSeconds() - start);
+
+        pRaster->DestroySurface(pDest);
+    }
+
+
+    // A pure scale goes through ZoomSurface (ZoomSurfaceRGBA for 32 bit sources), then a blit.
+    void BenchmarkZoom(EA::Raster::IEARaster* pRaster, Report& report, int iterations)
+    {
+        EA::Raster::ISurface* pSource = pRaster->CreateSurface(kZoomSize, kZoomSize, EA::Raster::kPixelFormatTypeARGB, EA::Raster::kSurfaceCategoryImage);
+        EA::Raster::ISurface* pDest   = pRaster->CreateSurface(kSurfaceWidth, kSurfaceHeight, EA::Raster::kPixelFormatTypeARGB, EA::Raster::kSurfaceCategoryMainView);
+        FillSurface(pSource, true, 0xff);
+
+        const EA::Raster::Matrix2D zoom((double)kSurfaceWidth / kZoomSize, 0.0, 0.0, (double)kSurfaceHeight / kZoomSize, 0.0, 0.0);
+        const EA::Raster::Rect     sourceRect(0, 0, kZoomSize, kZoomSize);
+        const EA::Raster::Rect     destRect(0, 0, kSurfaceWidth, kSurfaceHeight);
+
+        const double start = GetSeconds();
+        for(int i = 0; i < iterations; ++i)
+            pRaster->DrawSurface(pSource, sourceRect, pDest, destRect, zoom, 1.0f);
+        report.Add("ZoomSurfaceRGBA", "2x smooth", iterations, (double)kSurfaceWidth * kSurfaceHeight, GetSeconds() - start);
+
+        pRaster->DestroySurface(pDest);
+        pRaster->DestroySurface(pSource);
+    }
+
+
+    // Compression marks a surface as compressed, so every iteration packs a fresh surface.
+    // Only the CompressImage call is timed.
+    void BenchmarkCompression(EA::Raster::IEARaster* pRaster, Report& report, int iterations, bool bRLE)
+    {
+        const int sizeTotal      = kSurfaceWidth * kSurfaceHeight * 4;
+        int       compressedSize = 0;
+        double    seconds        = 0.0;
+
+        for(int i = 0; i < iterations; ++i)
+        {
+            EA::Raster::ISurface* pImage = pRaster->CreateSurface(kSurfaceWidth, kSurfaceHeight, EA::Raster::kPixelFormatTypeARGB, EA::Raster::kSurfaceCategoryImage);
+            FillSurface(pImage, !bRLE, bRLE ? 0x80 : 0xff);
+
+            // Skip the RLE attempt so the DXT5 timing is just the DXT5 packing.
+            if(!bRLE)
+            {
+                EA::Raster::Surface* pSurface = static_cast<EA::Raster::Surface*>(pImage);
+                pSurface->SetSurfaceFlags(pSurface->GetSurfaceFlags() | EA::Raster::kFlagIgnoreCompressRLE);
+            }
+
+            const double start = GetSeconds();
+            pRaster->CompressImage(pImage, bRLE, sizeTotal, &compressedSize);
+            seconds += GetSeconds() - start;
+
+            pRaster->DestroySurface(pImage);
+        }
+
+        if(compressedSize == 0)
+            fprintf(stderr, "%s compression was not applied; is it compiled in?\n", bRLE ? "RLE" : "YCoCgDXT5");
+        report.Add("CompressImage", bRLE ? "RLE" : "YCoCgDXT5", iterations, (double)kSurfaceWidth * kSurfaceHeight, seconds);
+    }
+
+
+    void BenchmarkGlyphs(EA::Raster::IEARaster* pRaster, Report& report, int iterations, uint32_t format)
+    {
+        BenchmarkTextureInfo textureInfo(format);
+        EA::Raster::GlyphDrawInfo glyphs[kGlyphCount];
+
+        const int glyphsPerRow = kTextureSize / kGlyphWidth;
+        for(int g = 0; g < kGlyphCount; ++g)
+        {
+            const int cellX = (g % glyphsPerRow) * kGlyphWidth;
+            const int cellY = (g / glyphsPerRow) * kGlyphHeight;
+
+            glyphs[g].x1 = g * kGlyphWidth;
+            glyphs[g].x2 = glyphs[g].x1 + kGlyphWidth;
+            glyphs[g].y1 = 0;
+            glyphs[g].y2 = kGlyphHeight;
+            glyphs[g].u0 = (float)cellX / kTextureSize;
+            glyphs[g].v0 = (float)cellY / kTextureSize;
+            glyphs[g].u1 = (float)(cellX + kGlyphWidth) / kTextureSize;
+            glyphs[g].v1 = (float)(cellY + kGlyphHeight) / kTextureSize;
+        }
+
+        EA::Raster::ISurface* pDest = pRaster->CreateSurface(kSurfaceWidth, kSurfaceHeight, EA::Raster::kPixelFormatTypeARGB, EA::Raster::kSurfaceCategoryMainView);
+        FillSurface(pDest, false, 0xff);
+
+        const EA::Raster::Rect  runRect(0, 0, kGlyphCount * kGlyphWidth, kGlyphHeight);
+        const EA::Raster::Color penColor(0xff, 0x20, 0x20, 0x20);
+
+        const double start = GetSeconds();
+        for(int i = 0; i < iterations; ++i)
+            pRaster->DrawGlyphs(glyphs, kGlyphCount, &textureInfo, pDest, runRect, runRect, penColor, kIdentity, 1.0f, EA::WebKit::kEffectNone);
+        report.Add("DrawGlyphs", (format == EA::WebKit::kBFARGB) ? "ARGB atlas" : "grayscale atlas", iterations, (double)runRect.w * runRect.h, GetSeconds() - start);
+
+        pRaster->DestroySurface(pDest);
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    const int iterations = (argc > 1) ? atoi(argv[1]) : 100;
+    FILE*     pFile      = (argc > 2) ? fopen(argv[2], "w") : stdout;
+
+    if((iterations <= 0) || !pFile)
+    {
+        fprintf(stderr, "Usage: EARasterBenchmark [iterations] [output.json]\n");
+        return 1;
+    }
+
+    EA::WebKit::IEAWebkit* pWebKit = CreateWebKit();
+    if(!pWebKit)
+    {
+        fprintf(stderr, "Unable to load EAWebKit.\n");
+        return 1;
+    }
+    pWebKit->Init(NULL);
+
+    // Compression is off by default; turn it on so CompressImage does the packing.
+    EA::WebKit::Parameters parameters = pWebKit->GetParameters();
+    parameters.mbEnableImageCompression = true;
+    pWebKit->SetParameters(parameters);
+
+    EA::Raster::IEARaster* pRaster = pWebKit->GetSoftwareRasterInstance();
+
+    {
+        Report report(pFile);
+
+        BenchmarkBlit(pRaster, report, iterations);
+        BenchmarkShapes(pRaster, report, iterations);
+        BenchmarkZoom(pRaster, report, iterations);
+        BenchmarkCompression(pRaster, report, iterations, true);
+        BenchmarkCompression(pRaster, report, iterations, false);
+        BenchmarkGlyphs(pRaster, report, iterations, EA::WebKit::kBFGrayscale);
+        BenchmarkGlyphs(pRaster, report, iterations, EA::WebKit::kBFARGB);
+    }
+
+    pWebKit->Shutdown();
+
+    if(pFile != stdout)
+        fclose(pFile);
+
+    return 0;
+}
@@ -425,6 +425,18 @@ namespace EA
                 return WriteSurfaceToFile(pPath, pSurface, bAlphaOnly);
             }
             /*!!! END DEPRECATED !!!*/
+
+            // Anti-aliased outlines. These are last so existing rasterizers keep their vtable layout,
+            // and they fall back to aliased drawing unless overridden.
+            virtual int EllipseOutlinedAA(ISurface* pSurface, int x, int y, int rx, int ry, const Color &color) {
+                return EllipseOutlined(pSurface, x, y, rx, ry, color);
+            }
+            virtual int PolygonOutlinedAA(ISurface* pSurface, const int *vx, const int *vy, int n, const Color &color) {
+                int result = 0;
+                for (int i = 0; i < n; ++i)
+                    result |= Line(pSurface, vx[i], vy[i], vx[(i + 1) % n], vy[(i + 1) % n], color);
+                return result;
+            }
 		};
 
 		class EARasterConcrete: public IEARaster
@@ -469,6 +481,10 @@ namespace EA
             // Util
 			virtual bool WriteSurfaceToFile(const char* pPath, ISurface* pSurface, bool bAlphaOnly);
 
+            // Anti-aliased outlines
+            virtual int EllipseOutlinedAA(ISurface* pSurface, int x, int y, int rx, int ry, const Color &color);
+            virtual int PolygonOutlinedAA(ISurface* pSurface, const int *vx, const int *vy, int n, const Color &color);
+
             virtual bool IntersectRect(const Rect& a, const Rect& b, Rect& result) { return EA::Raster::IntersectRect(a, b, result); }
             virtual bool ClipForBlit(ISurface* pSource, const Rect &rectSource, ISurface* pDest, const Rect &rectDest, Rect *rectSourceResult, Rect *rectDestResult) {
                 return EA::Raster::ClipForBlit(pSource, &rectSource, pDest, &rectDest, *rectSourceResult, *rectDestResult);
@@ -52,6 +52,7 @@ namespace EA
     {
         class TransportInfo;
 		struct PlatformSocketAPI;
+		struct ProcessTraceSummary;
 
 		///////////////////////////////////////////////////////////////////////
         // structures and enums etc.
@@ -179,6 +180,34 @@ namespace EA
 			}
 		};
 
+		// JavaScript garbage collector statistics, updated after every collection.
+		// Byte counts are for collector cells only; memory the cells own (string buffers, array storage) is not included.
+		struct JavaScriptGCStatistics
+		{
+			uint32_t mCollectionCount;      // Number of collections so far.
+			double   mLastPauseSeconds;     // Duration of the most recent collection.
+			double   mMaxPauseSeconds;      // Longest collection so far.
+			double   mTotalPauseSeconds;    // Time spent in all collections so far.
+			uint32_t mLastBytesFreed;       // Bytes reclaimed by the most recent collection.
+			uint64_t mTotalBytesFreed;      // Bytes reclaimed by all collections so far.
+			uint32_t mHeapBytes;            // Bytes held by the collector after the most recent collection.
+			uint32_t mLiveBytes;            // Bytes in objects that survived the most recent collection.
+			uint32_t mHeapBudget;           // Parameters::mJavaScriptHeapBudget as of the most recent collection.
+
+			JavaScriptGCStatistics()
+				: mCollectionCount(0)
+				, mLastPauseSeconds(0.0)
+				, mMaxPauseSeconds(0.0)
+				, mTotalPauseSeconds(0.0)
+				, mLastBytesFreed(0)
+				, mTotalBytesFreed(0)
+				, mHeapBytes(0)
+				, mLiveBytes(0)
+				, mHeapBudget(0)
+			{
+			}
+		};
+
 
 		///////////////////////////////////////////////////////////////////////
 		// Parameters 
@@ -312,6 +341,7 @@ namespace EA
 			FireTimerRate       mFireTimerRate;						// Defaults to 60Hz. Unclear if some Javascript could be unstable if fired too frequently (>60Hz). 		
 			bool                mbEnableDefaultToolTip;             // Defaults to false. If active, allows the default tooltip to display
 			bool				mbEnableCrossDomainScripting;		// Defaults to false. This is a workaround until we merge back from the trunk. This should be used in conjunction with the domain filtering system to avoid any security holes. 
+			uint32_t			mJavaScriptHeapBudget;				// Defaults to 0 (no budget). Bytes the JavaScript collector aims to keep its heap within; collections are scheduled sooner as the live heap approaches it. It is not a hard limit.
             Parameters();
 		};
 
@@ -475,6 +505,14 @@ namespace EA
             virtual EA::Raster::IEARaster*  GetSoftwareRasterInstance() = 0;    // Returns the software rasterizer.
 			virtual WebKitStatus			GetWebKitStatus() = 0;	
 
+			// Process trace recorder (see EAWebKitProcessTrace.h). 0 events per thread selects the default ring size.
+			virtual void		StartProcessTrace(uint32_t eventsPerThread = 0) = 0;
+			virtual void		StopProcessTrace() = 0;
+			virtual void		ClearProcessTrace() = 0;
+			virtual void		GetProcessTraceSummary(ProcessTraceSummary& summary) = 0;
+			virtual bool		WriteProcessTrace(const char* pFilePath) = 0;
+
+			virtual void		GetJavaScriptGCStatistics(JavaScriptGCStatistics& gcStatistics) = 0;
 			
 
 
@@ -658,6 +696,13 @@ namespace EA
             virtual EA::Raster::IEARaster*  GetSoftwareRasterInstance();    // Returns the software rasterizer instance.
             virtual WebKitStatus			GetWebKitStatus();	
 
+			virtual void		StartProcessTrace(uint32_t eventsPerThread = 0);
+			virtual void		StopProcessTrace();
+			virtual void		ClearProcessTrace();
+			virtual void		GetProcessTraceSummary(ProcessTraceSummary& summary);
+			virtual bool		WriteProcessTrace(const char* pFilePath);
+
+			virtual void		GetJavaScriptGCStatistics(JavaScriptGCStatistics& gcStatistics);
 
 
 
@@ -781,6 +826,7 @@ namespace EA
 		EAWEBKIT_API void			PurgeCache(bool bPurgeRAMCache, bool bPurgeFontCache, bool bPurgeDiskCache);
 		EAWEBKIT_API void			SetCookieUsage(const CookieInfo& cookieInfo);
 		EAWEBKIT_API void			GetCookieUsage(CookieInfo& cookieInfo);
+		EAWEBKIT_API void			GetJavaScriptGCStatistics(JavaScriptGCStatistics& gcStatistics);
 
 
 		//allowedDomain is something like .ea.com and excludedPaths is an optional semicolon separated list of paths they you may want do not include, 
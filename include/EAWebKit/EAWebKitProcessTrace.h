@@ -0,0 +1,103 @@
+/*
+Copyright (C) 2010-2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// EAWebKitProcessTrace.h
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+Built-in recorder for the NOTIFY_PROCESS_STATUS profiling hooks. While a trace is running, every
+process status change is stored in a fixed size ring buffer owned by the calling thread (no locks
+are taken on the record path). The recorded session can then be written out as Chrome trace_event 
+JSON (load it in chrome://tracing) or reduced to per process type totals and percentiles.
+
+Like the ViewNotification::ViewProcessStatus callback, nothing is recorded unless 
+Parameters::mbEnableProfiling is set.
+
+Example usage:
+    EA::WebKit::StartProcessTrace();
+    ... load and tick some pages ...
+    EA::WebKit::StopProcessTrace();
+    EA::WebKit::WriteProcessTrace("C:\\Temp\\EAWebKitTrace.json");
+*/
+
+#ifndef EAWEBKIT_EAWEBKITPROCESSTRACE_H
+#define EAWEBKIT_EAWEBKITPROCESSTRACE_H
+
+#include <EAWebKit/EAWebKitConfig.h>
+#include <EAWebKit/EAWebKitViewNotification.h>
+
+namespace EA
+{
+	namespace WebKit
+	{
+		enum ProcessTraceLimits
+		{
+			kProcessTraceMaxThreads             = 8,    // Threads beyond this count are not recorded.
+			kProcessTraceDefaultEventsPerThread = 8192  // Once a thread's ring is full, its oldest events are overwritten.
+		};
+
+		// Times are in seconds and only count matched start/end pairs. mTotalSize sums ViewProcessInfo::mSize 
+		// at the end of each pair; for the raster processes that is pixels, so mTotalSize / mTotalTime is the fill rate.
+		struct ProcessTraceTypeStats
+		{
+			uint32_t	mCount;
+			uint64_t	mTotalSize;
+			double		mTotalTime;
+			double		mMinTime;
+			double		mMaxTime;
+			double		mP50Time;
+			double		mP90Time;
+			double		mP99Time;
+		};
+
+		struct ProcessTraceSummary
+		{
+			ProcessTraceTypeStats	mTypeStats[kVProcessTypeLast];	// Indexed by VProcessType.
+			uint32_t				mThreadCount;					// Threads that recorded at least one event.
+			uint32_t				mEventCount;					// Events still held in the ring buffers.
+			uint32_t				mDroppedEventCount;				// Events overwritten by a full ring or lost to a thread without a ring.
+		};
+
+		// Starts a new trace, discarding any previously recorded one. 
+		EAWEBKIT_API void StartProcessTrace(uint32_t eventsPerThread = kProcessTraceDefaultEventsPerThread);
+		// Stops recording. The recorded events are kept until the next StartProcessTrace or ClearProcessTrace.
+		EAWEBKIT_API void StopProcessTrace();
+		// Releases the ring buffers. Must not be called while another thread can still record.
+		EAWEBKIT_API void ClearProcessTrace();
+		EAWEBKIT_API void GetProcessTraceSummary(ProcessTraceSummary& summary);
+		// Writes the recorded events as Chrome trace_event JSON using the EAWebKit FileSystem.
+		// The summary is added to the same file under "eawebkitSummary" (in milliseconds).
+		EAWEBKIT_API bool WriteProcessTrace(const char* pFilePath);
+
+		// Called by NOTIFY_PROCESS_STATUS.
+		void RecordProcessTraceEvent(const ViewProcessInfo& process);
+	}
+}
+
+#endif // Header include guard
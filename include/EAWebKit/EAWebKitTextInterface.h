@@ -305,6 +305,14 @@ namespace EA
             kBFRGBA       = 33      /// 32 bits per pixel, no compression. Format is 32 bit 0xrrggbbaa.
         };
 
+        enum TextBreakIteratorType
+        {
+            kTextBreakIteratorCharacter,
+            kTextBreakIteratorWord,
+            kTextBreakIteratorLine,
+            kTextBreakIteratorSentence
+        };
+
          ///--- Exposed structures from EAText ---
         struct IFontDescription
         {
@@ -392,6 +400,15 @@ namespace EA
             virtual int TextBreakPreceding(void* pIterator, int position) = 0;
             virtual int TextBreakFollowing(void* pIterator, int position) = 0;
             virtual bool IsTextBreak(void* pIterator, int position) = 0;
+
+            // The iterators above are shared, so getting one of a kind resets any other user of that kind.
+            // CreateTextBreakIterator makes an iterator which belongs to the caller. It is pointed at text with
+            // ResetTextBreakIterator, which doesn't allocate, and works with the TextBreak functions above.
+            // Not pure so existing implementations still build; a NULL return means the caller should use the shared iterators.
+            virtual void* CreateTextBreakIterator(TextBreakIteratorType /*type*/) { return NULL; }
+            virtual void ResetTextBreakIterator(void* /*pIterator*/, Char* /*pText*/, int /*length*/) { }
+            virtual void DestroyTextBreakIterator(void* /*pIterator*/) { }
+
             virtual int FindNextWordFromIndex(Char* chars, int len, int position, bool forward) = 0;
             virtual void FindWordBoundary(Char* chars, int len, int position, int* start, int* end) =0;
         }; 
@@ -433,11 +450,24 @@ namespace EA
             // Extracted part of the BCFontEA.cpp draw 
             virtual bool DrawGlyphBitmap(IGlyphCache* pGlyphCache, GlyphId g, IGlyphTextureInfo& glyphTextureInfo) = 0;
 
+            // Renders glyphs which aren't in the glyph cache yet and adds them to it as one batch, so that each cache texture
+            // is updated once rather than once per glyph. Use IGlyphCache::GetGlyphTextureInfo to find the added glyphs.
+            // Returns the number of glyphs added. Not pure so existing implementations still build; they add none and 
+            // callers fall back to DrawGlyphBitmap.
+            // If pSubpixelPhaseArray is supplied, each glyph is rendered shifted right by a fraction of a pixel of 
+            // pSubpixelPhaseArray[i] / IGlyphCache::GetSubpixelPhaseCount() and is found with IGlyphCache::GetSubpixelGlyphTextureInfo.
+            virtual uint32_t DrawGlyphBitmaps(IGlyphCache* /*pGlyphCache*/, const GlyphId* /*pGlyphArray*/, uint32_t /*glyphCount*/, 
+                                              const uint8_t* /*pSubpixelPhaseArray*/ = NULL) { return 0; }
+
              // For custom fonts    
             virtual bool SetTransform(float fSize) =0;
             virtual bool SetEffect(const TextEffectData& effect, EA::WebKit::IFontServer* const pFontServer) = 0; 
             virtual void SetSmoothing(EA::WebKit::Smooth type) =0;   
 
+            // Returns false if GetKerning never reports kerning for this font (e.g. it has no kerning table),
+            // which allows callers to skip kerning lookups entirely. Not pure so existing implementations still build.
+            virtual bool HasKerning() { return true; }
+
         }; // Font
 
         struct IFontStyle
@@ -495,6 +525,16 @@ namespace EA
 		    virtual bool EndUpdate(ITextureInfo* pTextureInfo) = 0;
 
             virtual void* GetGlyphCachePointer() =0;
+
+            // Returns how many horizontal subpixel positions a glyph can be cached at. A glyph drawn at a fractional 
+            // pen position uses the variant whose phase is nearest to it. 1 means that only pixel-aligned glyphs are cached.
+            // Not pure so existing implementations still build.
+            virtual uint32_t GetSubpixelPhaseCount() { return 1; }
+
+            // Like GetGlyphTextureInfo, but finds the variant of the glyph rendered at the given subpixel phase. 
+            // Phase 0 is the regular glyph. Variants share the cache with, and are evicted like, regular glyphs.
+            virtual bool GetSubpixelGlyphTextureInfo(IFont* pFont, GlyphId glyphId, uint32_t nSubpixelPhase, IGlyphTextureInfo& glyphTextureInfo) 
+                { return (nSubpixelPhase == 0) && GetGlyphTextureInfo(pFont, glyphId, glyphTextureInfo); }
         };
     } // Namespace Internal
 } // Namespace EA
@@ -560,6 +560,10 @@ namespace EA
 			kVProcessTypeJavaScriptExecute,         // JavaScript execute
 			kVProcessTypeCSSParseSheet,             // CSS Sheet parse
 			kVProcessTypeFontLoading,               // Font loading
+			kVProcessTypeHTMLParse,                 // HTML tokenizer write (outermost only, includes inline scripts it runs)
+			kVProcessTypeStyleRecalc,               // Document style recalc
+			kVProcessTypeLayout,                    // Frame view layout
+			kVProcessTypeFillRect,                  // Low level raster rectangle fill
 
 
 
@@ -605,7 +609,7 @@ namespace EA
 			double								mStartTime;			// This is a user controlled workspace clock for timing
 			double								mIntermediateTime;	// This is a user controlled workspace clock for timing
 			const EASTLFixedString16Wrapper*	mURI;				// The URL associated with the process, if any.
-			int									mSize;				// Various usage but mostly return size info
+			int									mSize;				// Various usage but mostly return size info (pixels for the raster processes)
 			int									mJobId;				// Job Id of this process, if any.						
 			// Constructors
 			ViewProcessInfo();
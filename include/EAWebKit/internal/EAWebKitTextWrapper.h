@@ -76,11 +76,13 @@ namespace EA
             bool IsCharSupported(EA::WebKit::Char c, EA::WebKit::Script script = EA::WebKit::kScriptUnknown);
             float GetSize() const;
             bool GetKerning(EA::WebKit::GlyphId g1, EA::WebKit::GlyphId g2, EA::WebKit::Kerning& kerning, int direction, bool bHorizontalLayout = true);
+            bool HasKerning();
 
             // This is for the casted outline font class
             bool OpenOutline(const void* pSourceData, uint32_t nSourceSize, int nFaceIndex = 0);
 
             bool DrawGlyphBitmap(EA::WebKit::IGlyphCache* pGlyphCache, EA::WebKit::GlyphId g, EA::WebKit::IGlyphTextureInfo& glyphTextureInfo);
+            uint32_t DrawGlyphBitmaps(EA::WebKit::IGlyphCache* pGlyphCache, const EA::WebKit::GlyphId* pGlyphArray, uint32_t glyphCount, const uint8_t* pSubpixelPhaseArray = NULL);
 
             
             // For custom fonts
@@ -158,6 +160,9 @@ namespace EA
             int TextBreakPreceding(void* pIter, int position);
             int TextBreakFollowing(void* pIter, int position);
             bool IsTextBreak(void* pIter, int position);
+            void* CreateTextBreakIterator(EA::WebKit::TextBreakIteratorType type);
+            void ResetTextBreakIterator(void* pIter, EA::WebKit::Char* pText, int length);
+            void DestroyTextBreakIterator(void* pIter);
             int FindNextWordFromIndex(EA::WebKit::Char* chars, int len, int position, bool forward);
             void FindWordBoundary(EA::WebKit::Char* chars, int len, int position, int* start, int* end);
 
@@ -199,6 +204,8 @@ namespace EA
             bool EndUpdate(EA::WebKit::ITextureInfo* pTextureInfo);
             static TextureInfoProxy* CreateTextureInfoProxy(EA::Text::TextureInfo* pInfo);
             void* GetGlyphCachePointer() {return mpGlyphCache;}    
+            uint32_t GetSubpixelPhaseCount() {return (uint32_t)EA::Text::kSubpixelPhaseCount;}
+            bool GetSubpixelGlyphTextureInfo(EA::WebKit::IFont* pFont, EA::WebKit::GlyphId glyphId, uint32_t nSubpixelPhase, EA::WebKit::IGlyphTextureInfo& glyphTextureInfo);
 
         private:
             EA::Text::GlyphCache* mpGlyphCache; // = EA::Text::GlyphCache proxy when using EAText
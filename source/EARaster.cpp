@@ -618,6 +618,11 @@ namespace EA
 			return EA::Raster::EllipseColor(pSurface,  x,  y,  rx,  ry,  color);
 		}
 
+		int EARasterConcrete::EllipseOutlinedAA(ISurface* pSurface, int x, int y, int rx, int ry, const Color &color)
+		{
+			return EA::Raster::AAEllipseColor(pSurface, x, y, rx, ry, color);
+		}
+
 		// Polygon
 		int EARasterConcrete::TriangleOriented(ISurface* pSurface, int x, int y, int size, Orientation o, const Color &color)
 		{
@@ -629,6 +634,11 @@ namespace EA
 			return EA::Raster::FilledPolygonColorMT(pSurface, vx, vy, n, color, NULL, NULL);
 		}
 
+		int EARasterConcrete::PolygonOutlinedAA(ISurface* pSurface, const int *vx, const int *vy, int n, const Color &color)
+		{
+			return EA::Raster::AAPolygonColor(pSurface, vx, vy, n, color);
+		}
+
 		// Images
 		int EARasterConcrete::DrawSurface(ISurface *pImage, const Rect &sourceRect, ISurface *pDest, const Rect &destRect, const Matrix2D &transform, float alpha)
 		{
@@ -800,7 +800,9 @@ EARASTER_API int BlitNoClip(Surface* pSource, const Rect* pRectSource, ISurface*
     }
 
     // 11/09/09 CSidhall Added notify start of process to user
-	NOTIFY_PROCESS_STATUS(EA::WebKit::kVProcessTypeDrawRaster, EA::WebKit::kVProcessStatusStarted);
+    // The process info is local so the end notification can carry the pixel count.
+    EA::WebKit::ViewProcessInfo processInfo(EA::WebKit::kVProcessTypeDrawRaster, EA::WebKit::kVProcessStatusNone);
+	NOTIFY_PROCESS_STATUS(processInfo, EA::WebKit::kVProcessStatusStarted);
 	
 	if(!pRectSource)
     {
@@ -840,6 +842,7 @@ EARASTER_API int BlitNoClip(Surface* pSource, const Rect* pRectSource, ISurface*
 	int sourceStride = 0;
     pSource->Lock(&pSourceData, &sourceStride);
 	if (pSourceData == NULL) {
+		NOTIFY_PROCESS_STATUS(processInfo, EA::WebKit::kVProcessStatusEnded);
 		return -1;
 	}
 
@@ -854,6 +857,7 @@ EARASTER_API int BlitNoClip(Surface* pSource, const Rect* pRectSource, ISurface*
     pDest->Lock(&pDestData, &destStride);
 	if (pDestData == NULL) {
 		pSource->Unlock();
+		NOTIFY_PROCESS_STATUS(processInfo, EA::WebKit::kVProcessStatusEnded);
 		return -1;
 	}
 
@@ -867,7 +871,8 @@ EARASTER_API int BlitNoClip(Surface* pSource, const Rect* pRectSource, ISurface*
     pDest->Unlock();
     pSource->Unlock();
 
-	NOTIFY_PROCESS_STATUS(EA::WebKit::kVProcessTypeDrawRaster, EA::WebKit::kVProcessStatusEnded);
+    processInfo.mSize = pRectDest->w * pRectDest->h;
+	NOTIFY_PROCESS_STATUS(processInfo, EA::WebKit::kVProcessStatusEnded);
 
 	return 0;
 }
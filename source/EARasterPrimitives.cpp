@@ -59,6 +59,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "EARaster/EARasterColor.h"
 #include "EARaster/internal/EARasterUtils.h"
 #include "EAWebKit/EAWebKit.h"
+#include "EAWebKit/EAWebKitView.h"
 #include "Color.h"
 #include "AffineTransform.h"
 #include "IntRect.h"
@@ -564,11 +565,15 @@ EARASTER_API int FillRectSolidColor(ISurface* pSurface, const Rect* pRect, const
     else
         pRect = &pSurface->GetClipRect();
 
+    EA::WebKit::ViewProcessInfo processInfo(EA::WebKit::kVProcessTypeFillRect, EA::WebKit::kVProcessStatusNone);
+	NOTIFY_PROCESS_STATUS(processInfo, EA::WebKit::kVProcessStatusStarted);
+
 	void *pData = NULL;
 	int stride = 0;
     pSurface->Lock(&pData, &stride);
 
 	if (pData == NULL) {
+		NOTIFY_PROCESS_STATUS(processInfo, EA::WebKit::kVProcessStatusEnded);
 		return -1;
 	}
 
@@ -612,6 +617,9 @@ EARASTER_API int FillRectSolidColor(ISurface* pSurface, const Rect* pRect, const
     }
     pSurface->Unlock();
 
+    processInfo.mSize = pRect->w * pRect->h;
+	NOTIFY_PROCESS_STATUS(processInfo, EA::WebKit::kVProcessStatusEnded);
+
     return 0;
 }
 
@@ -632,11 +640,15 @@ EARASTER_API int FillRectColor(ISurface* pSurface, const Rect* pRect, const Colo
 
     const int sA = color.alpha();
 
+    EA::WebKit::ViewProcessInfo processInfo(EA::WebKit::kVProcessTypeFillRect, EA::WebKit::kVProcessStatusNone);
+	NOTIFY_PROCESS_STATUS(processInfo, EA::WebKit::kVProcessStatusStarted);
+
 	void *pData = NULL;
 	int stride = 0;
     pSurface->Lock(&pData, &stride);
 
 	if (pData == NULL) {
+		NOTIFY_PROCESS_STATUS(processInfo, EA::WebKit::kVProcessStatusEnded);
 		return -1;
 	}
 
@@ -729,6 +741,9 @@ EARASTER_API int FillRectColor(ISurface* pSurface, const Rect* pRect, const Colo
     
     pSurface->Unlock();
 
+    processInfo.mSize = pRect->w * pRect->h;
+	NOTIFY_PROCESS_STATUS(processInfo, EA::WebKit::kVProcessStatusEnded);
+
     return 0;
 }
 
@@ -33,6 +33,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <EAWebKit/EAWebKit.h>
 #include <EAWebKit/EAWebKitGraphics.h>
+#include <EAWebKit/EAWebKitProcessTrace.h>
 #include <EARaster/EARaster.h>
 #include <EAIO/FnEncode.h> 
 #include <EAIO/PathString.h>
@@ -52,6 +53,8 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <EAWebKit/internal/EAWebKitAssert.h>
 #include <EAAssert/eaassert.h>
 #include "JavascriptCore/kjs/interpreter.h"
+#include "JavascriptCore/kjs/JSGlobalData.h"
+#include "JavascriptCore/kjs/CollectorPolicy.h"
 #include "WebCore/bridge/bal/bal_class.h"
 #include "xml/XMLHttpRequest.h"
 
@@ -371,16 +374,20 @@ EAWEBKIT_API void PurgeCache(bool bPurgeRAMCache, bool bPurgeFontCache, bool bPu
         const int capacitySaved = pPageCache->capacity();
         pPageCache->setCapacity(0);
         pPageCache->setCapacity(capacitySaved);
+
+        KJS::JSGlobalData::purgeCaches();
     }
 
     if(bPurgeFontCache)
     {
         // From the mailing list:
         // The way to clear the WebCore font cache is to invoke FontCache::purgeInactiveFontData(). 
-        // This will remove all unreferenced font data from the cache. There is an amount of font 
-        // data that is never released from the cache and therefore leaks, namely font data created 
-        // in FontCache::getFontDataForCharacters. The call to invalidate() should release all other 
-        // font data, but also re-create and re-cache font data for all active fonts. 
+        // This will remove all unreferenced font data from the cache. The call to invalidate() should 
+        // release all other font data, but also re-create and re-cache font data for all active fonts. 
+        //
+        // Font data created by FontCache::getFontDataForCharacters is not purged here. It is cached 
+        // per Unicode block and stays referenced by the FontCache, because system fallback glyph pages 
+        // keep raw pointers to it. It is freed along with the rest of the font cache in staticFinalize.
 
         WebCore::FontCache::purgeInactiveFontData();
 
@@ -474,6 +481,22 @@ EAWEBKIT_API void GetNetworkMetrics(NetworkMetrics& metrics)
     }
 }
 
+EAWEBKIT_API void GetJavaScriptGCStatistics(JavaScriptGCStatistics& gcStatistics)
+{
+    KJS::CollectorStatistics statistics;
+    KJS::JSGlobalData::collectorStatistics(statistics); // Leaves the zeroed defaults if no script has run yet.
+
+    gcStatistics.mCollectionCount   = static_cast<uint32_t>(statistics.collectionCount);
+    gcStatistics.mLastPauseSeconds  = statistics.lastPauseSeconds;
+    gcStatistics.mMaxPauseSeconds   = statistics.maxPauseSeconds;
+    gcStatistics.mTotalPauseSeconds = statistics.totalPauseSeconds;
+    gcStatistics.mLastBytesFreed    = static_cast<uint32_t>(statistics.lastBytesFreed);
+    gcStatistics.mTotalBytesFreed   = statistics.totalBytesFreed;
+    gcStatistics.mHeapBytes         = static_cast<uint32_t>(statistics.heapBytes);
+    gcStatistics.mLiveBytes         = static_cast<uint32_t>(statistics.liveBytes);
+    gcStatistics.mHeapBudget        = static_cast<uint32_t>(statistics.memoryBudget);
+}
+
 
 
 ///////////////////////////////////////////////////////////////////////
@@ -590,7 +613,8 @@ Parameters::Parameters()
 	#endif
 	mFireTimerRate(kFireTimerRate60Hz),
     mbEnableDefaultToolTip(false),
-	mbEnableCrossDomainScripting(false)
+	mbEnableCrossDomainScripting(false),
+	mJavaScriptHeapBudget(0)
 	{
 		mColors[kColorActiveSelectionBack]         .setRGB(0xff3875d7);
 		mColors[kColorActiveSelectionFore]         .setRGB(0xffd4d4d4);
@@ -720,6 +744,7 @@ EAWEBKIT_API void SetParameters(const Parameters& parameters)
     pWebPreferences->setHistoryItemLimit(parameters.mHistoryItemLimit);
     pWebPreferences->setHistoryAgeInDaysLimit(parameters.mHistoryAgeLimit);
 	pWebPreferences->SetJavaScriptStackSize(parameters.mJavaScriptStackSize);
+	KJS::CollectorPolicy::setMemoryBudget(parameters.mJavaScriptHeapBudget);
 
     // The following items are WebPreferences, but it turns out we set these preferences by other means.
     // pWebPreferences->setCookieStorageAcceptPolicy(WebKitCookieStorageAcceptPolicy acceptPolicy);
@@ -814,6 +839,8 @@ EAWEBKIT_API void Shutdown()
     // We may want to do some kind of assertions here.
     sParametersEx().Shutdown();
 
+    ClearProcessTrace();
+
     DS_INST_DUMP_CURRENT(IOcout);
     DS_CLEAN_DEEPSEE_FRAMEWORK();
 
@@ -1481,6 +1508,40 @@ namespace EA
             return EA::WebKit::GetWebKitStatus();
         }
 
+		void EAWebkitConcrete::StartProcessTrace(uint32_t eventsPerThread)
+		{
+			EAW_ASSERT_MSG( (GetWebKitStatus() == kWebKitStatusActive), "Did you call EAWebKit::Init()?");
+
+			EA::WebKit::StartProcessTrace(eventsPerThread);
+		}
+
+		void EAWebkitConcrete::StopProcessTrace()
+		{
+			EA::WebKit::StopProcessTrace();
+		}
+
+		void EAWebkitConcrete::ClearProcessTrace()
+		{
+			EA::WebKit::ClearProcessTrace();
+		}
+
+		void EAWebkitConcrete::GetProcessTraceSummary(ProcessTraceSummary& summary)
+		{
+			EA::WebKit::GetProcessTraceSummary(summary);
+		}
+
+		bool EAWebkitConcrete::WriteProcessTrace(const char* pFilePath)
+		{
+			EAW_ASSERT_MSG( (GetWebKitStatus() == kWebKitStatusActive), "Did you call EAWebKit::Init()?");
+
+			return EA::WebKit::WriteProcessTrace(pFilePath);
+		}
+
+		void EAWebkitConcrete::GetJavaScriptGCStatistics(JavaScriptGCStatistics& gcStatistics)
+		{
+			EA::WebKit::GetJavaScriptGCStatistics(gcStatistics);
+		}
+
 		void  EAWebkitConcrete::AddTransportHandler(TransportHandler* pTH, const char16_t* pScheme)
 		{
 			EAW_ASSERT_MSG( (GetWebKitStatus() == kWebKitStatusActive), "Did you call EAWebKit::Init()?");
@@ -0,0 +1,453 @@
+/*
+Copyright (C) 2010-2011 Electronic Arts, Inc.  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1.  Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2.  Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3.  Neither the name of Electronic Arts, Inc. ("EA") nor the names of
+its contributors may be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY ELECTRONIC ARTS AND ITS CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL ELECTRONIC ARTS OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+// EAWebKitProcessTrace.cpp
+///////////////////////////////////////////////////////////////////////////////
+
+#include <EAWebKit/EAWebKitProcessTrace.h>
+#include <EAWebKit/EAWebKit.h>
+#include <EAWebKit/EAWebKitFileSystem.h>
+#include <EAWebKit/EAWebkitAllocator.h>
+#include <EAWebKit/internal/EAWebKitAssert.h>
+#include <EASTL/vector.h>
+#include <EASTL/map.h>
+#include <EASTL/sort.h>
+#include <Threading.h>
+#include <Assertions.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace EA
+{
+namespace WebKit
+{
+
+namespace
+{
+    struct TraceEvent
+    {
+        double      mTime;
+        int32_t     mJobId;
+        int32_t     mSize;
+        int16_t     mType;
+        int16_t     mStatus;
+    };
+
+    // A ring is written only by the thread that claimed it, so recording needs no lock. 
+    // mWriteCount counts every event ever written; the ring holds the last sEventsPerThread of them.
+    struct TraceThreadBuffer
+    {
+        WTF::ThreadIdentifier   mThreadId;
+        TraceEvent*             mpEvents;
+        int                     mWriteCount;
+        volatile bool           mbClaimed;
+    };
+
+    TraceThreadBuffer   sThreadBuffers[kProcessTraceMaxThreads];
+    int                 sFreeThreadBufferCount = kProcessTraceMaxThreads; // Counts down as threads claim a ring.
+    int                 sLostEventCount = 0;
+    uint32_t            sEventsPerThread = kProcessTraceDefaultEventsPerThread;
+    double              sTraceStartTime = 0.0;
+    volatile bool       sbTraceActive = false;
+
+    const char* const sProcessTypeNames[] =
+    {
+        "User1",
+        "User2",
+        "User3",
+        "ViewTick",
+        "TransportTick",
+        "KeyBoardEvent",
+        "MouseMoveEvent",
+        "MouseButtonEvent",
+        "MouseWheelEvent",
+        "ScrollEvent",
+        "Script",
+        "Draw",
+        "THJobs",
+        "TransportJob",
+        "FileCacheJob",
+        "DrawImage",
+        "DrawImagePattern",
+        "DrawGlyph",
+        "DrawRaster",
+        "ImageDecoder",
+        "ImageCompressionPack",
+        "ImageCompressionUnPack",
+        "JavaScriptParser",
+        "JavaScriptExecute",
+        "CSSParseSheet",
+        "FontLoading",
+        "HTMLParse",
+        "StyleRecalc",
+        "Layout",
+        "FillRect"
+    };
+    COMPILE_ASSERT(sizeof(sProcessTypeNames) / sizeof(sProcessTypeNames[0]) == kVProcessTypeLast, ProcessTypeNamesMatchVProcessType);
+
+    const char* const sProcessStatusNames[] =
+    {
+        "None",
+        "Started",
+        "Ended",
+        "QueuedToInit",
+        "QueuedToConnection",
+        "QueuedToTransfer",
+        "QueuedToDisconnect",
+        "QueuedToShutdown",
+        "QueuedToRemove"
+    };
+
+    // Platforms without atomics in BCThreadingEA.h don't run WebKit code on other threads.
+    inline void TraceAtomicIncrement(int* pValue)
+    {
+    #if USE(EATHREAD) || USE(LOCKFREE_THREADSAFESHARED)
+        WTF::atomicIncrement(pValue);
+    #else
+        ++*pValue;
+    #endif
+    }
+
+    inline int TraceAtomicDecrement(int* pValue)
+    {
+    #if USE(EATHREAD) || USE(LOCKFREE_THREADSAFESHARED)
+        return WTF::atomicDecrement(pValue);
+    #else
+        return --*pValue;
+    #endif
+    }
+
+    TraceThreadBuffer* GetThreadBuffer()
+    {
+        const WTF::ThreadIdentifier threadId = WTF::currentThread();
+
+        for(int i = 0; i < kProcessTraceMaxThreads; ++i)
+        {
+            TraceThreadBuffer& buffer = sThreadBuffers[i];
+            if(buffer.mbClaimed && (buffer.mThreadId == threadId))
+                return &buffer;
+        }
+
+        // First event from this thread. Claiming only needs an atomic decrement; the ring is
+        // published to readers by setting mbClaimed last.
+        const int index = TraceAtomicDecrement(&sFreeThreadBufferCount);
+        if(index < 0)
+            return NULL;
+
+        TraceThreadBuffer& buffer = sThreadBuffers[index];
+        buffer.mThreadId   = threadId;
+        buffer.mpEvents    = EAWEBKIT_NEW("ProcessTrace") TraceEvent[sEventsPerThread];
+        buffer.mWriteCount = 0;
+        buffer.mbClaimed   = true;
+        return &buffer;
+    }
+
+    // Calls f(buffer, event) for each event still held in a ring, oldest first.
+    template <typename Function>
+    void ForEachEvent(const TraceThreadBuffer& buffer, Function& f)
+    {
+        const uint32_t writeCount = (uint32_t)buffer.mWriteCount;
+        const uint32_t count      = (writeCount < sEventsPerThread) ? writeCount : sEventsPerThread;
+        const uint32_t first      = writeCount - count;
+
+        for(uint32_t i = 0; i < count; ++i)
+            f(buffer, buffer.mpEvents[(first + i) % sEventsPerThread]);
+    }
+
+    // Matches start/end pairs per thread. Jobs are matched on their id since several can be in flight at once.
+    struct DurationCollector
+    {
+        typedef eastl::map<uint64_t, eastl::vector<double> > OpenMap;
+
+        eastl::vector<double>   mDurations[kVProcessTypeLast];
+        uint64_t                mTotalSize[kVProcessTypeLast];
+        OpenMap                 mOpen;
+
+        DurationCollector() { memset(mTotalSize, 0, sizeof(mTotalSize)); }
+
+        void operator()(const TraceThreadBuffer&, const TraceEvent& event)
+        {
+            const uint64_t key = ((uint64_t)(uint16_t)event.mType << 32) | (uint32_t)event.mJobId;
+
+            if(event.mStatus == kVProcessStatusStarted)
+                mOpen[key].push_back(event.mTime);
+            else if(event.mStatus == kVProcessStatusEnded)
+            {
+                OpenMap::iterator it = mOpen.find(key);
+                if((it != mOpen.end()) && !it->second.empty())
+                {
+                    mDurations[event.mType].push_back(event.mTime - it->second.back());
+                    if(event.mSize > 0)
+                        mTotalSize[event.mType] += (uint64_t)event.mSize;
+                    it->second.pop_back();
+                }
+            }
+        }
+    };
+
+    double Percentile(const eastl::vector<double>& sorted, uint32_t percent)
+    {
+        // Nearest rank
+        uint32_t rank = (uint32_t)((sorted.size() * percent + 99) / 100);
+        if(rank)
+            --rank;
+        return sorted[rank];
+    }
+
+    class TraceFileWriter
+    {
+    public:
+        TraceFileWriter(FileSystem* pFileSystem, FileSystem::FileObject file)
+            : mpFileSystem(pFileSystem), mFile(file), mUsed(0), mbOK(true) { }
+
+        void Write(const char* pFormat, ...)
+        {
+            if((sizeof(mBuffer) - mUsed) < kMaxLine)
+                Flush();
+
+            va_list args;
+            va_start(args, pFormat);
+            const int written = vsnprintf(mBuffer + mUsed, kMaxLine, pFormat, args);
+            va_end(args);
+
+            if((written > 0) && (written < kMaxLine))
+                mUsed += (uint32_t)written;
+        }
+
+        bool Flush()
+        {
+            if(mUsed && !mpFileSystem->WriteFile(mFile, mBuffer, mUsed))
+                mbOK = false;
+            mUsed = 0;
+            return mbOK;
+        }
+
+    private:
+        enum { kMaxLine = 512 };
+
+        FileSystem*             mpFileSystem;
+        FileSystem::FileObject  mFile;
+        char                    mBuffer[8192];
+        uint32_t                mUsed;
+        bool                    mbOK;
+    };
+
+    struct TraceEventWriter
+    {
+        TraceFileWriter&    mWriter;
+        bool                mbFirst;
+
+        TraceEventWriter(TraceFileWriter& writer) : mWriter(writer), mbFirst(true) { }
+
+        void operator()(const TraceThreadBuffer& buffer, const TraceEvent& event)
+        {
+            const char* const pName   = sProcessTypeNames[event.mType];
+            const double      ts      = (event.mTime - sTraceStartTime) * 1000000.0;
+            const char* const pComma  = mbFirst ? "" : ",";
+            mbFirst = false;
+
+            if(event.mJobId)
+            {
+                // Jobs overlap on the same thread, so they are written as async events keyed on the job id.
+                const char* const pPhase = (event.mStatus == kVProcessStatusStarted) ? "b" : (event.mStatus == kVProcessStatusEnded) ? "e" : "n";
+                mWriter.Write("%s\n{\"name\":\"%s\",\"cat\":\"EAWebKit\",\"ph\":\"%s\",\"id\":%d,\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"status\":\"%s\"}}",
+                              pComma, pName, pPhase, (int)event.mJobId, ts, (unsigned)buffer.mThreadId, sProcessStatusNames[event.mStatus]);
+            }
+            else if((event.mStatus == kVProcessStatusStarted) || (event.mStatus == kVProcessStatusEnded))
+            {
+                mWriter.Write("%s\n{\"name\":\"%s\",\"cat\":\"EAWebKit\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                              pComma, pName, (event.mStatus == kVProcessStatusStarted) ? "B" : "E", ts, (unsigned)buffer.mThreadId);
+            }
+            else
+            {
+                mWriter.Write("%s\n{\"name\":\"%s:%s\",\"cat\":\"EAWebKit\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                              pComma, pName, sProcessStatusNames[event.mStatus], ts, (unsigned)buffer.mThreadId);
+            }
+        }
+    };
+}
+
+
+void RecordProcessTraceEvent(const ViewProcessInfo& process)
+{
+    if(!sbTraceActive || (process.mProcessType < 0) || (process.mProcessType >= kVProcessTypeLast))
+        return;
+
+    TraceThreadBuffer* pBuffer = GetThreadBuffer();
+    if(!pBuffer)
+    {
+        TraceAtomicIncrement(&sLostEventCount);
+        return;
+    }
+
+    TraceEvent& event = pBuffer->mpEvents[(uint32_t)pBuffer->mWriteCount % sEventsPerThread];
+    event.mTime   = EA::WebKit::GetTime();
+    event.mJobId  = process.mJobId;
+    event.mSize   = process.mSize;
+    event.mType   = (int16_t)process.mProcessType;
+    event.mStatus = (int16_t)process.mProcessStatus;
+
+    // The atomic increment also acts as the barrier that publishes the event to a reader.
+    TraceAtomicIncrement(&pBuffer->mWriteCount);
+}
+
+
+EAWEBKIT_API void StartProcessTrace(uint32_t eventsPerThread)
+{
+    ClearProcessTrace();
+
+    sEventsPerThread = eventsPerThread ? eventsPerThread : (uint32_t)kProcessTraceDefaultEventsPerThread;
+    sTraceStartTime  = EA::WebKit::GetTime();
+    sbTraceActive    = true;
+}
+
+EAWEBKIT_API void StopProcessTrace()
+{
+    sbTraceActive = false;
+}
+
+EAWEBKIT_API void ClearProcessTrace()
+{
+    sbTraceActive = false;
+
+    for(int i = 0; i < kProcessTraceMaxThreads; ++i)
+    {
+        TraceThreadBuffer& buffer = sThreadBuffers[i];
+        if(buffer.mbClaimed)
+        {
+            buffer.mbClaimed = false;
+            EAWEBKIT_DELETE[] buffer.mpEvents;
+            buffer.mpEvents   = NULL;
+            buffer.mWriteCount = 0;
+        }
+    }
+
+    sFreeThreadBufferCount = kProcessTraceMaxThreads;
+    sLostEventCount        = 0;
+}
+
+EAWEBKIT_API void GetProcessTraceSummary(ProcessTraceSummary& summary)
+{
+    memset(&summary, 0, sizeof(summary));
+    summary.mDroppedEventCount = (uint32_t)sLostEventCount;
+
+    DurationCollector collector;
+
+    for(int i = 0; i < kProcessTraceMaxThreads; ++i)
+    {
+        const TraceThreadBuffer& buffer = sThreadBuffers[i];
+        if(!buffer.mbClaimed)
+            continue;
+
+        const uint32_t writeCount = (uint32_t)buffer.mWriteCount;
+        const uint32_t count      = (writeCount < sEventsPerThread) ? writeCount : sEventsPerThread;
+
+        summary.mThreadCount++;
+        summary.mEventCount        += count;
+        summary.mDroppedEventCount += writeCount - count;
+
+        ForEachEvent(buffer, collector);
+        collector.mOpen.clear(); // Pairs never span threads.
+    }
+
+    for(int type = 0; type < kVProcessTypeLast; ++type)
+    {
+        eastl::vector<double>& durations = collector.mDurations[type];
+        if(durations.empty())
+            continue;
+
+        eastl::sort(durations.begin(), durations.end());
+
+        ProcessTraceTypeStats& stats = summary.mTypeStats[type];
+        stats.mCount     = (uint32_t)durations.size();
+        stats.mTotalSize = collector.mTotalSize[type];
+        stats.mMinTime = durations.front();
+        stats.mMaxTime = durations.back();
+        for(eastl_size_t i = 0; i < durations.size(); ++i)
+            stats.mTotalTime += durations[i];
+        stats.mP50Time = Percentile(durations, 50);
+        stats.mP90Time = Percentile(durations, 90);
+        stats.mP99Time = Percentile(durations, 99);
+    }
+}
+
+EAWEBKIT_API bool WriteProcessTrace(const char* pFilePath)
+{
+    FileSystem* pFileSystem = GetFileSystem();
+    EAW_ASSERT_MSG(pFileSystem, "No FileSystem has been set");
+    if(!pFileSystem)
+        return false;
+
+    FileSystem::FileObject file = pFileSystem->CreateFileObject();
+    if(file == FileSystem::kFileObjectInvalid)
+        return false;
+
+    bool bResult = false;
+
+    if(pFileSystem->OpenFile(file, pFilePath, FileSystem::kWrite))
+    {
+        TraceFileWriter writer(pFileSystem, file);
+        
+        writer.Write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        TraceEventWriter eventWriter(writer);
+        for(int i = 0; i < kProcessTraceMaxThreads; ++i)
+        {
+            if(sThreadBuffers[i].mbClaimed)
+                ForEachEvent(sThreadBuffers[i], eventWriter);
+        }
+        writer.Write("\n],\n\"eawebkitSummary\":{");
+
+        ProcessTraceSummary summary;
+        GetProcessTraceSummary(summary);
+        writer.Write("\n\"threads\":%u,\"events\":%u,\"droppedEvents\":%u", summary.mThreadCount, summary.mEventCount, summary.mDroppedEventCount);
+        for(int type = 0; type < kVProcessTypeLast; ++type)
+        {
+            const ProcessTraceTypeStats& stats = summary.mTypeStats[type];
+            if(stats.mCount)
+            {
+                const double sizePerSecond = (stats.mTotalTime > 0.0) ? ((double)stats.mTotalSize / stats.mTotalTime) : 0.0;
+
+                writer.Write(",\n\"%s\":{\"count\":%u,\"total\":%.3f,\"min\":%.3f,\"max\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"size\":%.0f,\"sizePerSecond\":%.0f}",
+                             sProcessTypeNames[type], stats.mCount, stats.mTotalTime * 1000.0, stats.mMinTime * 1000.0, stats.mMaxTime * 1000.0,
+                             stats.mP50Time * 1000.0, stats.mP90Time * 1000.0, stats.mP99Time * 1000.0, (double)stats.mTotalSize, sizePerSecond);
+            }
+        }
+        writer.Write("\n}}\n");
+
+        bResult = writer.Flush();
+        pFileSystem->CloseFile(file);
+    }
+
+    pFileSystem->DestroyFileObject(file);
+    return bResult;
+}
+
+} // namespace WebKit
+} // namespace EA
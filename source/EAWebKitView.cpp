@@ -39,6 +39,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <EAWebKit/internal/EAWebkitNodeListContainer.h>
 #include <EAWebKit/internal/EAWebkitOverlaySurfaceArrayContainer.h>
 #include <EAWebKit/EAWebKitFPUPrecision.h>
+#include <EAWebKit/EAWebKitProcessTrace.h>
 #include <EARaster/EARaster.h>
 #ifdef  USE_EATHREAD_LIBRARY
     #include <EAThread/eathread_sync.h>
@@ -198,6 +199,8 @@ void NOTIFY_PROCESS_STATUS(VProcessType processType, VProcessStatus processStatu
 		if(processStatus == kVProcessStatusStarted)
 			gProcessInfoArray[processType].ResetTime();
 		
+		RecordProcessTraceEvent(gProcessInfoArray[processType]);
+
 		EA::WebKit::ViewNotification* const pViewNotification = EA::WebKit::GetViewNotification();
 		if(pViewNotification)
 			pViewNotification->ViewProcessStatus(gProcessInfoArray[processType]);
@@ -211,10 +214,15 @@ void NOTIFY_PROCESS_STATUS(ViewProcessInfo& process, VProcessStatus processStatu
 	if(!parameters.mbEnableProfiling)
 		return;
 
+    // Same default as the process type version above, so handlers always get a view.
+    if(!process.mpView)
+        process.mpView = AutoSetActiveView::GetActiveView();
+
 	if(processStatus == kVProcessStatusStarted)
 		process.ResetTime();
 
 	process.mProcessStatus = processStatus;
+	RecordProcessTraceEvent(process);
 	
 	EA::WebKit::ViewNotification* const pViewNotification = EA::WebKit::GetViewNotification();
 	if(pViewNotification)
@@ -922,7 +922,7 @@ uint32_t FontProxy::GetGlyphIds(const EA::WebKit::Char* pCharArray, uint32_t nCh
     int returnValue = 0;
     if(mpFont)
     {
-        // Seems that in all EAWebKit use cases, only 1 count is used so casting the typdef is probably less dangerous here than it appears.
+        // GlyphPage::fill passes a whole page of chars here, so the arrays are cast directly rather than converted per element.
         // We also runtime compile check to make sure the sizes match
         returnValue = mpFont->GetGlyphIds( static_cast<const EA::Text::Char*> (pCharArray), nCharArrayCount, static_cast<EA::Text::GlyphId*> (pGlyphIdArray),
                                            bUseReplacementGlyph, nGlyphIdStride, bWriteInvalidGlyphs);
@@ -970,6 +970,19 @@ bool FontProxy::GetKerning(EA::WebKit::GlyphId g1, EA::WebKit::GlyphId g2, EA::W
     return returnFlag;
 }
 
+bool FontProxy::HasKerning()
+{
+    EAW_ASSERT(mpFont);
+    bool returnFlag = true;  // Other font types have their own kerning schemes, so we assume they may kern.
+
+    if(mpFont && (mpFont->GetFontType() == EA::Text::kFontTypeOutline))
+    {
+        EA::Text::OutlineFont* pOutlineFont = static_cast<EA::Text::OutlineFont*> (mpFont);         
+        returnFlag = pOutlineFont->HasKerning();
+    }
+    return returnFlag;
+}
+
 // This is special for the down casted outline font class
 bool FontProxy::OpenOutline(const void* pSourceData, uint32_t nSourceSize, int nFaceIndex)
 {
@@ -1026,6 +1039,52 @@ bool FontProxy::DrawGlyphBitmap(EA::WebKit::IGlyphCache* pGlyphCache, EA::WebKit
     return returnFlag;
 }
 
+uint32_t FontProxy::DrawGlyphBitmaps(EA::WebKit::IGlyphCache* pGlyphCache, const EA::WebKit::GlyphId* pGlyphArray, uint32_t glyphCount, const uint8_t* pSubpixelPhaseArray)
+{
+    EAW_ASSERT(mpFont);
+
+    EA::Text::GlyphCache* pGlyphCacheExternal = static_cast<EA::Text::GlyphCache*> (pGlyphCache->GetGlyphCachePointer());
+    EAW_ASSERT(pGlyphCacheExternal);
+
+    // AddGlyphTexture leaves the textures it writes to locked. We unlock each of them once at the end
+    // instead of after every glyph, as an unlock can mean uploading the texture.
+    eastl::fixed_vector<EA::Text::TextureInfo*, EA::Text::kTextureSlotCount, false> textureArray;
+    uint32_t count = 0;
+
+    for(uint32_t i = 0; i < glyphCount; ++i)
+    {
+        const EA::Text::GlyphId gIdExternal = (EA::Text::GlyphId) pGlyphArray[i];
+        const uint32_t phase = pSubpixelPhaseArray ? pSubpixelPhaseArray[i] : 0;
+        const float fXFraction = (float)phase / (float)EA::Text::kSubpixelPhaseCount;
+        const EA::Text::Font::GlyphBitmap* pGlyphBitmap;
+        EA::Text::GlyphTextureInfo glyphTextureInfoExternal;
+
+        EAW_ASSERT(phase < (uint32_t)EA::Text::kSubpixelPhaseCount);
+
+        if(mpFont->RenderGlyphBitmap(&pGlyphBitmap, gIdExternal, EA::Text::Font::kRFDefault, fXFraction))
+        {
+            if(pGlyphCacheExternal->AddGlyphTexture(mpFont, gIdExternal, pGlyphBitmap->mpData, pGlyphBitmap->mnWidth, pGlyphBitmap->mnHeight, 
+                                                   pGlyphBitmap->mnStride, (uint32_t)pGlyphBitmap->mBitmapFormat, glyphTextureInfoExternal, phase))
+            {
+                if(eastl::find(textureArray.begin(), textureArray.end(), glyphTextureInfoExternal.mpTextureInfo) == textureArray.end())
+                    textureArray.push_back(glyphTextureInfoExternal.mpTextureInfo);
+                ++count;
+            }
+            else
+                EAW_ASSERT_MSG(false, "TextWrapper: DrawGlyphBitmaps: AddGlyphTexture failed.");
+
+            mpFont->DoneGlyphBitmap(pGlyphBitmap);
+        }
+        else
+            EAW_ASSERT_MSG(false, "TextWrapper: DrawGlyphBitmaps: invalid glyph/Font combo.");
+    }
+
+    for(eastl_size_t i = 0; i < textureArray.size(); ++i)
+        pGlyphCacheExternal->EndUpdate(textureArray[i]);
+
+    return count;
+}
+
 bool FontProxy::SetTransform(float fSize)
 {
     EAW_ASSERT(mpFont);
@@ -1426,99 +1485,134 @@ bool FontServerProxy::AddSubstitution(const char16_t* pFamily, const char16_t* p
 	return returnFlag;
 }
 
-// Text break iterator statics 
-static EA::Text::CharacterBreakIterator sCharacterBreakIterator;
-static EA::Text::WordBreakIterator      sWordBreakIterator;
-static EA::Text::LineBreakIterator      sLineBreakIterator;
-static EA::Text::SentenceBreakIterator  sSentenceBreakIterator;
-static EA::Text::TextRun                sTextRun;
-static EA::Text::BreakIteratorBase*     sTextBreakIterator;
+// Text break iterators
+// Each iterator keeps its own TextRun and remembers its type, so iterators of different types or
+// owners don't share state and we don't need to compare against the statics to know what to call.
+struct TextBreakIteratorProxy
+{
+    EA::WebKit::TextBreakIteratorType mType;
+    EA::Text::TextRun                 mTextRun;
+    EA::Text::CharacterBreakIterator* mpIterator;   // Points to the iterator in TextBreakIteratorProxyT.
+
+    TextBreakIteratorProxy(EA::WebKit::TextBreakIteratorType type) : mType(type), mTextRun(), mpIterator(NULL) { }
+    virtual ~TextBreakIteratorProxy() { }
+};
+
+template <typename Iterator>
+struct TextBreakIteratorProxyT : public TextBreakIteratorProxy
+{
+    Iterator mIterator;
+
+    TextBreakIteratorProxyT(EA::WebKit::TextBreakIteratorType type) : TextBreakIteratorProxy(type) { mpIterator = &mIterator; }
+};
+
+static TextBreakIteratorProxyT<EA::Text::CharacterBreakIterator> sCharacterBreakIterator(EA::WebKit::kTextBreakIteratorCharacter);
+static TextBreakIteratorProxyT<EA::Text::WordBreakIterator>      sWordBreakIterator(EA::WebKit::kTextBreakIteratorWord);
+static TextBreakIteratorProxyT<EA::Text::LineBreakIterator>      sLineBreakIterator(EA::WebKit::kTextBreakIteratorLine);
+static TextBreakIteratorProxyT<EA::Text::SentenceBreakIterator>  sSentenceBreakIterator(EA::WebKit::kTextBreakIteratorSentence);
 const int TextBreakDone = -1;
 
 void* FontServerProxy::CharacterBreakIterator(EA::WebKit::Char* pText, int length)
 {
-   
-    // To do: Have EAText iterators keep a member TextRun so you don't need to maintain one externally.
-    sTextRun.mpText     = (EA::Text::Char*) pText;
-    sTextRun.mnTextSize = (uint32_t)length;
-    sCharacterBreakIterator.GetIterator().SetTextRunArray(&sTextRun, 1);
-    sTextBreakIterator = &sCharacterBreakIterator;
-
-    return sTextBreakIterator;
+    ResetTextBreakIterator(&sCharacterBreakIterator, pText, length);
+    return &sCharacterBreakIterator;
 }
 
 void* FontServerProxy::WordBreakIterator(EA::WebKit::Char* pText, int length)
 {
-    // To do: Have EAText iterators keep a member TextRun so you don't need to maintain one externally.
-    sTextRun.mpText     = (EA::Text::Char*) pText;
-    sTextRun.mnTextSize = (uint32_t)length;
-    sWordBreakIterator.GetIterator().SetTextRunArray(&sTextRun, 1);
-    sTextBreakIterator = &sWordBreakIterator;
-
-    return sTextBreakIterator;
+    ResetTextBreakIterator(&sWordBreakIterator, pText, length);
+    return &sWordBreakIterator;
 }
 
 void* FontServerProxy::LineBreakIterator(EA::WebKit::Char* pText, int length)
 {
-    // To do: Have EAText iterators keep a member TextRun so you don't need to maintain one externally.
-    sTextRun.mpText     = (EA::Text::Char*) pText;
-    sTextRun.mnTextSize = (uint32_t)length;
-    sLineBreakIterator.GetIterator().SetTextRunArray(&sTextRun, 1);
-    sTextBreakIterator = &sLineBreakIterator;
-
-    return sTextBreakIterator;
+    ResetTextBreakIterator(&sLineBreakIterator, pText, length);
+    return &sLineBreakIterator;
 }
 
 void* FontServerProxy::SentenceBreakIterator(EA::WebKit::Char* pText, int length)
 {
-    // To do: Have EAText iterators keep a member TextRun so you don't need to maintain one externally.
-    sTextRun.mpText     = (EA::Text::Char*) pText;
-    sTextRun.mnTextSize = (uint32_t)length;
-    sSentenceBreakIterator.GetIterator().SetTextRunArray(&sTextRun, 1);
-    sTextBreakIterator = &sSentenceBreakIterator;
+    ResetTextBreakIterator(&sSentenceBreakIterator, pText, length);
+    return &sSentenceBreakIterator;
+}
+
+void* FontServerProxy::CreateTextBreakIterator(EA::WebKit::TextBreakIteratorType type)
+{
+    Allocator::ICoreAllocator* pAllocator = GetAllocator_Helper();
+
+    switch(type)
+    {
+        case EA::WebKit::kTextBreakIteratorCharacter:
+            return EATEXT_WRAPPER_NEW(TextBreakIteratorProxyT<EA::Text::CharacterBreakIterator>, pAllocator, "TextWrapper: CharacterBreakIterator")(type);
+
+        case EA::WebKit::kTextBreakIteratorWord:
+            return EATEXT_WRAPPER_NEW(TextBreakIteratorProxyT<EA::Text::WordBreakIterator>, pAllocator, "TextWrapper: WordBreakIterator")(type);
+
+        case EA::WebKit::kTextBreakIteratorLine:
+            return EATEXT_WRAPPER_NEW(TextBreakIteratorProxyT<EA::Text::LineBreakIterator>, pAllocator, "TextWrapper: LineBreakIterator")(type);
+
+        case EA::WebKit::kTextBreakIteratorSentence:
+            return EATEXT_WRAPPER_NEW(TextBreakIteratorProxyT<EA::Text::SentenceBreakIterator>, pAllocator, "TextWrapper: SentenceBreakIterator")(type);
+    }
+
+    return NULL;
+}
+
+void FontServerProxy::ResetTextBreakIterator(void* pIter, EA::WebKit::Char* pText, int length)
+{
+    TextBreakIteratorProxy* pIterator = static_cast<TextBreakIteratorProxy*> (pIter);
 
-    return sTextBreakIterator;
+    pIterator->mTextRun.mpText     = (EA::Text::Char*) pText;
+    pIterator->mTextRun.mnTextSize = (uint32_t)length;
+    pIterator->mpIterator->GetIterator().SetTextRunArray(&pIterator->mTextRun, 1);
+}
+
+void FontServerProxy::DestroyTextBreakIterator(void* pIter)
+{
+    TextBreakIteratorProxy* pIterator = static_cast<TextBreakIteratorProxy*> (pIter);
+
+    EAW_ASSERT((pIterator != &sCharacterBreakIterator) && (pIterator != &sWordBreakIterator) && 
+               (pIterator != &sLineBreakIterator) && (pIterator != &sSentenceBreakIterator));
+
+    Allocator::ICoreAllocator* pAllocator = GetAllocator_Helper();
+    EATEXT_WRAPPER_DELETE(pIterator, pAllocator);
 }
 
 int FontServerProxy::TextBreakFirst(void* pIter)
 {
-        EA::Text::BreakIteratorBase* pIterator = static_cast<EA::Text::BreakIteratorBase*> (pIter);
-    
-    // We have a problem: EATextBreak doesn't implement a pure-virtual NextBreak/PrevBreak function.
-    // It's easy to do this but it requires us to update EAText. We do something of a hack in the 
-    // short run to allow this to work now by checking each of the global variables manually.
-    pIterator->SetPosition(0);
+    TextBreakIteratorProxy* pIterator = static_cast<TextBreakIteratorProxy*> (pIter);
+
+    pIterator->mpIterator->SetPosition(0);
     return TextBreakNext(pIterator);
 }
 
 int FontServerProxy::TextBreakNext(void* pIter)
 {
-    uint32_t originalPosition;
+    TextBreakIteratorProxy* pIterator = static_cast<TextBreakIteratorProxy*> (pIter);
+    const uint32_t originalPosition = pIterator->mpIterator->GetPosition();
     uint32_t newPosition;
-    EA::Text::BreakIteratorBase* pIterator = static_cast<EA::Text::BreakIteratorBase*> (pIter);
 
-    if(pIterator == &sCharacterBreakIterator)
-    {
-        originalPosition = sCharacterBreakIterator.GetPosition();
-        newPosition      = sCharacterBreakIterator.GetNextCharBreak();
-    }
-    else if(pIterator == &sWordBreakIterator)
-    {
-        originalPosition = sWordBreakIterator.GetPosition();
-        newPosition      = sWordBreakIterator.GetNextWordBreak();
-    }
-    else if(pIterator == &sSentenceBreakIterator)
-    {
-        originalPosition = sLineBreakIterator.GetPosition();
-        newPosition      = sLineBreakIterator.GetNextLineBreak();
-    }
-    else // if(pIterator == &sSentenceBreakIterator)
+    switch(pIterator->mType)
     {
-        originalPosition = sSentenceBreakIterator.GetPosition();
-        newPosition      = sSentenceBreakIterator.GetNextSentenceBreak();
+        case EA::WebKit::kTextBreakIteratorCharacter:
+        default:
+            newPosition = pIterator->mpIterator->GetNextCharBreak();
+            break;
+
+        case EA::WebKit::kTextBreakIteratorWord:
+            newPosition = static_cast<EA::Text::WordBreakIterator*> (pIterator->mpIterator)->GetNextWordBreak();
+            break;
+
+        case EA::WebKit::kTextBreakIteratorLine:
+            newPosition = static_cast<EA::Text::LineBreakIterator*> (pIterator->mpIterator)->GetNextLineBreak();
+            break;
+
+        case EA::WebKit::kTextBreakIteratorSentence:
+            newPosition = static_cast<EA::Text::SentenceBreakIterator*> (pIterator->mpIterator)->GetNextSentenceBreak();
+            break;
     }
 
-    if(pIterator->AtEnd() && (newPosition == originalPosition))
+    if(pIterator->mpIterator->AtEnd() && (newPosition == originalPosition))
         return TextBreakDone;
 
     return static_cast<int> (newPosition);
@@ -1526,41 +1620,41 @@ int FontServerProxy::TextBreakNext(void* pIter)
 
 int FontServerProxy::TextBreakCurrent(void* pIter)
 {
-    EA::Text::BreakIteratorBase* pIterator = static_cast<EA::Text::BreakIteratorBase*> (pIter);
+    TextBreakIteratorProxy* pIterator = static_cast<TextBreakIteratorProxy*> (pIter);
 
-    return static_cast<int> (pIterator->GetPosition());
+    return static_cast<int> (pIterator->mpIterator->GetPosition());
 }
 
 int FontServerProxy::TextBreakPreceding(void* pIter, int position)
 {
-    uint32_t originalPosition;
-    uint32_t newPosition;
-    EA::Text::BreakIteratorBase* pIterator = static_cast<EA::Text::BreakIteratorBase*> (pIter);
+    TextBreakIteratorProxy* pIterator = static_cast<TextBreakIteratorProxy*> (pIter);
 
-    pIterator->SetPosition((uint32_t)position);
+    pIterator->mpIterator->SetPosition((uint32_t)position);
 
-    if(pIterator == &sCharacterBreakIterator)
-    {
-        originalPosition = sCharacterBreakIterator.GetPosition();
-        newPosition      = sCharacterBreakIterator.GetPrevCharBreak();
-    }
-    else if(pIterator == &sWordBreakIterator)
-    {
-        originalPosition = sWordBreakIterator.GetPosition();
-        newPosition      = sWordBreakIterator.GetPrevWordBreak();
-    }
-    else if(pIterator == &sSentenceBreakIterator)
-    {
-        originalPosition = sLineBreakIterator.GetPosition();
-        newPosition      = sLineBreakIterator.GetPrevLineBreak();
-    }
-    else // if(pIterator == &sSentenceBreakIterator)
+    const uint32_t originalPosition = pIterator->mpIterator->GetPosition();
+    uint32_t newPosition;
+
+    switch(pIterator->mType)
     {
-        originalPosition = sSentenceBreakIterator.GetPosition();
-        newPosition      = sSentenceBreakIterator.GetPrevSentenceBreak();
+        case EA::WebKit::kTextBreakIteratorCharacter:
+        default:
+            newPosition = pIterator->mpIterator->GetPrevCharBreak();
+            break;
+
+        case EA::WebKit::kTextBreakIteratorWord:
+            newPosition = static_cast<EA::Text::WordBreakIterator*> (pIterator->mpIterator)->GetPrevWordBreak();
+            break;
+
+        case EA::WebKit::kTextBreakIteratorLine:
+            newPosition = static_cast<EA::Text::LineBreakIterator*> (pIterator->mpIterator)->GetPrevLineBreak();
+            break;
+
+        case EA::WebKit::kTextBreakIteratorSentence:
+            newPosition = static_cast<EA::Text::SentenceBreakIterator*> (pIterator->mpIterator)->GetPrevSentenceBreak();
+            break;
     }
 
-    if(pIterator->AtBegin() && (newPosition == originalPosition))
+    if(pIterator->mpIterator->AtBegin() && (newPosition == originalPosition))
         return TextBreakDone;
 
     return static_cast<int> (newPosition);
@@ -1568,28 +1662,28 @@ int FontServerProxy::TextBreakPreceding(void* pIter, int position)
 
 int FontServerProxy::TextBreakFollowing(void* pIter, int position)
 {
-    EA::Text::BreakIteratorBase* pIterator = static_cast<EA::Text::BreakIteratorBase*> (pIter);
+    TextBreakIteratorProxy* pIterator = static_cast<TextBreakIteratorProxy*> (pIter);
 
-    pIterator->SetPosition((uint32_t)position);
+    pIterator->mpIterator->SetPosition((uint32_t)position);
     return TextBreakNext(pIterator);
 }
 
 bool FontServerProxy::IsTextBreak(void* pIter, int position)
 {
-    EA::Text::BreakIteratorBase* pIterator = static_cast<EA::Text::BreakIteratorBase*> (pIter);
+    TextBreakIteratorProxy* pIterator = static_cast<TextBreakIteratorProxy*> (pIter);
 
     // If we are being asked about the most recent break position, then we know it is a break position.
     // Otherwise the only means we have to implementing this is to walk through the entire string
     // and check each break against position.
-    if(position == static_cast<int> (pIterator->GetPosition()))
+    if(position == static_cast<int> (pIterator->mpIterator->GetPosition()))
         return true;
 
-    pIterator->SetPosition(0);
+    pIterator->mpIterator->SetPosition(0);
 
-    while((static_cast<int> (pIterator->GetPosition()) < position) && !pIterator->AtEnd())
+    while((static_cast<int> (pIterator->mpIterator->GetPosition()) < position) && !pIterator->mpIterator->AtEnd())
         TextBreakNext(pIterator);
 
-    return (position == static_cast<int> (pIterator->GetPosition()));
+    return (position == static_cast<int> (pIterator->mpIterator->GetPosition()));
 }
 
 int FontServerProxy::FindNextWordFromIndex(EA::WebKit::Char* chars, int len, int position, bool forward)
@@ -1725,6 +1819,23 @@ bool GlyphCacheProxy::GetGlyphTextureInfo(EA::WebKit::IFont* pFont, EA::WebKit::
     return returnFlag;
 }
 
+bool GlyphCacheProxy::GetSubpixelGlyphTextureInfo(EA::WebKit::IFont* pFont, EA::WebKit::GlyphId glyphId, uint32_t nSubpixelPhase, EA::WebKit::IGlyphTextureInfo& glyphTextureInfo) 
+{
+    EA::Text::Font* pFontEA =  static_cast<EA::Text::Font*> (pFont->GetFontPointer());
+    EA::Text::GlyphTextureInfo  glyphTextureInfoEA;
+
+    bool returnFlag = false;
+    EAW_ASSERT(mpGlyphCache);        
+
+    if(mpGlyphCache && (nSubpixelPhase < (uint32_t)EA::Text::kSubpixelPhaseCount))
+        returnFlag = mpGlyphCache->GetGlyphTextureInfo(pFontEA, GetExternal_GlyphId(glyphId), glyphTextureInfoEA, nSubpixelPhase);
+
+    if(returnFlag)
+        ConvertToInternal_GlyphTextureInfo(glyphTextureInfoEA, glyphTextureInfo);
+    
+    return returnFlag;
+}
+
 bool GlyphCacheProxy::AddGlyphTexture(EA::WebKit::IFont* pFont, EA::WebKit::GlyphId glyphId, const void* pSourceData, uint32_t nSourceSizeX, 
                              uint32_t nSourceSizeY, uint32_t nSourceStride, uint32_t nSourceFormat,
                              EA::WebKit::IGlyphTextureInfo& glyphTextureInfo)
@@ -1783,7 +1894,8 @@ GlyphCacheProxy::GlyphCacheProxy(EA::Text::GlyphCache* pGlypheCache)
 		mpGlyphCache->SetAllocator(EA::Text::GetAllocator());
 		mpGlyphCache->SetOption(EA::Text::GlyphCache::kOptionDefaultSize, 1024);
 		mpGlyphCache->SetOption(EA::Text::GlyphCache::kOptionDefaultFormat, EA::Text::kTextureFormat8Bpp);
-		const int result = mpGlyphCache->Init(2, 1); // (nMaxTextureCount = 1, nInitialTextureCount = 1)
+		mpGlyphCache->SetOption(EA::Text::GlyphCache::kOptionAutoTextureCreate, 1); // Add the second page once the first is full, before evicting glyphs.
+		const int result = mpGlyphCache->Init(2, 1); // (nMaxTextureCount = 2, nInitialTextureCount = 1)
 		EAW_ASSERT(result == 1); 
 		(void)result;
 